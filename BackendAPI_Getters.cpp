@@ -28,6 +28,7 @@
 #include "CatRoundStatus.h"
 #include "CatMngr.h"
 #include "MatchMngr.h"
+#include "BracketStateCache.h"
 
 using namespace SqliteOverlay;
 
@@ -110,8 +111,10 @@ namespace QTournament::API::Qry
     Round actualLastRound{ (lastRound >= firstRound) ? lastRound : firstRound };
     if (actualLastRound > lastFinishedRound) actualLastRound = lastFinishedRound;
 
-    // initialize the tree
-    auto allMatches = getSeededBracketMatches(cat);
+    // the seeded bracket and the ranks of each finished round are
+    // memoized per category; only rounds that have been finished
+    // since the last call are applied to the bracket
+    BracketStateCache& cache = cat.getDatabaseHandle().getBracketStateCache();
 
     std::vector<SimplifiedRanking> result;
     SimplifiedRanking curRoundRanking{Round{-1}};  // dummy initial round number
@@ -121,41 +124,26 @@ namespace QTournament::API::Qry
     if (firstRound == (firstBracketRound.get() - 1))
     {
       curRoundRanking.round = Round{firstRound.get() - 1};
-      curRoundRanking.ranks = extractSortedRanksFromBracket(allMatches);
+      curRoundRanking.ranks = cache.getRanksAfterSeeding(cat);
       result.push_back(curRoundRanking);
     }
 
-    // apply the existing matches round by round
+    // collect the ranks round by round
     // in ascending round order
-    MatchMngr mm{cat.getDatabaseHandle()};
-    for (Round curRound{firstBracketRound}; curRound <= actualLastRound; curRound = Round{curRound.get() + 1})
+    for (const auto& rs : cache.getRoundStates(cat, firstBracketRound, actualLastRound))
     {
+      if (rs.round > actualLastRound) break;
+
       // update the row number in the ever-growing ranks list
+      const Round curRound = rs.round;
       curRoundRanking.round = curRound;
 
-      // apply the matches of this round to the bracket
-      // and already store winner / loser information that
-      // is contained in the match
-      const auto mgl = mm.getMatchGroupsForCat(cat, curRound.get());
-      if (!mgl.empty())
-      {
-        std::vector<Match> maList;
-        for (const auto& ma : mgl[0].getMatches())
-        {
-          maList.push_back(ma);
-        }
+      // append the winner / loser information that
+      // is contained in the round's matches
+      std::copy(begin(rs.matchRanks), end(rs.matchRanks), back_inserter(curRoundRanking.ranks));
 
-        // append the ranks from the match list
-        const auto thisRoundsRanks = extractSortedRanksFromMatchList(maList);
-        std::copy(begin(thisRoundsRanks), end(thisRoundsRanks), back_inserter(curRoundRanking.ranks));
-
-        // apply the matches to the bracket
-        allMatches.applyMatches(maList);
-      }
-
-      // find ranks resulting from assigned / dead branch combinations
-      const auto thisRoundsRanks = extractSortedRanksFromBracket(allMatches);
-      std::copy(begin(thisRoundsRanks), end(thisRoundsRanks), back_inserter(curRoundRanking.ranks));
+      // append ranks resulting from assigned / dead branch combinations
+      std::copy(begin(rs.bracketRanks), end(rs.bracketRanks), back_inserter(curRoundRanking.ranks));
 
       // are we supposed to store the ranking for
       // this round?
@@ -252,24 +240,8 @@ namespace QTournament::API::Qry
 
   SvgBracket::BracketMatchDataList getSeededBracketMatches(const Category& cat)
   {
-    CatMngr cm{cat.getDatabaseHandle()};
-    SvgBracketMatchSys brSys = static_cast<SvgBracketMatchSys>(cat.getParameter_int(CatParameter::BracketMatchSystem));
-    const auto seeding = cm.getSeeding(cat);
-    if (seeding.empty())
-    {
-      throw std::runtime_error("getSeededBracketMatches(): no suitable seeding"); // this should never happen if the caller met the preconditions
-    }
-    auto brDef = SvgBracket::findSvgBracket(brSys, seeding.size());
-    if (!brDef)
-    {
-      throw std::runtime_error("getSeededBracketMatches(): no suitable bracket"); // this should never happen if the caller met the preconditions
-    }
-
-    auto allMatches = SvgBracket::convertToBracketMatches(*brDef);
-
-    allMatches.applySeeding(seeding);
-
-    return allMatches;
+    // a copy of the memoized bracket
+    return cat.getDatabaseHandle().getBracketStateCache().getSeededBracket(cat);
   }
 
 //----------------------------------------------------------------------------
@@ -62,24 +62,17 @@ namespace QTournament::API::Internal
     // one player) or "empty" (no players at all)
     allMatches.applySeeding(seeding);
 
-    // create match groups and matches "from left to right"
-    auto trans = db.startTransaction();
-
-    MatchMngr mm{db};
+    // plan match groups and matches "from left to right"
+    MatchPlan plan;
     Round tnmtRound{firstRoundNum - 1};  // counter for the "real", "external" tournament round number; start with "-1" to compensate for the first increment in the loop
     Round bracketRound{1};   // counter for the bracket-internal rounds
-    std::optional<MatchGroup> curGroup{};
-    std::unordered_map<int, int> bracket2regularMatchNum;
+    bool hasOpenGroup{false};
     for (const auto& bmd : allMatches)
     {
       // do we need to close the current match group?
       if (bmd.round() > bracketRound)
       {
-        if (curGroup)
-        {
-          mm.closeMatchGroup(*curGroup);
-          curGroup.reset();
-        }
+        hasOpenGroup = false;
         bracketRound = bmd.round();
       }
 
@@ -87,33 +80,38 @@ namespace QTournament::API::Internal
       if (bmd.canSkip()) continue;
 
       // do we need to create a new match group?
-      if (!bmd.canSkip() && !curGroup)
+      if (!hasOpenGroup)
       {
         tnmtRound = Round{tnmtRound.get() + 1};
 
         int grpType = brDef->roundTypes.at(bracketRound.get() - 1);
-        auto newGroup = mm.createMatchGroup(cat, tnmtRound.get(), grpType);
-        if (!newGroup)
-        {
-          return newGroup.err();
-        }
-        curGroup = newGroup;
+        plan.push_back(PlannedMatchGroup{tnmtRound.get(), grpType, {}});
+        hasOpenGroup = true;
       }
 
-      // create a new, empty match in this group and map it to the bracket match id
-      auto ma = mm.createMatch(*curGroup);
-      if (!ma)
+      // a new, empty match in this group that is linked to the bracket match
+      PlannedMatch pm;
+      pm.bracketMatchNum = bmd.matchNum().get();
+      plan.back().matches.push_back(pm);
+    }
+
+    // create all groups and matches in one go
+    auto trans = db.startTransaction();
+
+    MatchMngr mm{db};
+    Error planErr = mm.createMatchesFromPlan(cat, plan);
+    if (planErr != Error::OK) return planErr;
+
+    // map the bracket match numbers to the IDs of the new matches
+    std::unordered_map<int, int> bracket2regularMatchNum;
+    for (const PlannedMatchGroup& pmg : plan)
+    {
+      for (const PlannedMatch& pm : pmg.matches)
       {
-        return ma.err();
+        bracket2regularMatchNum[pm.bracketMatchNum] = pm.matchId;
       }
-      mm.setBrackMatchLink(*ma, bmd.matchNum());
-      bracket2regularMatchNum[bmd.matchNum().get()] = ma->getId();
-      //std::cout << "M " << bmd.matchNum().get() << ": created as real match (" << ma->getId() << ")" << std::endl;
     }
 
-    // close the last group
-    if (curGroup) mm.closeMatchGroup(*curGroup);
-
     // copy the data from the BracketMatchDataList to the "real" matches
     for (const auto& bmd : allMatches)
     {
@@ -0,0 +1,89 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2019  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <thread>
+#include <atomic>
+
+#include <QEventLoop>
+#include <QTimer>
+#include <QCoreApplication>
+#include <QMetaObject>
+
+#include "BackgroundBackup.h"
+
+using namespace std;
+
+namespace QTournament
+{
+  namespace
+  {
+    // the interval for forwarding the worker's progress to the calling thread
+    constexpr int ProgressPollInterval_ms = 100;
+  }
+
+  //----------------------------------------------------------------------------
+
+  int backupInBackground(const TournamentDB& db, const string& dstFileName, const function<void (int, int)>& onProgress, int* changeCountAtCompletion)
+  {
+    if (!db.canBackupFromOtherThread())
+    {
+      return db.backupToFileIncremental(dstFileName, [&](int done, int total)
+      {
+        if (onProgress) onProgress(done, total);
+        QCoreApplication::processEvents();
+      }, TournamentDB::DefaultBackupPagesPerStep, changeCountAtCompletion);
+    }
+
+    // the worker only updates the counters and the
+    // calling thread picks them up in regular intervals
+    atomic<int> pagesDone{0};
+    atomic<int> pagesTotal{0};
+    int result{0};
+    QEventLoop loop;
+    QTimer progressTimer;
+    if (onProgress)
+    {
+      QObject::connect(&progressTimer, &QTimer::timeout, [&]()
+      {
+        onProgress(pagesDone, pagesTotal);
+      });
+      progressTimer.start(ProgressPollInterval_ms);
+    }
+
+    std::thread worker{[&]()
+    {
+      result = db.backupToFileIncremental(dstFileName, [&](int done, int total)
+      {
+        pagesDone = done;
+        pagesTotal = total;
+      }, TournamentDB::DefaultBackupPagesPerStep, changeCountAtCompletion);
+
+      // the event is queued, so it's even delivered if the
+      // worker finishes before the loop has been started
+      QMetaObject::invokeMethod(&loop, "quit", Qt::QueuedConnection);
+    }};
+
+    loop.exec();
+    worker.join();
+    progressTimer.stop();
+
+    if (onProgress) onProgress(pagesDone, pagesTotal);
+
+    return result;
+  }
+}
@@ -0,0 +1,49 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2019  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BACKGROUNDBACKUP_H
+#define BACKGROUNDBACKUP_H
+
+#include <string>
+#include <functional>
+
+#include "TournamentDB.h"
+
+namespace QTournament
+{
+  /** \brief Writes a copy of the database to a file without blocking the GUI
+   *
+   * The copy is created by TournamentDB::backupToFileIncremental() in a worker
+   * thread. The calling thread keeps processing events until the copy is complete,
+   * very much like runOnSnapshot(). Thus, the operators can continue to enter
+   * results; these changes are included in the copy.
+   *
+   * If the connection can't be used from other threads, the copy is created
+   * in the calling thread and events are processed after each batch of pages.
+   *
+   * \returns the SQLite result code; SQLITE_OK (0) on success
+   */
+  int backupInBackground(
+      const TournamentDB& db,
+      const std::string& dstFileName,   ///< the destination file; will be replaced atomically
+      const std::function<void(int, int)>& onProgress = nullptr,   ///< called in the calling thread with the number of copied pages and the total number of pages
+      int* changeCountAtCompletion = nullptr   ///< receives the database's change count at the moment the copy was complete
+      );
+}
+
+#endif // BACKGROUNDBACKUP_H
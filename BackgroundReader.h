@@ -0,0 +1,80 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2019  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BACKGROUNDREADER_H
+#define BACKGROUNDREADER_H
+
+#include <thread>
+#include <exception>
+#include <functional>
+
+#include <QEventLoop>
+#include <QMetaObject>
+
+#include "TournamentDB.h"
+
+namespace QTournament
+{
+  /** \brief Runs a read-only job on a snapshot of the database in a worker thread
+   *
+   * The calling thread keeps processing events until the job is done, very much
+   * like HttpClient::blockingRequest(). Thus, the GUI stays responsive and the
+   * operators can continue to enter results while the job is running; the job
+   * itself sees the database state at the time of the call.
+   *
+   * If no snapshot can be created, the job is executed directly on `db`.
+   *
+   * Exceptions thrown by the job are re-thrown in the calling thread.
+   *
+   * \returns the result of the job
+   */
+  template<typename ResultType>
+  ResultType runOnSnapshot(const TournamentDB& db, const std::function<ResultType(const TournamentDB&)>& job)
+  {
+    auto snapshot = db.createSnapshot();
+    if (!snapshot) return job(db);
+
+    ResultType result;
+    std::exception_ptr err;
+    QEventLoop loop;
+    std::thread worker{[&]()
+    {
+      try
+      {
+        result = job(*snapshot);
+      }
+      catch (...)
+      {
+        err = std::current_exception();
+      }
+
+      // the event is queued, so it's even delivered if the
+      // worker finishes before the loop has been started
+      QMetaObject::invokeMethod(&loop, "quit", Qt::QueuedConnection);
+    }};
+
+    loop.exec();
+    worker.join();
+
+    if (err) std::rethrow_exception(err);
+
+    return result;
+  }
+}
+
+#endif // BACKGROUNDREADER_H
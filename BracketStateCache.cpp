@@ -0,0 +1,172 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2019  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdexcept>
+
+#include "BracketStateCache.h"
+#include "TournamentDB.h"
+#include "TournamentDataDefs.h"
+#include "Category.h"
+#include "CatMngr.h"
+#include "MatchMngr.h"
+#include "SvgBracket.h"
+
+using namespace std;
+
+namespace QTournament
+{
+
+  BracketStateCache::BracketStateCache(const TournamentDB& _db)
+    :db{_db}
+  {
+  }
+
+  //----------------------------------------------------------------------------
+
+  const SvgBracket::BracketMatchDataList& BracketStateCache::getSeededBracket(const Category& cat)
+  {
+    return getEntry(cat).seeded;
+  }
+
+  //----------------------------------------------------------------------------
+
+  const vector<SimplifiedRankingEntry>& BracketStateCache::getRanksAfterSeeding(const Category& cat)
+  {
+    return getEntry(cat).seededRanks;
+  }
+
+  //----------------------------------------------------------------------------
+
+  const vector<BracketStateCache::RoundState>& BracketStateCache::getRoundStates(const Category& cat, const Round& firstBracketRound, const Round& lastRound)
+  {
+    CatEntry& entry = getEntry(cat);
+
+    Round nextRound{entry.rounds.empty() ? firstBracketRound : Round{entry.rounds.back().round.get() + 1}};
+    if (nextRound > lastRound) return entry.rounds;
+
+    // apply only the rounds that have been
+    // finished since the last call
+    MatchMngr mm{db};
+    for (; nextRound <= lastRound; nextRound = Round{nextRound.get() + 1})
+    {
+      RoundState rs{nextRound, {}, {}};
+
+      const auto mgl = mm.getMatchGroupsForCat(cat, nextRound.get());
+      if (!mgl.empty())
+      {
+        std::vector<Match> maList;
+        for (const auto& ma : mgl[0].getMatches())
+        {
+          maList.push_back(ma);
+        }
+
+        rs.matchRanks = API::Qry::extractSortedRanksFromMatchList(maList);
+        entry.current.applyMatches(maList);
+      }
+      rs.bracketRanks = API::Qry::extractSortedRanksFromBracket(entry.current);
+
+      entry.rounds.push_back(std::move(rs));
+    }
+
+    return entry.rounds;
+  }
+
+  //----------------------------------------------------------------------------
+
+  void BracketStateCache::invalidate(int catId)
+  {
+    auto it = catId2Entry.find(catId);
+    if (it == catId2Entry.end()) return;
+
+    it->second.current = it->second.seeded;
+    it->second.rounds.clear();
+  }
+
+  //----------------------------------------------------------------------------
+
+  void BracketStateCache::clear()
+  {
+    catId2Entry.clear();
+  }
+
+  //----------------------------------------------------------------------------
+
+  vector<int> BracketStateCache::getSeedIds(int catId) const
+  {
+    // same selection as CatMngr::getSeeding() but without
+    // creating PlayerPair objects
+    auto stmt = db.get().prepStatement("SELECT id FROM " TabPairs " WHERE " Pairs_CatRef " = ?1 AND "
+                                       Pairs_InitialRank " != ?2 ORDER BY " Pairs_InitialRank " ASC");
+    stmt.bind(1, catId);
+    stmt.bind(2, InitialRankNotAssigned);
+
+    vector<int> result;
+    for (stmt.step(); stmt.hasData(); stmt.step())
+    {
+      result.push_back(stmt.getInt(0));
+    }
+
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+  BracketStateCache::CatEntry& BracketStateCache::getEntry(const Category& cat)
+  {
+    // categories in state CONFIG have no valid seeding
+    // (see CatMngr::getSeeding()); the bracket match system can't
+    // be changed anymore once a category has left this state
+    vector<int> seedIds;
+    if (cat.is_NOT_InState(ObjState::CAT_Config))
+    {
+      seedIds = getSeedIds(cat.getId());
+    }
+    if (seedIds.empty())
+    {
+      catId2Entry.erase(cat.getId());
+      throw std::runtime_error("getSeededBracketMatches(): no suitable seeding"); // this should never happen if the caller met the preconditions
+    }
+
+    auto it = catId2Entry.find(cat.getId());
+    if ((it != catId2Entry.end()) && (it->second.seedIds == seedIds)) return it->second;
+
+    // first use or modified seeding: parse the bracket
+    // definition and apply the seeding
+    CatMngr cm{db};
+    SvgBracketMatchSys brSys = static_cast<SvgBracketMatchSys>(cat.getParameter_int(CatParameter::BracketMatchSystem));
+    const auto seeding = cm.getSeeding(cat);
+    auto brDef = SvgBracket::findSvgBracket(brSys, seeding.size());
+    if (!brDef)
+    {
+      catId2Entry.erase(cat.getId());
+      throw std::runtime_error("getSeededBracketMatches(): no suitable bracket"); // this should never happen if the caller met the preconditions
+    }
+
+    CatEntry entry;
+    entry.seedIds = std::move(seedIds);
+    entry.seeded = SvgBracket::convertToBracketMatches(*brDef);
+    entry.seeded.applySeeding(seeding);
+    entry.seededRanks = API::Qry::extractSortedRanksFromBracket(entry.seeded);
+    entry.current = entry.seeded;
+
+    auto& result = catId2Entry[cat.getId()];
+    result = std::move(entry);
+    return result;
+  }
+
+}
@@ -0,0 +1,124 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2019  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BRACKETSTATECACHE_H
+#define BRACKETSTATECACHE_H
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include "BracketMatchData.h"
+#include "BackendAPI.h"
+
+namespace QTournament
+{
+  class TournamentDB;
+  class Category;
+
+  /** \brief Memoized bracket states of all bracket categories
+   *
+   * For each category, the cache holds the seeded bracket and the
+   * ranks that result from each finished bracket round. The entry of a
+   * category is keyed by its seeding and by the number of rounds that
+   * have been applied so far. Newly finished rounds are applied on top
+   * of the latest bracket state so that the bracket definition is parsed
+   * and the matches of each round are read only once.
+   *
+   * The cache lives as long as the database connection. MatchMngr
+   * invalidates a category if the winner of a finished match might
+   * have changed.
+   */
+  class BracketStateCache
+  {
+  public:
+    /** \brief The ranks that result from one finished bracket round
+     */
+    struct RoundState
+    {
+      Round round;
+      std::vector<SimplifiedRankingEntry> matchRanks;   ///< winner / loser ranks of the round's matches, sorted
+      std::vector<SimplifiedRankingEntry> bracketRanks;   ///< "matchless" ranks of the bracket after the round, sorted
+    };
+
+    explicit BracketStateCache(const TournamentDB& _db);
+    BracketStateCache(const BracketStateCache&) = delete;
+    BracketStateCache& operator=(const BracketStateCache&) = delete;
+
+    /** \returns the bracket matches of a category with the seeding already applied
+     *
+     * \throws std::runtime_error if the category has no seeding or no suitable bracket
+     */
+    const SvgBracket::BracketMatchDataList& getSeededBracket(const Category& cat);
+
+    /** \returns the sorted "matchless" ranks directly after seeding
+     *
+     * \throws std::runtime_error if the category has no seeding or no suitable bracket
+     */
+    const std::vector<SimplifiedRankingEntry>& getRanksAfterSeeding(const Category& cat);
+
+    /** \brief Provides the ranks of all rounds from `firstBracketRound` up to
+     * at least `lastRound`
+     *
+     * Rounds that are not yet in the cache are applied incrementally.
+     *
+     * \pre All rounds up to and including `lastRound` are finished
+     *
+     * \returns the states in ascending round order; the list may
+     * contain more rounds than requested
+     *
+     * \throws std::runtime_error if the category has no seeding or no suitable bracket
+     */
+    const std::vector<RoundState>& getRoundStates(
+        const Category& cat,
+        const Round& firstBracketRound,   ///< the first round of bracket matches in the category
+        const Round& lastRound   ///< the last round that is required by the caller
+        );
+
+    /** \brief Drops all applied rounds of a category; the seeded bracket is kept
+     */
+    void invalidate(int catId);
+
+    /** \brief Drops all cached data
+     */
+    void clear();
+
+  protected:
+    struct CatEntry
+    {
+      std::vector<int> seedIds;   ///< the IDs of the seeded pairs, sorted by initial rank
+      SvgBracket::BracketMatchDataList seeded;
+      std::vector<SimplifiedRankingEntry> seededRanks;
+      SvgBracket::BracketMatchDataList current;   ///< the bracket after the last round in `rounds`
+      std::vector<RoundState> rounds;
+    };
+
+    std::vector<int> getSeedIds(int catId) const;
+
+    /** \returns the entry for a category, (re-)created if the seeding has changed
+     */
+    CatEntry& getEntry(const Category& cat);
+
+  private:
+    std::reference_wrapper<const TournamentDB> db;
+    std::unordered_map<int, CatEntry> catId2Entry;
+  };
+
+}
+
+#endif // BRACKETSTATECACHE_H
@@ -37,6 +37,8 @@
 #include "MatchMngr.h"
 #include "PlayerMngr.h"
 #include "SvgBracket.h"
+#include "BracketStateCache.h"
+#include "MatchDurationStats.h"
 
 using namespace SqliteOverlay;
 
@@ -497,6 +499,7 @@ namespace QTournament
     cse->beginDeleteCategory(oldSeqNum);
     tab.deleteRowsByColumnValue("id", catId);
     fixSeqNumberAfterDelete(tab, oldSeqNum);
+    MatchDurationStats::deleteStatsForCat(db, catId);
     cse->endDeleteCategory();
 
     return Error::OK;
@@ -560,23 +563,22 @@ namespace QTournament
 
       // deletion 2a: matches
       // deletion 2b: match groups, they are refered to only by ranking data and matches
-      t = DbTab{db, TabMatch, false};
-      DbTab mgTab{db, TabMatchGroup, false};
-      for (const auto& mg : SqliteOverlay::getObjectsByColumnValue<MatchGroup>(db, mgTab, MG_CatRef, cat.getId()))
-      {
-        for (const auto& ma : mg.getMatches())
-        {
-          int deletedSeqNum = ma.getSeqNum();
-          t.deleteRowsByColumnValue("id", ma.getId());
-          fixSeqNumberAfterDelete(t, deletedSeqNum);
-        }
-
-        // the match group has incoming links from matches
-        // and ranking and both have been deleted by now
-        int deletedSeqNum = mg.getSeqNum();
-        mgTab.deleteRowsByColumnValue("id", mg.getId());
-        fixSeqNumberAfterDelete(mgTab, deletedSeqNum);
-      }
+      //
+      // both are deleted in bulk with a fixed number of statements
+      // instead of renumbering the remaining rows after each single deletion
+      Sloppy::estring maCond{"%1 IN (SELECT id FROM %2 WHERE %3 = %4)"};
+      maCond.arg(MA_GrpRef);
+      maCond.arg(TabMatchGroup);
+      maCond.arg(MG_CatRef);
+      maCond.arg(catId);
+      deleteRowsAndFixSeqNumbers(TabMatch, maCond);
+
+      // the match groups have incoming links from matches
+      // and ranking and both have been deleted by now
+      Sloppy::estring mgCond{"%1 = %2"};
+      mgCond.arg(MG_CatRef);
+      mgCond.arg(catId);
+      deleteRowsAndFixSeqNumbers(TabMatchGroup, mgCond);
 
       // deletion 3: player pairs
       t = DbTab{db, TabPairs, false};
@@ -591,11 +593,18 @@ namespace QTournament
       tab.deleteRowsByColumnValue("id", catId);
       fixSeqNumberAfterDelete(tab, deletedSeqNum);
 
+      // deletion 5: the persisted match durations
+      MatchDurationStats::deleteStatsForCat(db, catId);
+
       //
       // deletion completed
       //
       trans.commit();
 
+      // the category ID might be re-used for a new category;
+      // memoized brackets must not survive the deletion
+      db.getBracketStateCache().clear();
+
       // refresh all models and the reports tab
       cse->endResetAllModels();
 
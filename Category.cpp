@@ -753,58 +753,53 @@ namespace QTournament
     */
   Error Category::generateGroupMatches(const PlayerPairList& grpMembers, int grpNum, int firstRoundNum) const
   {
-    if ((grpNum < 1) && (grpNum != GroupNum_Iteration)) return Error::InvalidGroupNum;
+    MatchPlan plan;
+    Error e = addGroupMatchesToPlan(grpMembers, grpNum, firstRoundNum, plan);
+    if (e != Error::OK) return e;
 
-    RoundRobinGenerator rrg;
+    // create all or nothing
     MatchMngr mm{db};
-    int numPlayers = static_cast<int>(grpMembers.size());
-    int internalRoundNum = 0;
-
-    try
-    {
-      // create all or nothing
-      auto trans = db.get().startTransaction();
-
-      while (true)
-      {
-        // create matches for the next round
-        auto matches = rrg(numPlayers, internalRoundNum);
+    return mm.createMatchesFromPlan(*this, plan);
+  }
 
-        // if no new matches were created, we have
-        // covered all necessary rounds and can return
-        if (matches.size() == 0)
-        {
-          trans.commit();
-          return Error::OK;
-        }
+  //----------------------------------------------------------------------------
 
-        // create a match group for the new round
-        auto mg = mm.createMatchGroup(*this, firstRoundNum + internalRoundNum, grpNum);
-        if (!mg) return mg.err();
+  /**
+    Appends the match groups and matches for a round robin among a set
+    of PlayerPairs to a match plan. Nothing is written to the database.
 
-        // assign matches to this group
-        for (auto [pairIndex1, pairIndex2] : matches)
-        {
-          const PlayerPair& pp1 = grpMembers.at(pairIndex1);
-          const PlayerPair& pp2 = grpMembers.at(pairIndex2);
+    \param grpMembers list of PlayerPairs for that the group matches will be generated
+    \param grpNum the group number that will be applied to the matches / match groups
+    \param firstRoundNum the number of the first round of group matches, usually 1
+    \param plan the plan that receives the new match groups
 
-          auto newMatch = mm.createMatch(*mg);
-          if (!newMatch) return newMatch.err();
+    \return error code
+    */
+  Error Category::addGroupMatchesToPlan(const PlayerPairList& grpMembers, int grpNum, int firstRoundNum, MatchPlan& plan) const
+  {
+    if ((grpNum < 1) && (grpNum != GroupNum_Iteration)) return Error::InvalidGroupNum;
 
-          Error e = mm.setPlayerPairsForMatch(*newMatch, pp1, pp2);
-          if (e != Error::OK) return e;
-        }
+    // get the complete schedule for this group size at once
+    const RoundRobinSchedule schedule{static_cast<int>(grpMembers.size())};
 
-        // close this group (transition to FROZEN) and potentially promote it further to IDLE
-        mm.closeMatchGroup(*mg);
+    for (int internalRoundNum = 0; internalRoundNum < schedule.getNumRounds(); ++internalRoundNum)
+    {
+      // one match group per round
+      PlannedMatchGroup pmg{firstRoundNum + internalRoundNum, grpNum, {}};
+      pmg.matches.reserve(schedule.getMatchesPerRound());
 
-        ++internalRoundNum;
+      auto [first, last] = schedule.getRound(internalRoundNum);
+      for (auto it = first; it != last; ++it)
+      {
+        PlannedMatch pm;
+        pm.pair1Id = grpMembers.at(it->player1).getPairId();
+        pm.pair2Id = grpMembers.at(it->player2).getPairId();
+        pmg.matches.push_back(pm);
       }
+      plan.push_back(pmg);
     }
-    catch (...)
-    {
-      return Error::DatabaseError;
-    }
+
+    return Error::OK;
   }
 
   //----------------------------------------------------------------------------
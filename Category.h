@@ -40,6 +40,7 @@ namespace QTournament
   class RankingEntry;
   class Match;
   class MatchScore;
+  struct PlannedMatchGroup;
 
   enum class ModMatchResult
   {
@@ -127,6 +128,7 @@ namespace QTournament
     Error applyGroupAssignment(const std::vector<PlayerPairList>& grpCfg);
     Error applyInitialRanking(const PlayerPairList& seed);
     Error generateGroupMatches(const PlayerPairList &grpMembers, int grpNum, int firstRoundNum=1) const;
+    Error addGroupMatchesToPlan(const PlayerPairList &grpMembers, int grpNum, int firstRoundNum, std::vector<PlannedMatchGroup>& plan) const;
 
   };
 
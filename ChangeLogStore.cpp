@@ -0,0 +1,278 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2019  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdexcept>
+
+#include <sqlite3.h>
+
+#include "ChangeLogStore.h"
+
+using namespace std;
+
+namespace QTournament
+{
+  namespace
+  {
+    // the page cache of the temporary file; everything
+    // beyond that goes to disk
+    constexpr int SpillCacheSize_kB = 2048;
+
+    // finalizes a statement when it goes out of scope
+    class ScopedStatement
+    {
+    public:
+      ScopedStatement(sqlite3* db, const string& sql)
+      {
+        if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+        {
+          throw std::runtime_error{string{"ChangeLogStore: "} + sqlite3_errmsg(db)};
+        }
+      }
+      ~ScopedStatement() { sqlite3_finalize(stmt); }
+      ScopedStatement(const ScopedStatement&) = delete;
+      ScopedStatement& operator=(const ScopedStatement&) = delete;
+
+      sqlite3_stmt* get() const { return stmt; }
+
+      /** \returns `true` if a result row is available
+       */
+      bool step()
+      {
+        int rc = sqlite3_step(stmt);
+        if ((rc != SQLITE_ROW) && (rc != SQLITE_DONE))
+        {
+          throw std::runtime_error{string{"ChangeLogStore: "} + sqlite3_errmsg(sqlite3_db_handle(stmt))};
+        }
+        return (rc == SQLITE_ROW);
+      }
+
+      void reset()
+      {
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+      }
+
+    private:
+      sqlite3_stmt* stmt{nullptr};
+    };
+
+    //----------------------------------------------------------------------------
+
+    void execSql(sqlite3* db, const string& sql)
+    {
+      ScopedStatement stmt{db, sql};
+      while (stmt.step()) {}
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  ChangeLogStore::ChangeLogStore(size_t _maxInMemoryRows)
+    :maxInMemoryRows{_maxInMemoryRows}
+  {
+  }
+
+  //----------------------------------------------------------------------------
+
+  ChangeLogStore::~ChangeLogStore()
+  {
+    // closing the private database deletes the temporary file
+    if (spillDb != nullptr) sqlite3_close(spillDb);
+  }
+
+  //----------------------------------------------------------------------------
+
+  void ChangeLogStore::add(const SqliteOverlay::ChangeLogEntry& cle)
+  {
+    ++editCount;
+
+    RowKey key{cle.tabName, cle.rowId};
+    auto it = inMemory.find(key);
+    if (it == inMemory.end())
+    {
+      inMemory.emplace(std::move(key), cle.action);
+      if (inMemory.size() > maxInMemoryRows) spill();
+      return;
+    }
+
+    SqliteOverlay::RowChangeAction merged;
+    if (merge(it->second, cle.action, merged))
+    {
+      it->second = merged;
+    } else {
+      inMemory.erase(it);
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  void ChangeLogStore::add(const SqliteOverlay::ChangeLogList& log)
+  {
+    for (const auto& cle : log) add(cle);
+  }
+
+  //----------------------------------------------------------------------------
+
+  SqliteOverlay::ChangeLogList ChangeLogStore::getCompactedLog() const
+  {
+    SqliteOverlay::ChangeLogList result;
+    result.reserve(size());
+
+    // the changes in memory are newer than the
+    // spilled ones and take precedence
+    auto newer = inMemory;
+    if (spilledCount > 0)
+    {
+      ScopedStatement stmt{spillDb, "SELECT tabName, rowId, action FROM Spill"};
+      while (stmt.step())
+      {
+        RowKey key{reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 0)), sqlite3_column_int(stmt.get(), 1)};
+        auto action = static_cast<SqliteOverlay::RowChangeAction>(sqlite3_column_int(stmt.get(), 2));
+
+        auto it = newer.find(key);
+        if (it != newer.end())
+        {
+          const bool keep = merge(action, it->second, action);
+          newer.erase(it);
+          if (!keep) continue;
+        }
+
+        result.push_back(SqliteOverlay::ChangeLogEntry{action, "main", key.first, key.second});
+      }
+    }
+
+    for (const auto& [key, action] : newer)
+    {
+      result.push_back(SqliteOverlay::ChangeLogEntry{action, "main", key.first, key.second});
+    }
+
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+  void ChangeLogStore::clear()
+  {
+    inMemory.clear();
+    if (spilledCount > 0) execSql(spillDb, "DELETE FROM Spill");
+    spilledCount = 0;
+    editCount = 0;
+  }
+
+  //----------------------------------------------------------------------------
+
+  bool ChangeLogStore::merge(SqliteOverlay::RowChangeAction older, SqliteOverlay::RowChangeAction newer, SqliteOverlay::RowChangeAction& result)
+  {
+    using Action = SqliteOverlay::RowChangeAction;
+
+    // the server always receives the whole row, so
+    // the row's final state is all that matters
+    switch (newer)
+    {
+    case Action::Delete:
+      // a row that the server has never seen doesn't need to be deleted
+      if (older == Action::Insert) return false;
+      result = Action::Delete;
+      return true;
+
+    case Action::Update:
+      result = (older == Action::Insert) ? Action::Insert : Action::Update;
+      return true;
+
+    default:
+      // a re-used row ID after a deletion replaces the old row on the server
+      result = (older == Action::Delete) ? Action::Update : newer;
+      return true;
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  void ChangeLogStore::spill()
+  {
+    sqlite3* db = getSpillDb();
+
+    execSql(db, "BEGIN");
+    try
+    {
+      ScopedStatement sel{db, "SELECT action FROM Spill WHERE tabName = ?1 AND rowId = ?2"};
+      ScopedStatement ins{db, "INSERT OR REPLACE INTO Spill (tabName, rowId, action) VALUES (?1, ?2, ?3)"};
+      ScopedStatement del{db, "DELETE FROM Spill WHERE tabName = ?1 AND rowId = ?2"};
+
+      for (const auto& [key, newAction] : inMemory)
+      {
+        auto action = newAction;
+        sqlite3_bind_text(sel.get(), 1, key.first.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_int(sel.get(), 2, key.second);
+        bool keep{true};
+        if (sel.step())
+        {
+          auto older = static_cast<SqliteOverlay::RowChangeAction>(sqlite3_column_int(sel.get(), 0));
+          keep = merge(older, newAction, action);
+        }
+        sel.reset();
+
+        ScopedStatement& target = keep ? ins : del;
+        sqlite3_bind_text(target.get(), 1, key.first.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_int(target.get(), 2, key.second);
+        if (keep) sqlite3_bind_int(target.get(), 3, static_cast<int>(action));
+        target.step();
+        target.reset();
+      }
+    }
+    catch (...)
+    {
+      // keep everything in memory and retry with the next spill
+      execSql(db, "ROLLBACK");
+      throw;
+    }
+    execSql(db, "COMMIT");
+
+    ScopedStatement cnt{db, "SELECT count(*) FROM Spill"};
+    cnt.step();
+    spilledCount = static_cast<size_t>(sqlite3_column_int64(cnt.get(), 0));
+
+    inMemory.clear();
+  }
+
+  //----------------------------------------------------------------------------
+
+  sqlite3* ChangeLogStore::getSpillDb()
+  {
+    if (spillDb != nullptr) return spillDb;
+
+    // an empty file name yields a private database in a
+    // temporary file that is deleted when it is closed
+    if (sqlite3_open_v2("", &spillDb, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, nullptr) != SQLITE_OK)
+    {
+      const string msg = sqlite3_errmsg(spillDb);
+      sqlite3_close(spillDb);
+      spillDb = nullptr;
+      throw std::runtime_error{"ChangeLogStore: " + msg};
+    }
+
+    // the content is worthless after a crash anyway
+    execSql(spillDb, "PRAGMA journal_mode=OFF");
+    execSql(spillDb, "PRAGMA synchronous=OFF");
+    execSql(spillDb, "PRAGMA cache_size=-" + to_string(SpillCacheSize_kB));
+    execSql(spillDb, "CREATE TABLE Spill (tabName TEXT NOT NULL, rowId INTEGER NOT NULL, action INTEGER NOT NULL, "
+                     "PRIMARY KEY (tabName, rowId)) WITHOUT ROWID");
+
+    return spillDb;
+  }
+}
@@ -0,0 +1,113 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2019  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CHANGELOGSTORE_H
+#define CHANGELOGSTORE_H
+
+#include <string>
+#include <map>
+#include <utility>
+
+#include <SqliteOverlay/SqliteDatabase.h>
+
+struct sqlite3;
+
+namespace QTournament
+{
+  /** \brief A compacting store for database changes that haven't been
+   * synced to the server yet
+   *
+   * Only the net effect per (table, row) is kept: an insert followed by
+   * updates remains an insert, an insert followed by a deletion vanishes
+   * completely and so on. Thus, the size of the store depends on the number
+   * of distinct changed rows and not on the number of edits.
+   *
+   * If more than a given number of rows are held in memory, they are moved
+   * to a private, temporary database file and merged with the rows that
+   * have been moved there before. Thus, long offline periods don't lead
+   * to an ever growing memory footprint.
+   */
+  class ChangeLogStore
+  {
+  public:
+    static constexpr size_t DefaultMaxInMemoryRows = 10000;
+
+    explicit ChangeLogStore(size_t _maxInMemoryRows = DefaultMaxInMemoryRows);
+    ~ChangeLogStore();
+    ChangeLogStore(const ChangeLogStore&) = delete;
+    ChangeLogStore& operator=(const ChangeLogStore&) = delete;
+
+    /** \brief Merges a database change into the store
+     */
+    void add(const SqliteOverlay::ChangeLogEntry& cle);
+
+    /** \brief Merges a list of database changes, e.g. from
+     * SqliteDatabase::getAllChangesAndClearQueue(), into the store
+     */
+    void add(const SqliteOverlay::ChangeLogList& log);
+
+    /** \returns the compacted changes with one entry per (table, row);
+     * the store itself remains unchanged
+     */
+    SqliteOverlay::ChangeLogList getCompactedLog() const;
+
+    /** \brief Removes all changes from memory and from the temporary file
+     */
+    void clear();
+
+    /** \returns an upper bound for the number of distinct changed rows;
+     * rows that are in memory and in the temporary file are counted twice
+     */
+    size_t size() const { return inMemory.size() + spilledCount; }
+
+    bool empty() const { return (size() == 0); }
+
+    /** \returns the total number of edits that have been merged since the last clear()
+     */
+    size_t getEditCount() const { return editCount; }
+
+    /** \returns the number of rows in the temporary file
+     */
+    size_t getSpilledCount() const { return spilledCount; }
+
+    /** \brief The net effect of two subsequent changes of the same row
+     *
+     * \returns `false` if the changes cancel each other out (insert followed by deletion)
+     */
+    static bool merge(
+        SqliteOverlay::RowChangeAction older,
+        SqliteOverlay::RowChangeAction newer,
+        SqliteOverlay::RowChangeAction& result
+        );
+
+  protected:
+    using RowKey = std::pair<std::string, int>;   // (table name, row ID)
+
+    void spill();
+    sqlite3* getSpillDb();
+
+  private:
+    size_t maxInMemoryRows;
+    std::map<RowKey, SqliteOverlay::RowChangeAction> inMemory;   ///< always newer than the spilled changes
+    sqlite3* spillDb{nullptr};   ///< opened upon first use
+    size_t spilledCount{0};
+    size_t editCount{0};
+  };
+}
+
+#endif // CHANGELOGSTORE_H
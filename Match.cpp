@@ -193,6 +193,19 @@ namespace QTournament
 
   std::optional<MatchScore> Match::getScore(Error *err) const
   {
+    // the packed form is the cheapest to decode; it's
+    // written together with the result string
+    auto packedEntry = row.getInt2(MA_PackedResult);
+    if (packedEntry)
+    {
+      auto result = MatchScore::fromPackedInt(*packedEntry);
+      if (result)
+      {
+        Sloppy::assignIfNotNull<Error>(err, Error::OK);
+        return result;
+      }
+    }
+
     auto scoreEntry = row.getString2(MA_Result);
 
     if (!scoreEntry)
@@ -204,8 +217,7 @@ namespace QTournament
     // we assume that any score that has been written to the database
     // is valid. So we simply parse it from the database string
     // without further validating it against the category settings
-    QString scoreString = stdString2QString(*scoreEntry);
-    auto result = MatchScore::fromStringWithoutValidation(scoreString);
+    auto result = MatchScore::fromCharsWithoutValidation(*scoreEntry);
     if (!result)
     {
       // this should never happen
@@ -213,6 +225,7 @@ namespace QTournament
       // but if it does, we clear the invalid database entry
       // and return an error
       row.updateToNull(MA_Result);
+      row.updateToNull(MA_PackedResult);
       Sloppy::assignIfNotNull<Error>(err, Error::InconsistentMatchResultString);
       return {};
     }
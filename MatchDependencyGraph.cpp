@@ -0,0 +1,128 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2019  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string>
+
+#include "MatchDependencyGraph.h"
+#include "TournamentDataDefs.h"
+#include "MatchMngr.h"
+
+using namespace std;
+
+namespace QTournament
+{
+
+  MatchDependencyGraph::MatchDependencyGraph(const TournamentDB& db)
+  {
+    auto stmt = db.prepStatement("SELECT d." MD_MatchRef ", d." MD_PredecessorRef " FROM " TabMatchDependency " d"
+                                 " JOIN " TabMatch " m ON m.id = d." MD_MatchRef
+                                 " JOIN " TabMatch " p ON p.id = d." MD_PredecessorRef
+                                 " WHERE m." GenericStateFieldName " <> ?1 AND p." GenericStateFieldName " <> ?1");
+    stmt.bind(1, static_cast<int>(ObjState::MA_Finished));
+    for (stmt.step(); stmt.hasData(); stmt.step())
+    {
+      unfinishedPreds[stmt.getInt(0)].push_back(stmt.getInt(1));
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  const vector<int>& MatchDependencyGraph::getUnfinishedPredecessors(int maId) const
+  {
+    static const vector<int> noPreds{};
+
+    auto it = unfinishedPreds.find(maId);
+    return (it == unfinishedPreds.end()) ? noPreds : it->second;
+  }
+
+  //----------------------------------------------------------------------------
+
+  bool MatchDependencyGraph::hasUnfinishedPredecessor(int maId) const
+  {
+    return (unfinishedPreds.find(maId) != unfinishedPreds.end());
+  }
+
+  //----------------------------------------------------------------------------
+
+  bool MatchDependencyGraph::hasUnfinishedPredecessor(const TournamentDB& db, int maId)
+  {
+    auto stmt = db.getStatementCache().get(CachedQuery::UnfinishedPredecessorOfMatch);
+    stmt.bind(1, maId);
+
+    return stmt.step();
+  }
+
+  //----------------------------------------------------------------------------
+
+  void MatchDependencyGraph::rebuildForCategory(const TournamentDB& db, int catId)
+  {
+    auto delStmt = db.prepStatement("DELETE FROM " TabMatchDependency " WHERE " MD_MatchRef " IN"
+                                    " (SELECT m.id FROM " TabMatch " m JOIN " TabMatchGroup " g ON m." MA_GrpRef " = g.id"
+                                    " WHERE g." MG_CatRef " = ?1)");
+    delStmt.bind(1, catId);
+    delStmt.step();
+
+    // "mp" lists all matches of the category once per assigned player pair;
+    // "prev" contains the most recent earlier round of each pair and match.
+    // Symbolic links are added on top; their value is the ID of the source
+    // match, negative for the loser
+    static const string insertSql{
+      "WITH mp(maId, pairId, round) AS ("
+      " SELECT m.id, m." MA_Pair1Ref ", g." MG_Round " FROM " TabMatch " m JOIN " TabMatchGroup " g ON m." MA_GrpRef " = g.id"
+      " WHERE g." MG_CatRef " = ?1 AND m." MA_Pair1Ref " > 0"
+      " UNION ALL"
+      " SELECT m.id, m." MA_Pair2Ref ", g." MG_Round " FROM " TabMatch " m JOIN " TabMatchGroup " g ON m." MA_GrpRef " = g.id"
+      " WHERE g." MG_CatRef " = ?1 AND m." MA_Pair2Ref " > 0),"
+      " prev(maId, pairId, round) AS ("
+      " SELECT a.maId, a.pairId, MAX(b.round) FROM mp a JOIN mp b ON b.pairId = a.pairId AND b.round < a.round"
+      " GROUP BY a.maId, a.pairId)"
+      " INSERT INTO " TabMatchDependency " (" MD_MatchRef ", " MD_PredecessorRef ")"
+      " SELECT prev.maId, mp.maId FROM prev JOIN mp ON mp.pairId = prev.pairId AND mp.round = prev.round"
+      " UNION"
+      " SELECT m.id, src.id FROM " TabMatch " m JOIN " TabMatchGroup " g ON m." MA_GrpRef " = g.id"
+      " JOIN " TabMatch " src ON src.id = ABS(m." MA_Pair1SymbolicVal ")"
+      " WHERE g." MG_CatRef " = ?1 AND m." MA_Pair1SymbolicVal " <> 0 AND m." MA_Pair1SymbolicVal " <> ?2"
+      " UNION"
+      " SELECT m.id, src.id FROM " TabMatch " m JOIN " TabMatchGroup " g ON m." MA_GrpRef " = g.id"
+      " JOIN " TabMatch " src ON src.id = ABS(m." MA_Pair2SymbolicVal ")"
+      " WHERE g." MG_CatRef " = ?1 AND m." MA_Pair2SymbolicVal " <> 0 AND m." MA_Pair2SymbolicVal " <> ?2"
+    };
+    auto insStmt = db.prepStatement(insertSql);
+    insStmt.bind(1, catId);
+    insStmt.bind(2, MatchMngr::SymbolicIdForUnusedPlayerPairInMatch);
+    insStmt.step();
+  }
+
+  //----------------------------------------------------------------------------
+
+  void MatchDependencyGraph::rebuildAll(const TournamentDB& db)
+  {
+    vector<int> allCatIds;
+    auto stmt = db.prepStatement("SELECT id FROM " TabCategory);
+    for (stmt.step(); stmt.hasData(); stmt.step())
+    {
+      allCatIds.push_back(stmt.getInt(0));
+    }
+
+    for (int catId : allCatIds)
+    {
+      rebuildForCategory(db, catId);
+    }
+  }
+
+}
@@ -0,0 +1,82 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2019  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MATCHDEPENDENCYGRAPH_H
+#define MATCHDEPENDENCYGRAPH_H
+
+#include <vector>
+#include <unordered_map>
+#include <functional>
+
+#include "TournamentDB.h"
+
+namespace QTournament
+{
+  /** \brief The mandatory order of the matches within a category
+   *
+   * A match depends on
+   *   * the matches that provide its player pairs via symbolic winner / loser
+   *     links (this includes the links between bracket matches) and
+   *   * the previous match of each of its player pairs in an earlier round.
+   *
+   * The edges are persisted in the database and are rebuilt for a whole
+   * category whenever the structure of its matches changes (scheduling,
+   * resolved symbolic names, swapped players). Finishing a match doesn't
+   * modify the graph because the state of the predecessors is read from
+   * the match table.
+   *
+   * An instance of this class is a read-only snapshot of all dependencies
+   * between matches that are not yet finished.
+   */
+  class MatchDependencyGraph
+  {
+  public:
+    /** \brief Loads the unfinished predecessors of all unfinished matches
+     * with a single query
+     */
+    explicit MatchDependencyGraph(const TournamentDB& db);
+
+    /** \returns the IDs of all predecessors of a match that are not yet finished
+     */
+    const std::vector<int>& getUnfinishedPredecessors(int maId) const;
+
+    /** \returns `true` if the match has to wait for other matches; O(1)
+     */
+    bool hasUnfinishedPredecessor(int maId) const;
+
+    /** \brief Checks a single match without loading the whole graph
+     *
+     * \returns `true` if the match has to wait for other matches
+     */
+    static bool hasUnfinishedPredecessor(const TournamentDB& db, int maId);
+
+    /** \brief Replaces all dependencies of the matches in a category
+     */
+    static void rebuildForCategory(const TournamentDB& db, int catId);
+
+    /** \brief Replaces the dependencies of all matches in all categories
+     */
+    static void rebuildAll(const TournamentDB& db);
+
+  private:
+    std::unordered_map<int, std::vector<int>> unfinishedPreds;
+  };
+
+}
+
+#endif // MATCHDEPENDENCYGRAPH_H
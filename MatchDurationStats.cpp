@@ -0,0 +1,289 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2019  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+#include <SqliteOverlay/KeyValueTab.h>
+
+#include <Sloppy/String.h>
+
+#include "MatchDurationStats.h"
+#include "TournamentDataDefs.h"
+#include "CatMngr.h"
+
+using namespace std;
+
+namespace QTournament
+{
+
+  void CatMatchDurationStats::addSample(int duration_secs)
+  {
+    if (duration_secs < 0) return;
+
+    ewma_secs = (cnt == 0) ? duration_secs : (EwmaAlpha * duration_secs + (1.0 - EwmaAlpha) * ewma_secs);
+    ++cnt;
+    total_secs += duration_secs;
+
+    recent.push_back(duration_secs);
+    if (recent.size() > TrimWindowSize) recent.pop_front();
+  }
+
+  //----------------------------------------------------------------------------
+
+  int CatMatchDurationStats::getEstimate(MatchDurationEstimator est) const
+  {
+    if (cnt == 0) return -1;
+
+    switch (est)
+    {
+    case MatchDurationEstimator::ExpWeighted:
+      return static_cast<int>(ewma_secs);
+
+    case MatchDurationEstimator::TrimmedMean:
+    {
+      vector<int> sorted{begin(recent), end(recent)};
+      sort(begin(sorted), end(sorted));
+
+      // only trim if enough values remain
+      auto first = begin(sorted);
+      auto last = end(sorted);
+      if (sorted.size() > (2 * TrimCount + 1))
+      {
+        first += TrimCount;
+        last -= TrimCount;
+      }
+      const long sum = accumulate(first, last, 0l);
+      return static_cast<int>(sum / distance(first, last));
+    }
+
+    default:
+      return static_cast<int>(total_secs / cnt);
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  string CatMatchDurationStats::toString() const
+  {
+    // format: count;total;ewma;recent1,recent2,...
+    Sloppy::estring result{"%1;%2;%3;"};
+    result.arg(cnt);
+    result.arg(to_string(total_secs));
+    result.arg(static_cast<int>(ewma_secs));
+
+    Sloppy::StringList recentStr;
+    for (int d : recent) recentStr.push_back(to_string(d));
+    result += Sloppy::estring{recentStr, ","};
+
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+  CatMatchDurationStats CatMatchDurationStats::fromString(const string& s)
+  {
+    CatMatchDurationStats result;
+
+    Sloppy::estring es{s};
+    auto fields = es.split(";", true, true);
+    if (fields.size() != 4) return result;
+
+    try
+    {
+      result.cnt = stoi(fields[0]);
+      result.total_secs = stol(fields[1]);
+      result.ewma_secs = stod(fields[2]);
+      for (const auto& d : fields[3].split(",", false, true))
+      {
+        result.recent.push_back(stoi(d));
+      }
+    }
+    catch (...)
+    {
+      return CatMatchDurationStats{};
+    }
+
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+  MatchDurationStats::MatchDurationStats(const TournamentDB& _db)
+    :db{_db}
+  {
+  }
+
+  //----------------------------------------------------------------------------
+
+  void MatchDurationStats::reload()
+  {
+    SqliteOverlay::KeyValueTab cfg{db.get(), TabCfg};
+    int est = cfg.getInt2(CfgKey_Estimator).value_or(static_cast<int>(MatchDurationEstimator::Mean));
+    estimator = static_cast<MatchDurationEstimator>(est);
+
+    // older databases: the statistics are persisted
+    // with the next finished match
+    if (!(cfg.hasKey(CfgKey_StatsInitialized)))
+    {
+      catId2Stats = calcFromMatchTable(db);
+      return;
+    }
+
+    catId2Stats.clear();
+    CatMngr cm{db};
+    for (const Category& cat : cm.getAllCategories())
+    {
+      reloadCategory(cat.getId());
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  void MatchDurationStats::reloadCategory(int catId)
+  {
+    SqliteOverlay::KeyValueTab cfg{db.get(), TabCfg};
+    if (!(cfg.hasKey(CfgKey_StatsInitialized)))
+    {
+      reload();
+      return;
+    }
+
+    auto s = cfg.getString2(cfgKeyForCat(catId));
+    if (!s)
+    {
+      catId2Stats.erase(catId);
+      return;
+    }
+
+    catId2Stats[catId] = CatMatchDurationStats::fromString(*s);
+  }
+
+  //----------------------------------------------------------------------------
+
+  const CatMatchDurationStats& MatchDurationStats::getStatsForCat(int catId) const
+  {
+    static const CatMatchDurationStats emptyStats{};
+
+    auto it = catId2Stats.find(catId);
+    return (it == catId2Stats.end()) ? emptyStats : it->second;
+  }
+
+  //----------------------------------------------------------------------------
+
+  int MatchDurationStats::getTotalCount() const
+  {
+    int result{0};
+    for (const auto& [catId, stats] : catId2Stats) result += stats.getCount();
+
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+  long MatchDurationStats::getTotal_secs() const
+  {
+    long result{0};
+    for (const auto& [catId, stats] : catId2Stats) result += stats.getTotal_secs();
+
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+  void MatchDurationStats::setEstimator(MatchDurationEstimator est)
+  {
+    SqliteOverlay::KeyValueTab cfg{db.get(), TabCfg};
+    cfg.set(CfgKey_Estimator, static_cast<int>(est));
+    estimator = est;
+  }
+
+  //----------------------------------------------------------------------------
+
+  void MatchDurationStats::recordFinishedMatch(const TournamentDB& db, int catId, int duration_secs)
+  {
+    SqliteOverlay::KeyValueTab cfg{db, TabCfg};
+
+    // first write to the statistics of an older database; the
+    // match table already contains the new match
+    if (!(cfg.hasKey(CfgKey_StatsInitialized)))
+    {
+      for (const auto& [id, stats] : calcFromMatchTable(db))
+      {
+        cfg.set(cfgKeyForCat(id), stats.toString());
+      }
+      cfg.set(CfgKey_StatsInitialized, 1);
+      return;
+    }
+
+    const string key = cfgKeyForCat(catId);
+
+    CatMatchDurationStats stats;
+    auto s = cfg.getString2(key);
+    if (s) stats = CatMatchDurationStats::fromString(*s);
+
+    stats.addSample(duration_secs);
+    cfg.set(key, stats.toString());
+  }
+
+  //----------------------------------------------------------------------------
+
+  void MatchDurationStats::deleteStatsForCat(const TournamentDB& db, int catId)
+  {
+    SqliteOverlay::KeyValueTab cfg{db, TabCfg};
+
+    const string key = cfgKeyForCat(catId);
+    if (cfg.hasKey(key)) cfg.remove(key);
+  }
+
+  //----------------------------------------------------------------------------
+
+  string MatchDurationStats::cfgKeyForCat(int catId)
+  {
+    return CfgKey_StatsPrefix + to_string(catId);
+  }
+
+  //----------------------------------------------------------------------------
+
+  unordered_map<int, CatMatchDurationStats> MatchDurationStats::calcFromMatchTable(const TournamentDB& db)
+  {
+    // one query for all finished matches along with their
+    // category instead of resolving the category match by match
+    Sloppy::estring sql{"SELECT g.%1, m.%2 - m.%3 FROM %4 m JOIN %5 g ON m.%6 = g.id "
+                        "WHERE m.%7 = %8 AND m.%2 IS NOT NULL AND m.%3 IS NOT NULL ORDER BY m.%2 ASC"};
+    sql.arg(MG_CatRef);
+    sql.arg(MA_FinishTime);
+    sql.arg(MA_StartTime);
+    sql.arg(TabMatch);
+    sql.arg(TabMatchGroup);
+    sql.arg(MA_GrpRef);
+    sql.arg(GenericStateFieldName);
+    sql.arg(static_cast<int>(ObjState::MA_Finished));
+
+    unordered_map<int, CatMatchDurationStats> allStats;
+    auto stmt = db.prepStatement(sql);
+    for (stmt.step(); stmt.hasData(); stmt.step())
+    {
+      allStats[stmt.getInt(0)].addSample(stmt.getInt(1));
+    }
+
+    return allStats;
+  }
+
+}
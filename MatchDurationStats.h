@@ -0,0 +1,144 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2019  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MATCHDURATIONSTATS_H
+#define MATCHDURATIONSTATS_H
+
+#include <string>
+#include <deque>
+#include <unordered_map>
+#include <functional>
+
+#include "TournamentDB.h"
+
+namespace QTournament
+{
+  /** \brief The available methods for estimating the duration of
+   * the next match in a category
+   */
+  enum class MatchDurationEstimator
+  {
+    Mean = 0,   ///< plain average of all matches in the category
+    ExpWeighted,   ///< exponentially weighted moving average; follows trends during the day
+    TrimmedMean,   ///< average of the most recent matches without the extreme values
+  };
+
+  //----------------------------------------------------------------------------
+
+  /** \brief Running statistics of the match durations in one category
+   *
+   * All estimators are updated in O(1) per finished match.
+   */
+  class CatMatchDurationStats
+  {
+  public:
+    static constexpr double EwmaAlpha = 0.2;   ///< weight of the most recent match in the EWMA
+    static constexpr size_t TrimWindowSize = 20;   ///< number of recent matches for the trimmed mean
+    static constexpr size_t TrimCount = 2;   ///< number of matches that are dropped at each end of the window
+
+    void addSample(int duration_secs);
+
+    int getCount() const { return cnt; }
+    long getTotal_secs() const { return total_secs; }
+
+    /** \returns the estimated match duration in seconds or -1 if
+     * there are no finished matches at all
+     */
+    int getEstimate(MatchDurationEstimator est) const;
+
+    std::string toString() const;
+    static CatMatchDurationStats fromString(const std::string& s);
+
+  private:
+    int cnt{0};
+    long total_secs{0};
+    double ewma_secs{0.0};
+    std::deque<int> recent;
+  };
+
+  //----------------------------------------------------------------------------
+
+  /** \brief Per-category match duration statistics that are persisted
+   * in the config table
+   *
+   * The statistics are updated by MatchMngr whenever a regularly called
+   * match is finished. Loading them costs one config lookup per category,
+   * independent of the number of finished matches.
+   */
+  class MatchDurationStats
+  {
+  public:
+    static constexpr const char* CfgKey_StatsPrefix = "MatchDurationStats_";
+    static constexpr const char* CfgKey_StatsInitialized = "MatchDurationStatsInitialized";
+    static constexpr const char* CfgKey_Estimator = "MatchDurationEstimator";
+
+    MatchDurationStats(const TournamentDB& _db);
+
+    /** \brief Reloads the statistics of all categories from the database
+     *
+     * If the database has been created by a version without persisted
+     * statistics, the statistics are calculated in memory from the match
+     * table. This function never writes to the database, so it works on
+     * read-only snapshots and doesn't mark the database as modified.
+     */
+    void reload();
+
+    /** \brief Reloads the statistics of one category from the database
+     */
+    void reloadCategory(int catId);
+
+    /** \returns the statistics for a category; empty statistics
+     * if there are no finished matches in the category
+     */
+    const CatMatchDurationStats& getStatsForCat(int catId) const;
+
+    int getTotalCount() const;
+    long getTotal_secs() const;
+
+    MatchDurationEstimator getEstimator() const { return estimator; }
+    void setEstimator(MatchDurationEstimator est);
+
+    /** \brief Adds a finished match to the persisted statistics
+     * of its category
+     *
+     * Has to be called after the match's finish time has been written. If the
+     * statistics have not been persisted yet, they are initialized from the
+     * match table which then already contains the match.
+     */
+    static void recordFinishedMatch(const TournamentDB& db, int catId, int duration_secs);
+
+    /** \brief Removes the persisted statistics of a deleted category
+     *
+     * Category IDs can be re-used, so a new category must not
+     * inherit the statistics of a deleted one.
+     */
+    static void deleteStatsForCat(const TournamentDB& db, int catId);
+
+  protected:
+    static std::string cfgKeyForCat(int catId);
+    static std::unordered_map<int, CatMatchDurationStats> calcFromMatchTable(const TournamentDB& db);
+
+  private:
+    std::reference_wrapper<const TournamentDB> db;
+    std::unordered_map<int, CatMatchDurationStats> catId2Stats;
+    MatchDurationEstimator estimator{MatchDurationEstimator::Mean};
+  };
+
+}
+
+#endif // MATCHDURATIONSTATS_H
@@ -17,6 +17,10 @@
  */
 
 #include <assert.h>
+#include <algorithm>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
 
 #include <QDateTime>
 
@@ -31,6 +35,11 @@
 #include "CatMngr.h"
 #include <SqliteOverlay/KeyValueTab.h>
 #include "HelperFunc.h"
+#include "MatchDurationStats.h"
+#include "SwissLadderState.h"
+#include "MatchDependencyGraph.h"
+#include "BracketStateCache.h"
+#include "RefereeAssigner.h"
 
 using namespace SqliteOverlay;
 
@@ -244,6 +253,247 @@ namespace QTournament {
 
   //----------------------------------------------------------------------------
 
+  Error MatchMngr::createMatchesFromPlan(const Category& cat, MatchPlan& plan)
+  {
+    // same preconditions as for createMatchGroup()
+    ObjState catState = cat.getState();
+    if ((catState == ObjState::CAT_Config) || (catState == ObjState::CAT_Frozen))
+    {
+      return Error::CategoryStillConfigurable;
+    }
+    if (plan.empty()) return Error::OK;
+
+    const int catId = cat.getId();
+
+    // collect the group numbers of all existing and planned
+    // match groups, sorted by round
+    std::unordered_map<int, std::vector<int>> round2GrpNums;
+    Sloppy::estring sql{"SELECT %1, %2 FROM %3 WHERE %4 = %5"};
+    sql.arg(MG_Round);
+    sql.arg(MG_GrpNum);
+    sql.arg(TabMatchGroup);
+    sql.arg(MG_CatRef);
+    sql.arg(catId);
+    auto grpStmt = db.prepStatement(sql);
+    for (grpStmt.step(); grpStmt.hasData(); grpStmt.step())
+    {
+      round2GrpNums[grpStmt.getInt(0)].push_back(grpStmt.getInt(1));
+    }
+    const bool hasExistingGroups = !round2GrpNums.empty();
+
+    for (const PlannedMatchGroup& pmg : plan)
+    {
+      if (pmg.round <= 0) return Error::InvalidRound;
+      if (pmg.grpNum <= 0)
+      {
+        if ((pmg.grpNum != GroupNum_Final)
+            && (pmg.grpNum != GroupNum_Semi)
+            && (pmg.grpNum != GroupNum_Quarter)
+            && (pmg.grpNum != GroupNum_L16)
+            && (pmg.grpNum != GroupNum_Iteration))
+        {
+          return Error::InvalidGroupNum;
+        }
+      }
+
+      // we can't close empty match groups
+      if (pmg.matches.empty()) return Error::MatchGroupEmpty;
+
+      auto& grpNums = round2GrpNums[pmg.round];
+      if (std::find(grpNums.begin(), grpNums.end(), pmg.grpNum) != grpNums.end())
+      {
+        return Error::MatchGroupExists;
+      }
+      grpNums.push_back(pmg.grpNum);
+    }
+
+    // a match group with a special group number (e. g. semi finals)
+    // must be the only match group in its round
+    for (const auto& [round, grpNums] : round2GrpNums)
+    {
+      if (grpNums.size() < 2) continue;
+      if (std::any_of(grpNums.begin(), grpNums.end(), [](int grpNum) { return (grpNum <= 0); }))
+      {
+        return Error::InvalidGroupNum;
+      }
+    }
+
+    // get the group numbers of all player pairs in this category
+    std::unordered_map<int, int> pairId2GrpNum;
+    Sloppy::estring pairSql{"SELECT id, IFNULL(%1, %2) FROM %3 WHERE %4 = %5"};
+    pairSql.arg(Pairs_GrpNum);
+    pairSql.arg(GroupNum_NotAssigned);
+    pairSql.arg(TabPairs);
+    pairSql.arg(Pairs_CatRef);
+    pairSql.arg(catId);
+    auto pairStmt = db.prepStatement(pairSql);
+    for (pairStmt.step(); pairStmt.hasData(); pairStmt.step())
+    {
+      pairId2GrpNum[pairStmt.getInt(0)] = pairStmt.getInt(1);
+    }
+
+    // get the player pairs that are already assigned to matches
+    // in existing rounds
+    std::unordered_map<int, std::unordered_set<int>> round2UsedPairs;
+    if (hasExistingGroups)
+    {
+      Sloppy::estring usedSql{"SELECT g.%1, IFNULL(m.%2, -1), IFNULL(m.%3, -1) FROM %4 m JOIN %5 g ON m.%6 = g.id WHERE g.%7 = %8"};
+      usedSql.arg(MG_Round);
+      usedSql.arg(MA_Pair1Ref);
+      usedSql.arg(MA_Pair2Ref);
+      usedSql.arg(TabMatch);
+      usedSql.arg(TabMatchGroup);
+      usedSql.arg(MA_GrpRef);
+      usedSql.arg(MG_CatRef);
+      usedSql.arg(catId);
+      auto usedStmt = db.prepStatement(usedSql);
+      for (usedStmt.step(); usedStmt.hasData(); usedStmt.step())
+      {
+        auto& usedPairs = round2UsedPairs[usedStmt.getInt(0)];
+        usedPairs.insert(usedStmt.getInt(1));
+        usedPairs.insert(usedStmt.getInt(2));
+      }
+    }
+
+    // apply the same checks to all planned pairs
+    // as canAssignPlayerPairToMatch() does
+    for (const PlannedMatchGroup& pmg : plan)
+    {
+      auto& usedPairs = round2UsedPairs[pmg.round];
+      for (const PlannedMatch& pm : pmg.matches)
+      {
+        if ((pm.pair1Id > 0) && (pm.pair1Id == pm.pair2Id)) return Error::PlayersIdentical;
+
+        for (int pairId : {pm.pair1Id, pm.pair2Id})
+        {
+          if (pairId <= 0) continue;
+
+          auto it = pairId2GrpNum.find(pairId);
+          if (it == pairId2GrpNum.end()) return Error::PlayerNotInCategory;
+          if ((pmg.grpNum > 0) && (it->second != pmg.grpNum)) return Error::GroupNumberMismatch;
+
+          if (!(usedPairs.insert(pairId).second))
+          {
+            return Error::PlayerAlreadyAssignedToOtherMatchInTheSameRoundAndCategory;
+          }
+        }
+      }
+    }
+
+    //
+    // the plan is valid, now write everything to the database
+    //
+
+    CentralSignalEmitter* cse = CentralSignalEmitter::getInstance();
+    cse->beginResetAllModels();
+    bool isResetPending = true;
+
+    try
+    {
+      auto trans = db.startTransaction(DefaultTransactionType);
+
+      // new objects are always appended, so we can
+      // assign the sequence numbers in advance
+      const int firstGroupSeqNum = groupTab.length();
+      const int firstMatchSeqNum = tab.length();
+
+      // insert all match groups as FROZEN; that's what closeMatchGroup() would do
+      const std::string insertGroupSql = "INSERT INTO " + std::string{TabMatchGroup} + " ("
+                                         + MG_CatRef + ", " + MG_Round + ", " + MG_GrpNum + ", "
+                                         + GenericStateFieldName + ", " + GenericSeqnumFieldName
+                                         + ") VALUES (?, ?, ?, ?, ?)";
+      auto insertGroupStmt = db.prepStatement(insertGroupSql);
+      int seqNum = firstGroupSeqNum;
+      for (const PlannedMatchGroup& pmg : plan)
+      {
+        insertGroupStmt.bind(1, catId);
+        insertGroupStmt.bind(2, pmg.round);
+        insertGroupStmt.bind(3, pmg.grpNum);
+        insertGroupStmt.bind(4, static_cast<int>(ObjState::MG_Frozen));
+        insertGroupStmt.bind(5, seqNum);
+        insertGroupStmt.step();
+        insertGroupStmt.reset(true);
+        ++seqNum;
+      }
+
+      // retrieve the IDs of the new groups in one go
+      Sloppy::estring newGroupsSql{"SELECT id FROM %1 WHERE %2 >= %3 ORDER BY %2 ASC"};
+      newGroupsSql.arg(TabMatchGroup);
+      newGroupsSql.arg(GenericSeqnumFieldName);
+      newGroupsSql.arg(firstGroupSeqNum);
+      auto newGroupsStmt = db.prepStatement(newGroupsSql);
+      newGroupsStmt.step();
+      for (PlannedMatchGroup& pmg : plan)
+      {
+        pmg.matchGroupId = newGroupsStmt.getInt(0);
+        newGroupsStmt.step();
+      }
+
+      // insert all matches with the same defaults as createMatch()
+      const std::string insertMatchSql = "INSERT INTO " + std::string{TabMatch} + " ("
+                                         + MA_GrpRef + ", " + GenericStateFieldName + ", "
+                                         + MA_Pair1SymbolicVal + ", " + MA_Pair2SymbolicVal + ", "
+                                         + MA_WinnerRank + ", " + MA_LoserRank + ", " + MA_RefereeMode + ", "
+                                         + GenericSeqnumFieldName + ", " + MA_Pair1Ref + ", " + MA_Pair2Ref + ", "
+                                         + MA_BracketMatchNum + ") VALUES (?, ?, 0, 0, -1, -1, -1, ?, ?, ?, ?)";
+      auto insertMatchStmt = db.prepStatement(insertMatchSql);
+      seqNum = firstMatchSeqNum;
+      for (const PlannedMatchGroup& pmg : plan)
+      {
+        for (const PlannedMatch& pm : pmg.matches)
+        {
+          insertMatchStmt.bind(1, pmg.matchGroupId);
+          insertMatchStmt.bind(2, static_cast<int>(ObjState::MA_Incomplete));
+          insertMatchStmt.bind(3, seqNum);
+          if (pm.pair1Id > 0) insertMatchStmt.bind(4, pm.pair1Id);
+          else insertMatchStmt.bindNull(4);
+          if (pm.pair2Id > 0) insertMatchStmt.bind(5, pm.pair2Id);
+          else insertMatchStmt.bindNull(5);
+          if (pm.bracketMatchNum > 0) insertMatchStmt.bind(6, pm.bracketMatchNum);
+          else insertMatchStmt.bindNull(6);
+          insertMatchStmt.step();
+          insertMatchStmt.reset(true);
+          ++seqNum;
+        }
+      }
+
+      Sloppy::estring newMatchesSql{"SELECT id FROM %1 WHERE %2 >= %3 ORDER BY %2 ASC"};
+      newMatchesSql.arg(TabMatch);
+      newMatchesSql.arg(GenericSeqnumFieldName);
+      newMatchesSql.arg(firstMatchSeqNum);
+      auto newMatchesStmt = db.prepStatement(newMatchesSql);
+      newMatchesStmt.step();
+      for (PlannedMatchGroup& pmg : plan)
+      {
+        for (PlannedMatch& pm : pmg.matches)
+        {
+          pm.matchId = newMatchesStmt.getInt(0);
+          newMatchesStmt.step();
+        }
+      }
+
+      cse->endResetAllModels();
+      isResetPending = false;
+
+      // promote groups from FROZEN to IDLE, if possible
+      updateAllMatchGroupStates(cat);
+
+      trans.commit();
+    }
+    catch (...)
+    {
+      // the transaction has been rolled back; make
+      // sure the models re-read the old state
+      if (!isResetPending) cse->beginResetAllModels();
+      cse->endResetAllModels();
+      return Error::DatabaseError;
+    }
+
+    return Error::OK;
+  }
+
+  //----------------------------------------------------------------------------
+
   void MatchMngr::deleteMatchGroupAndMatch(const MatchGroup& mg) const
   {
     //
@@ -263,18 +513,45 @@ namespace QTournament {
     //
 
 
-    auto matchesInGroup = mg.getMatches();
-    for (const Match& ma : matchesInGroup)
+    deleteMatchGroupsAndMatches(MatchGroupList{mg});
+  }
+
+  //----------------------------------------------------------------------------
+
+  void MatchMngr::deleteMatchGroupsAndMatches(const MatchGroupList& mgl) const
+  {
+    //
+    // Same as deleteMatchGroupAndMatch() and with the same caveats;
+    // but all groups and matches are deleted with a fixed number
+    // of statements, independent of the number of groups and matches
+    //
+
+    if (mgl.empty()) return;
+
+    Sloppy::estring idList;
+    for (const MatchGroup& mg : mgl)
     {
-      int deletedSeqNum = ma.getSeqNum();
-      tab.deleteRowsByColumnValue("id", ma.getId());
-      fixSeqNumberAfterDelete(tab, deletedSeqNum);
+      if (!idList.empty()) idList += ",";
+      idList += std::to_string(mg.getId());
     }
 
-    // delete the group itself.
-    int deletedSeqNum = mg.getSeqNum();
-    groupTab.deleteRowsByColumnValue("id", mg.getId());
-    fixSeqNumberAfterDelete(groupTab, deletedSeqNum);
+    auto trans = db.startTransaction(DefaultTransactionType);
+
+    // delete the matches first, because they refer to the groups
+    Sloppy::estring maCond{"%1 IN (%2)"};
+    maCond.arg(MA_GrpRef);
+    maCond.arg(idList);
+    deleteRowsAndFixSeqNumbers(TabMatch, maCond);
+
+    // delete the groups themselves
+    Sloppy::estring mgCond{"id IN (%1)"};
+    mgCond.arg(idList);
+    deleteRowsAndFixSeqNumbers(TabMatchGroup, mgCond);
+
+    trans.commit();
+
+    // memoized brackets might refer to the deleted matches
+    db.getBracketStateCache().clear();
   }
 
   //----------------------------------------------------------------------------
@@ -666,6 +943,27 @@ namespace QTournament {
 
   //----------------------------------------------------------------------------
 
+  Error MatchMngr::autoAssignReferee(const Match& ma, RefereeAction refAction, RefereeAssigner* assigner) const
+  {
+    Error e = ma.canAssignReferee(refAction);
+    if (e != Error::OK) return e;
+
+    std::optional<RefereeAssigner> tmpAssigner;
+    if (assigner == nullptr)
+    {
+      tmpAssigner.emplace(db);
+      assigner = &(*tmpAssigner);
+    }
+
+    auto refId = assigner->suggestReferee(ma, refAction);
+    if (!refId) return Error::NoRefereeCandidate;
+
+    PlayerMngr pm{db};
+    return assignReferee(ma, pm.getPlayer(*refId), refAction);
+  }
+
+  //----------------------------------------------------------------------------
+
   Error MatchMngr::swapPlayer(const Match& ma, const PlayerPair& ppOld, const PlayerPair& ppNew) const
   {
     // the matches may not be "running" or "finished"
@@ -734,6 +1032,9 @@ namespace QTournament {
         }
       }
 
+      // the pair's previous matches have changed
+      MatchDependencyGraph::rebuildForCategory(db, newPairCat->getId());
+
       // update the match status because ready / busy might
       // have changed due to the player swap
       updateMatchStatus(ma);
@@ -1266,9 +1567,10 @@ namespace QTournament {
    */
   bool MatchMngr::hasUnfinishedMandatoryPredecessor(const Match &ma) const
   {
-    // FIX ME: for now, we always return `false` and thus we allow any
-    // match to be called regardless of any pending matches in earlier rounds
-    return false;
+    // a single lookup in the persisted dependency graph; the graph
+    // contains the previous match of each player pair and the
+    // matches that are referenced by symbolic names
+    return MatchDependencyGraph::hasUnfinishedPredecessor(db, ma.getId());
   }
 
   //----------------------------------------------------------------------------
@@ -1283,7 +1585,20 @@ namespace QTournament {
 
     CentralSignalEmitter* cse = CentralSignalEmitter::getInstance();
 
-    for (auto mg : getStagedMatchGroupsOrderedBySequence())
+    // the match dependencies have to be complete before
+    // updateMatchStatus() checks them below
+    const MatchGroupList stagedGroups = getStagedMatchGroupsOrderedBySequence();
+    std::set<int> stagedCatIds;
+    for (const MatchGroup& mg : stagedGroups)
+    {
+      stagedCatIds.insert(mg.getCategory().getId());
+    }
+    for (int catId : stagedCatIds)
+    {
+      MatchDependencyGraph::rebuildForCategory(db, catId);
+    }
+
+    for (auto mg : stagedGroups)
     {
       for (auto ma : mg.getMatches())
       {
@@ -1535,7 +1850,7 @@ namespace QTournament {
     catm.updateCatStatusFromMatchStatus(ma.getCategory());
 
     // store the call time in the database
-    ma.rowRef().update(MA_StartTime, UTCTimestamp());
+    ma.rowRef().update(MA_StartTime, static_cast<int>(now()));
 
     // check all matches that are currently "READY" because
     // due to the player allocation, some of them might have
@@ -1581,6 +1896,83 @@ namespace QTournament {
 
   //----------------------------------------------------------------------------
 
+  CalledMatchList MatchMngr::callMatchesOnFreeCourts(bool includeManualCourts, bool autoAssignReferees) const
+  {
+    CalledMatchList result;
+
+    // all candidates in the same order as API::Qry::nextCallableMatch()
+    WhereClause wc;
+    wc.addCol(GenericStateFieldName, static_cast<int>(ObjState::MA_Ready));
+    wc.setOrderColumn_Asc(MA_Num);
+    const MatchList candidates = getObjectsByWhereClause<Match>(wc);
+    if (candidates.empty()) return result;
+
+    // the models re-read everything once at the end; the status
+    // signals of the individual match calls are still emitted because
+    // non-model listeners (e.g., the time predictor, the category and
+    // player tabs) rely on them
+    CentralSignalEmitter* cse = CentralSignalEmitter::getInstance();
+    cse->beginResetAllModels();
+
+    try
+    {
+      auto trans = db.startTransaction(DefaultTransactionType);
+
+      CourtMngr cm{db};
+      std::optional<RefereeAssigner> assigner;
+      for (const Match& ma : candidates)
+      {
+        auto court = cm.autoSelectNextUnusedCourt(includeManualCourts);
+        if (!court) break;
+
+        // the match might have become BUSY because of a call
+        // earlier in this batch; matches that still need an
+        // umpire have to be called manually unless we may
+        // pick the umpire ourselves
+        Error e = canAssignMatchToCourt(ma, *court);
+        bool refereeAutoAssigned{false};
+        if ((e == Error::MatchNeedsReferee) && autoAssignReferees)
+        {
+          if (!assigner) assigner.emplace(db);
+          if (autoAssignReferee(ma, RefereeAction::MatchCall, &(*assigner)) != Error::OK) continue;
+          refereeAutoAssigned = true;
+          e = canAssignMatchToCourt(ma, *court);
+        }
+        if (e == Error::OK) e = assignMatchToCourt(ma, *court);   // shouldn't fail after the check
+
+        // don't leave our umpire on a match that hasn't been called
+        if (e != Error::OK)
+        {
+          if (refereeAutoAssigned) removeReferee(ma);
+          continue;
+        }
+
+        // keep the in-memory player states up to date
+        // for the next umpire selection in this batch
+        if (assigner)
+        {
+          auto referee = ma.getAssignedReferee();
+          assigner->markMatchCalled(ma, referee ? referee->getId() : -1);
+        }
+
+        result.push_back(CalledMatch{ma, *court});
+      }
+
+      trans.commit();
+    }
+    catch (...)
+    {
+      // the transaction has been rolled back
+      result.clear();
+    }
+
+    cse->endResetAllModels();
+
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
   MatchFinalizationResult MatchMngr::setMatchScoreAndFinalizeMatch(const Match &ma, const MatchScore &score, bool isWalkover) const
   {
     // check the match's state
@@ -1630,20 +2022,42 @@ namespace QTournament {
 
       // store score and FINISH status
       ColumnValueClause cvc;
-      cvc.addCol(MA_Result, score.toString().toUtf8().constData());
+      MatchScore::StringBuffer scoreBuf;
+      cvc.addCol(MA_Result, std::string{score.toChars(scoreBuf)});
+      cvc.addCol(MA_PackedResult, score.toPackedInt());
       cvc.addCol(GenericStateFieldName, static_cast<int>(ObjState::MA_Finished));
 
       // store the finish time in the database, but only if this is not
       // a walkover and only if the match was started regularly
-      if ((oldState == ObjState::MA_Running) && !isWalkover)   // match was called normally, so we have a start time
+      const bool hasRegularTimes = ((oldState == ObjState::MA_Running) && !isWalkover);   // match was called normally, so we have a start time
+      const int finishTime = static_cast<int>(now());
+      if (hasRegularTimes)
       {
-        UTCTimestamp now;
-        cvc.addCol(MA_FinishTime, &now);
+        cvc.addCol(MA_FinishTime, finishTime);
       }
 
       // apply the update
       ma.rowRef().update(cvc);
 
+      // update the match duration statistics as part of the
+      // same transaction; this saves MatchTimePredictor from
+      // scanning all finished matches
+      if (hasRegularTimes)
+      {
+        auto startTime = ma.rowRef().getInt2(MA_StartTime);
+        if (startTime)
+        {
+          MatchDurationStats::recordFinishedMatch(db, cat.getId(), finishTime - *startTime);
+        }
+      }
+
+      // same for the list of played matches in Swiss ladder
+      // categories; used for generating the next round
+      if (cat.getMatchSystem() == MatchSystem::SwissLadder)
+      {
+        SwissLadderState::recordFinishedMatch(db, cat.getId(), ma.getPlayerPair1().getPairId(), ma.getPlayerPair2().getPairId());
+      }
+
       // let the world know what has happened
       int maId = ma.getId();
       int maSeqNum = ma.getSeqNum();
@@ -1791,7 +2205,18 @@ namespace QTournament {
     }
 
     // everything is fine, so write the result to the database
-    ma.rowRef().update(MA_Result, newScore.toString().toUtf8().constData());
+    MatchScore::StringBuffer scoreBuf;
+    ColumnValueClause cvc;
+    cvc.addCol(MA_Result, std::string{newScore.toChars(scoreBuf)});
+    cvc.addCol(MA_PackedResult, newScore.toPackedInt());
+    ma.rowRef().update(cvc);
+
+    // the winner might have changed; the bracket has to
+    // be re-played upon the next request
+    if (winnerLoserChangePermitted)
+    {
+      db.getBracketStateCache().invalidate(cat.getId());
+    }
 
     CentralSignalEmitter* cse = CentralSignalEmitter::getInstance();
     cse->matchResultUpdated(ma.getId(), ma.getSeqNum());
@@ -2010,6 +2435,22 @@ namespace QTournament {
 
   //----------------------------------------------------------------------------
 
+  MatchHandleList MatchMngr::getFinishedMatchHandles() const
+  {
+    auto stmt = db.prepStatement("SELECT id FROM " TabMatch " WHERE " GenericStateFieldName " = ?1 ORDER BY id ASC");
+    stmt.bind(1, static_cast<int>(ObjState::MA_Finished));
+
+    MatchHandleList result;
+    for (stmt.step(); stmt.hasData(); stmt.step())
+    {
+      result.emplace_back(stmt.getInt(0));
+    }
+
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
   MatchList MatchMngr::getMatchesForMatchGroup(const MatchGroup &grp) const
   {
     return getObjectsByColumnValue<Match>(MA_GrpRef, grp.getId());
@@ -2059,22 +2500,66 @@ namespace QTournament {
 
   std::optional<Match> MatchMngr::getMatchForPlayerPairAndRound(const PlayerPair &pp, int round) const
   {
-    auto cat = pp.getCategory(db);
-    if (!cat) return {};
+    // a single, pre-compiled query; the pair's category
+    // is determined by the query itself
+    auto stmt = db.getStatementCache().get(CachedQuery::MatchForPairAndRound);
+    stmt.bind(1, pp.getPairId());
+    stmt.bind(2, round);
+    if (!stmt.step()) return {};
+
+    return Match{db, stmt.getInt(0)};
+  }
 
-    for (MatchGroup mg : getMatchGroupsForCat(*cat, round))
-    {
-      Sloppy::estring where = "(%1 = %2 OR %3 = %2) AND %4 = %5";
-      where.arg(MA_Pair1Ref);
-      where.arg(pp.getPairId());
-      where.arg(MA_Pair2Ref);
-      where.arg(MA_GrpRef);
-      where.arg(mg.getId());
+  //----------------------------------------------------------------------------
 
-      auto result = getSingleObjectByWhereClause<Match>(where);
-      if (result) return result;
+  PairRoundMatchMap MatchMngr::getMatchesByPairAndRound(const Category& cat) const
+  {
+    Sloppy::estring sql{"SELECT m.id, IFNULL(m.%1, -1), IFNULL(m.%2, -1), g.%3 FROM %4 m JOIN %5 g ON m.%6 = g.id WHERE g.%7 = %8"};
+    sql.arg(MA_Pair1Ref);
+    sql.arg(MA_Pair2Ref);
+    sql.arg(MG_Round);
+    sql.arg(TabMatch);
+    sql.arg(TabMatchGroup);
+    sql.arg(MA_GrpRef);
+    sql.arg(MG_CatRef);
+    sql.arg(cat.getId());
+
+    PairRoundMatchMap result{db};
+    auto stmt = db.prepStatement(sql);
+    for (stmt.step(); stmt.hasData(); stmt.step())
+    {
+      const int maId = stmt.getInt(0);
+      const int round = stmt.getInt(3);
+      for (int col : {1, 2})
+      {
+        const int pairId = stmt.getInt(col);
+        if (pairId > 0) result.insert(pairId, round, maId);
+      }
     }
-    return {};
+
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+  std::optional<Match> PairRoundMatchMap::getMatch(const PlayerPair& pp, int round) const
+  {
+    auto it = key2MatchId.find({pp.getPairId(), round});
+    if (it == key2MatchId.end()) return {};
+
+    return Match{db, it->second};
+  }
+
+  //----------------------------------------------------------------------------
+
+  std::optional<Match> PairRoundMatchMap::getFirstMatchInRounds(const PlayerPair& pp, int firstRound, int lastRound) const
+  {
+    // the map is sorted by pair ID and round, so the
+    // first entry at or after firstRound is what we're looking for
+    auto it = key2MatchId.lower_bound({pp.getPairId(), firstRound});
+    if ((it == key2MatchId.end()) || (it->first.first != pp.getPairId()) || (it->first.second > lastRound)) return {};
+
+    return Match{db, it->second};
   }
 
   //----------------------------------------------------------------------------
@@ -2104,7 +2589,12 @@ namespace QTournament {
     {
       for (const auto& [symbolicValue, pairId] : symbolicValue2PairId)
       {
-        for (const Match& m : getObjectsByColumnValue<Match>(symbolColName, symbolicValue))
+        // the redundant "<> 0" term is required for using
+        // the partial index on the symbolic values
+        Sloppy::estring where{"%1 = %2 AND %1 <> 0"};
+        where.arg(symbolColName);
+        where.arg(symbolicValue);
+        for (const Match& m : getObjectsByWhereClause<Match>(where))
         {
           // we may only modify matches in state FUZZY or INCOMPLETE
           ObjState stat = m.getState();
@@ -2120,6 +2610,10 @@ namespace QTournament {
       }
     }
 
+    // the resolved matches now depend on the previous
+    // matches of their new player pairs
+    MatchDependencyGraph::rebuildForCategory(db, ma.getCategory().getId());
+
     // if we resolved all symbolic references of a match, it may be promoted from
     // FUZZY at least to WAITING, maybe even to READY or BUSY
     WhereClause wc;
@@ -2137,6 +2631,13 @@ namespace QTournament {
 
   //----------------------------------------------------------------------------
 
+  time_t MatchMngr::now() const
+  {
+    return timeSource ? timeSource() : time(nullptr);
+  }
+
+  //----------------------------------------------------------------------------
+
 
   //----------------------------------------------------------------------------
 
@@ -20,8 +20,12 @@
 #define	MATCHMNGR_H
 
 #include <memory>
+#include <vector>
 #include <tuple>
 #include <optional>
+#include <map>
+#include <functional>
+#include <ctime>
 
 #include <QList>
 #include <QString>
@@ -36,6 +40,7 @@
 #include "Match.h"
 #include "Court.h"
 #include "Score.h"
+#include "ObjectHandle.h"
 
 namespace QTournament
 {
@@ -54,10 +59,81 @@ namespace QTournament
 
   //----------------------------------------------------------------------------
 
+  /** \brief A match that shall be created by MatchMngr::createMatchesFromPlan()
+   */
+  struct PlannedMatch
+  {
+    int pair1Id{-1};   ///< the ID of the first player pair or -1 if not yet known
+    int pair2Id{-1};   ///< the ID of the second player pair or -1 if not yet known
+    int bracketMatchNum{-1};   ///< the bracket match number for bracket matches, -1 otherwise
+    int matchId{-1};   ///< the ID of the new match; set by MatchMngr::createMatchesFromPlan()
+  };
+
+  /** \brief A match group along with its matches for MatchMngr::createMatchesFromPlan()
+   */
+  struct PlannedMatchGroup
+  {
+    int round;
+    int grpNum;
+    std::vector<PlannedMatch> matches;
+    int matchGroupId{-1};   ///< the ID of the new match group; set by MatchMngr::createMatchesFromPlan()
+  };
+
+  using MatchPlan = std::vector<PlannedMatchGroup>;
+
+  //----------------------------------------------------------------------------
+
+  /** \brief A match that has been called by MatchMngr::callMatchesOnFreeCourts()
+   */
+  struct CalledMatch
+  {
+    Match ma;
+    Court co;   ///< the court on which the match has been called
+  };
+
+  using CalledMatchList = std::vector<CalledMatch>;
+
+  //----------------------------------------------------------------------------
+
+  /** \brief The matches of all player pairs in a category, indexed
+   * by pair and round
+   *
+   * Created by MatchMngr::getMatchesByPairAndRound() with a single query.
+   * This is a snapshot that does not follow later changes of the matches.
+   */
+  class PairRoundMatchMap
+  {
+  public:
+    PairRoundMatchMap(const TournamentDB& _db)
+      :db{_db} {}
+
+    /** \returns the match of a player pair in a given round, if any
+     */
+    std::optional<Match> getMatch(const PlayerPair& pp, int round) const;
+
+    /** \returns the match of a player pair in the first round
+     * between `firstRound` and `lastRound` (inclusive) in which the pair
+     * plays at all, if any
+     */
+    std::optional<Match> getFirstMatchInRounds(const PlayerPair& pp, int firstRound, int lastRound) const;
+
+    void insert(int pairId, int round, int matchId) { key2MatchId[{pairId, round}] = matchId; }
+
+  private:
+    std::reference_wrapper<const TournamentDB> db;
+    std::map<std::pair<int, int>, int> key2MatchId;
+  };
+
+  //----------------------------------------------------------------------------
+
+  class RefereeAssigner;
+
   class MatchMngr : public QObject, public TournamentDatabaseObjectManager
   {
     Q_OBJECT
   public:
+    static constexpr int SymbolicIdForUnusedPlayerPairInMatch = 999999;
+
     // ctor
     MatchMngr(const TournamentDB& _db);
 
@@ -65,15 +141,40 @@ namespace QTournament
     MatchGroupOrError createMatchGroup(const Category& cat, const int round, const int grpNum);
     MatchOrError createMatch(const MatchGroup& grp);
 
+    /** \brief Creates match groups and their matches for a category in one go
+     *
+     * The whole plan is validated before anything is written. All groups
+     * and matches are inserted in a single transaction and the groups are
+     * closed afterwards. Instead of one "create" signal per object, all
+     * models receive a single reset.
+     *
+     * On success, the IDs of the new groups and matches are stored in the plan.
+     *
+     * \returns error code
+     */
+    Error createMatchesFromPlan(const Category& cat, MatchPlan& plan);
+
     // deletion
     void deleteMatchGroupAndMatch(const MatchGroup& mg) const;
+    void deleteMatchGroupsAndMatches(const MatchGroupList& mgl) const;
 
     // retrievers / enumerators for MATCHES
     MatchList getCurrentlyRunningMatches() const;
     MatchList getFinishedMatches() const;
+
+    /** \returns the handles of all finished matches in ID order; one query, no objects */
+    MatchHandleList getFinishedMatchHandles() const;
     MatchList getMatchesForMatchGroup(const MatchGroup& grp) const;
     std::optional<Match> getMatchForCourt(const Court& court);
     std::optional<Match> getMatchForPlayerPairAndRound(const PlayerPair& pp, int round) const;
+
+    /** \brief Retrieves the matches of all player pairs in a category
+     * with a single query
+     *
+     * Use this instead of repeated calls to getMatchForPlayerPairAndRound()
+     * if you need the matches of many pairs or rounds.
+     */
+    PairRoundMatchMap getMatchesByPairAndRound(const Category& cat) const;
     std::optional<Match> getMatchBySeqNum(int maSeqNum) const;
     std::optional<Match> getMatchByMatchNum(int maNum) const;
     std::optional<Match> getMatch(int id) const;
@@ -115,6 +216,26 @@ namespace QTournament
     Error assignMatchToCourt(const Match& ma, const Court& court) const;
     void setBrackMatchLink(const Match& ma, const BracketMatchNumber& bm) const;
     std::optional<Court> autoAssignMatchToNextAvailCourt(const Match& ma, Error* err, bool includeManualCourts=false) const;
+
+    /** \brief Calls as many matches as possible on all free courts
+     *
+     * The matches are picked in the same order as API::Qry::nextCallableMatch()
+     * does. Matches that can't be called right now (e.g., because of a player
+     * conflict with a match called earlier in the same batch or because an
+     * umpire still has to be selected) are skipped.
+     *
+     * If `autoAssignReferees` is set, matches that still need an umpire get
+     * the most suitable candidate assigned (see autoAssignReferee()). All these
+     * assignments use one RefereeAssigner so that the candidate ranking doesn't
+     * require any database access.
+     *
+     * All calls are executed in a single transaction. Instead of individual
+     * signals for every match, player and court, all models receive a
+     * single reset.
+     *
+     * \returns the called matches along with their courts in call order; empty on error
+     */
+    CalledMatchList callMatchesOnFreeCourts(bool includeManualCourts=false, bool autoAssignReferees=false) const;
     MatchFinalizationResult setMatchScoreAndFinalizeMatch(const Match& ma, const MatchScore& score, bool isWalkover=false) const;
     Error updateMatchScore(const Match& ma, const MatchScore& newScore, bool winnerLoserChangePermitted) const;
     Error setNextMatchForWinner(const Match& fromMatch, const Match& toMatch, int playerNum) const;
@@ -124,11 +245,26 @@ namespace QTournament
     // configuration of MATCH GROUPS
     Error closeMatchGroup(const MatchGroup& grp);
 
+    // replaces the wall clock for start and finish times; for simulations only
+    void setTimeSource(std::function<time_t ()> ts) { timeSource = ts; }
+
     // referee/umpire handling
     Error setRefereeMode(const Match& ma, RefereeMode newMode) const;
     Error assignReferee(const Match& ma, const Player& p, RefereeAction refAction) const;
     Error removeReferee(const Match& ma) const;
 
+    /** \brief Assigns the most suitable referee according to the
+     * match's referee mode; see RefereeAssigner for the ranking
+     *
+     * \returns Error::NoRefereeCandidate if there is no suitable
+     * player or the error of assignReferee()
+     */
+    Error autoAssignReferee(
+        const Match& ma,
+        RefereeAction refAction,
+        RefereeAssigner* assigner = nullptr   ///< an assigner with up-to-date in-memory data; if `nullptr`, a temporary assigner is created
+        ) const;
+
     // swap player between matches if match results are
     // changed after a match has finished
     Error swapPlayer(const Match& ma, const PlayerPair& ppOld, const PlayerPair& ppNew) const;
@@ -140,11 +276,12 @@ namespace QTournament
 
   private:
     SqliteOverlay::DbTab groupTab;
+    std::function<time_t ()> timeSource;
+    time_t now() const;
     void updateAllMatchGroupStates(const Category& cat) const;
     bool hasUnfinishedMandatoryPredecessor(const Match& ma) const;
     void resolveSymbolicNamesAfterFinishedMatch(const Match& ma) const;
     void updateMatchStatus(const Match& ma) const;
-    static constexpr int SymbolicIdForUnusedPlayerPairInMatch = 999999;
     
   signals:
 
@@ -19,6 +19,7 @@
 #include <ctime>
 #include <deque>
 #include <cmath>
+#include <unordered_map>
 
 #include <QDateTime>
 
@@ -30,19 +31,28 @@
 #include "CentralSignalEmitter.h"
 #include "MatchMngr.h"
 #include "CatMngr.h"
+#include "MatchDependencyGraph.h"
 
 namespace QTournament {
 
   MatchTimePredictor::MatchTimePredictor(const TournamentDB& _db)
-    :db(_db), totalMatchTime_secs(0), nMatches(0), lastMatchFinishTime(0)
+    :db(_db), durStats(_db)
   {
     resetPrediction();
+
+    connect(CentralSignalEmitter::getInstance(), SIGNAL(matchStatusChanged(int,int,ObjState,ObjState)),
+            this, SLOT(onMatchStatusChanged(int,int,ObjState,ObjState)), Qt::DirectConnection);
+    connect(CentralSignalEmitter::getInstance(), SIGNAL(categoryRemovedFromTournament(int,int)),
+            this, SLOT(onCategoryRemoved(int)), Qt::DirectConnection);
   }
 
   //----------------------------------------------------------------------------
 
   int MatchTimePredictor::getGlobalAverageMatchDuration__secs()
   {
+    const int nMatches = durStats.getTotalCount();
+    const long totalMatchTime_secs = durStats.getTotal_secs();
+
     // return pure database ("reality") values if we have a sufficiently
     // large number of real matches
     if (nMatches >= NumInitiallyAssumedMatches)
@@ -67,25 +77,25 @@ namespace QTournament {
 
   int MatchTimePredictor::getAverageMatchDurationForCat__secs(const Category& cat)
   {
-    int catId = cat.getId();
-    auto [cnt, catTime] = catId2MatchTime[catId];
+    const CatMatchDurationStats& catStats = durStats.getStatsForCat(cat.getId());
+    const int cnt = catStats.getCount();
     if (cnt < NumInitiallyAssumedMatches)
     {
       // blend with the global average if we don't have enough
       // data points in this cat
-      int avg = getGlobalAverageMatchDuration__secs();
-      catTime += (NumInitiallyAssumedMatches - cnt) * avg;
-      cnt = NumInitiallyAssumedMatches;
+      long catTime = catStats.getTotal_secs();
+      catTime += (NumInitiallyAssumedMatches - cnt) * getGlobalAverageMatchDuration__secs();
+      return catTime / NumInitiallyAssumedMatches;
     }
 
-    return catTime / cnt;
+    return catStats.getEstimate(durStats.getEstimator());
   }
 
   //----------------------------------------------------------------------------
 
-  std::vector<MatchTimePrediction> MatchTimePredictor::getMatchTimePrediction()
+  std::vector<MatchTimePrediction> MatchTimePredictor::getMatchTimePrediction(std::optional<time_t> refTime)
   {
-    updatePrediction();
+    updatePrediction(refTime);
 
     return lastPrediction;
   }
@@ -122,60 +132,7 @@ namespace QTournament {
 
   //----------------------------------------------------------------------------
 
-  void MatchTimePredictor::updateAvgMatchTimeFromDatabase()
-  {
-    // ensure that we have catId2MatchTime entry for each category
-    CatMngr cm{db};
-    for (const Category& c : cm.getAllCategories())
-    {
-      int catId = c.getId();
-      auto it = catId2MatchTime.find(catId);
-      if (it != catId2MatchTime.end()) continue;
-
-      // insert an empty element
-      std::tuple<int, long> empty = std::tuple{0, 0l};
-      catId2MatchTime[catId] = empty;
-    }
-
-    // find all matches that have been finished since the last update
-    SqliteOverlay::WhereClause wc;
-    wc.addCol(MA_FinishTime, ">", lastMatchFinishTime);
-    wc.addCol(GenericStateFieldName, static_cast<int>(ObjState::MA_Finished));
-    wc.setOrderColumn_Asc(MA_FinishTime);
-
-    MatchMngr mm{db};
-    for (SqliteOverlay::TabRowIterator it{db, TabMatch, wc}; it.hasData(); ++it)
-    {
-      const SqliteOverlay::TabRow& row = *it;
-
-      // treat all times as ints, that's easier
-
-      // check for the existence of the timestamps, because
-      // walkovers might not have one
-      auto startTime = row.getInt2(MA_StartTime);
-      if (!startTime) continue;
-
-      auto finishTime = row.getInt2(MA_FinishTime);
-      if (!finishTime) continue;
-
-      // update the accumulated match times
-      int matchDuration_secs = *finishTime - *startTime;
-      totalMatchTime_secs += matchDuration_secs;
-      auto ma = mm.getMatch(row.id());   // this is very expensive in terms of cycles and DB queries... especially since basically all information is already at hand
-      int catId = ma->getCategory().getId();
-      auto [cnt, catTime] = catId2MatchTime[catId];  // a key for this value MUST exist, see above
-      ++cnt;
-      catTime += matchDuration_secs;
-      catId2MatchTime[catId] = std::tuple{cnt, catTime};
-
-      lastMatchFinishTime = *finishTime;  // we've ordered the results by finish time, see above
-      ++nMatches;
-    }
-  }
-
-  //----------------------------------------------------------------------------
-
-  void MatchTimePredictor::updatePrediction()
+  void MatchTimePredictor::updatePrediction(std::optional<time_t> refTime)
   {
     // determine the available, not disabled courts
     CourtMngr cm{db};
@@ -191,15 +148,17 @@ namespace QTournament {
       return;
     }
 
-    // take all recently finished matches into account
-    // for the average match time
-    updateAvgMatchTimeFromDatabase();
-
     // set up a list of court numbers along with the
     // expected time when they'll be free again
     MatchMngr mm{db};
-    time_t now = time(nullptr);
+    time_t now = refTime ? *refTime : time(nullptr);
     std::vector<std::tuple<int, int>> courtFreeList;
+
+    // the estimated finish time of running and predicted
+    // matches; a match can't start before all of its
+    // unfinished predecessors are finished
+    MatchDependencyGraph deps{db};
+    std::unordered_map<int, time_t> estFinish;
     for (const Court& c : allCourts)
     {
       int coNum = c.getNumber();
@@ -230,6 +189,7 @@ namespace QTournament {
             finishTime = now + CourtIsBusyAndPredictionWrong_CorrectionOffset_secs;
           }
         }
+        estFinish[ma->getId()] = finishTime;
       }
 
       courtFreeList.push_back(std::tuple{coNum, finishTime});
@@ -275,7 +235,13 @@ namespace QTournament {
       //
       // round start and finish time to full minutes
       // to achieve synchronized / harmonized UI updates
-      time_t start = coFree + GraceTimeBetweenMatches_secs;
+      time_t earliestStart = coFree;
+      for (int predId : deps.getUnfinishedPredecessors(matchRow.id()))
+      {
+        auto itPred = estFinish.find(predId);
+        if (itPred != estFinish.end()) earliestStart = std::max(earliestStart, itPred->second);
+      }
+      time_t start = earliestStart + GraceTimeBetweenMatches_secs;
       time_t finish = start + avgMatchTime;
       start = round(start / 60.0) * 60;
       finish = round(finish / 60.0) * 60;
@@ -289,6 +255,7 @@ namespace QTournament {
 
       // store the element
       result.push_back(mtp);
+      estFinish[mtp.matchId] = finish;
 
       // virtually allocate the court until the predicted
       // match finish time
@@ -307,18 +274,39 @@ namespace QTournament {
 
   void MatchTimePredictor::resetPrediction()
   {
-    totalMatchTime_secs = 0;
-    nMatches = 0;
-    lastMatchFinishTime = 0;
     lastPrediction.clear();
-    catId2MatchTime.clear();
 
-    updateAvgMatchTimeFromDatabase();
+    durStats.reload();
     updatePrediction();  // will emit signals to reset e.g., the progess bar in the scheduler.
   }
 
   //----------------------------------------------------------------------------
 
+  void MatchTimePredictor::onMatchStatusChanged(int matchId, int, ObjState fromState, ObjState toState)
+  {
+    // MatchMngr has already updated the persisted statistics
+    // for regularly finished matches; we only need to re-read
+    // the values for the match's category
+    if ((fromState != ObjState::MA_Running) || (toState != ObjState::MA_Finished)) return;
+
+    MatchMngr mm{db};
+    auto ma = mm.getMatch(matchId);
+    if (!ma) return;
+    durStats.reloadCategory(ma->getCategory().getId());
+  }
+
+  //----------------------------------------------------------------------------
+
+  void MatchTimePredictor::onCategoryRemoved(int catId)
+  {
+    // CatMngr has already deleted the persisted statistics;
+    // re-reading them drops the category from the cache
+    durStats.reloadCategory(catId);
+    lastPrediction.clear();
+  }
+
+  //----------------------------------------------------------------------------
+
 
   //----------------------------------------------------------------------------
 
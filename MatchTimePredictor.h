@@ -20,14 +20,16 @@
 #define MATCHTIMEPREDICTOR_H
 
 #include <vector>
-#include <unordered_map>
 #include <tuple>
+#include <optional>
+#include <ctime>
 
 #include <QObject>
 
 #include <SqliteOverlay/DbTab.h>
 #include "TournamentDB.h"
 #include "Match.h"
+#include "MatchDurationStats.h"
 
 namespace QTournament
 {
@@ -46,6 +48,9 @@ namespace QTournament
     Q_OBJECT
 
   public:
+    static constexpr int GraceTimeBetweenMatches_secs = 60;
+    static constexpr int CourtIsBusyAndPredictionWrong_CorrectionOffset_secs = 5 * 60;
+
     // ctor
     MatchTimePredictor(const TournamentDB& _db);
 
@@ -53,27 +58,25 @@ namespace QTournament
     int getGlobalAverageMatchDuration__secs();
     inline int getAverageMatchDurationForCat__secs(const Match& matchInCat) { return getAverageMatchDurationForCat__secs(matchInCat.getCategory()); }
     int getAverageMatchDurationForCat__secs(const Category& cat);
-    std::vector<MatchTimePrediction> getMatchTimePrediction();
+    std::vector<MatchTimePrediction> getMatchTimePrediction(std::optional<time_t> refTime = {});
     MatchTimePrediction getPredictionForMatch(const Match& ma, bool refreshCache = false);
-    void updatePrediction();
+
+    // "refTime" replaces the wall clock as "now"; for simulations only
+    void updatePrediction(std::optional<time_t> refTime = {});
     void resetPrediction();
 
   private:
     static constexpr int DefaultMatchTime_secs = 25 * 60;  // 25 minutes
-    static constexpr int GraceTimeBetweenMatches_secs = 60;
-    static constexpr int CourtIsBusyAndPredictionWrong_CorrectionOffset_secs = 5 * 60;
     static constexpr int NumInitiallyAssumedMatches = 5;
 
     std::reference_wrapper<const QTournament::TournamentDB> db;
-    long totalMatchTime_secs;
-    int nMatches;
-    time_t lastMatchFinishTime;
-
-    std::unordered_map<int, std::tuple<int, long>> catId2MatchTime;
+    MatchDurationStats durStats;
 
     std::vector<MatchTimePrediction> lastPrediction;
 
-    void updateAvgMatchTimeFromDatabase();
+  private slots:
+    void onMatchStatusChanged(int matchId, int matchSeqNum, ObjState fromState, ObjState toState);
+    void onCategoryRemoved(int catId);
   };
 
 }
@@ -0,0 +1,208 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2019  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OBJECTHANDLE_H
+#define OBJECTHANDLE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "TournamentDataDefs.h"
+
+namespace QTournament
+{
+  class TournamentDB;
+  class Match;
+  class Player;
+  class PlayerPair;
+
+  /** \brief The table behind a handle type
+   *
+   * There is exactly one descriptor per type, so handles don't have
+   * to carry a table name or a database reference.
+   */
+  template<class T>
+  struct HandleTraits;
+
+  template<>
+  struct HandleTraits<Match>
+  {
+    static constexpr const char* TableName = TabMatch;
+  };
+
+  template<>
+  struct HandleTraits<Player>
+  {
+    static constexpr const char* TableName = TabPlayer;
+  };
+
+  template<>
+  struct HandleTraits<PlayerPair>
+  {
+    static constexpr const char* TableName = TabPairs;
+  };
+
+  //----------------------------------------------------------------------------
+
+  /** \brief A lightweight reference to a database object, essentially just its ID
+   *
+   * In contrast to the database objects themselves, handles don't allocate
+   * anything. They can be resolved into the full object when needed.
+   */
+  template<class T>
+  class ObjectHandle
+  {
+  public:
+    constexpr explicit ObjectHandle(int _id)
+      :objId{_id} {}
+
+    constexpr int id() const { return objId; }
+
+    static constexpr const char* tableName() { return HandleTraits<T>::TableName; }
+
+    /** \returns the full database object; the object's row is not checked
+     */
+    T get(const TournamentDB& db) const { return T{db, objId}; }
+
+    constexpr bool operator==(const ObjectHandle<T>& other) const { return (objId == other.objId); }
+    constexpr bool operator!=(const ObjectHandle<T>& other) const { return (objId != other.objId); }
+    constexpr bool operator<(const ObjectHandle<T>& other) const { return (objId < other.objId); }
+
+  private:
+    int objId;
+  };
+
+  using MatchHandle = ObjectHandle<Match>;
+  using PlayerHandle = ObjectHandle<Player>;
+  using PlayerPairHandle = ObjectHandle<PlayerPair>;
+
+  //----------------------------------------------------------------------------
+
+  /** \brief A non-owning view on a contiguous sequence of handles
+   */
+  template<class T>
+  class HandleSpan
+  {
+  public:
+    using const_iterator = const ObjectHandle<T>*;
+
+    constexpr HandleSpan() = default;
+    constexpr HandleSpan(const ObjectHandle<T>* _first, size_t _n)
+      :first{_first}, n{_n} {}
+
+    constexpr const_iterator begin() const { return first; }
+    constexpr const_iterator end() const { return first + n; }
+    constexpr size_t size() const { return n; }
+    constexpr bool empty() const { return (n == 0); }
+    constexpr const ObjectHandle<T>& operator[](size_t idx) const { return first[idx]; }
+
+    /** \returns a part of this span; the range is clipped to the span's size
+     */
+    constexpr HandleSpan<T> subspan(size_t offset, size_t count) const
+    {
+      if (offset >= n) return HandleSpan<T>{};
+      return HandleSpan<T>{first + offset, (count < (n - offset)) ? count : (n - offset)};
+    }
+
+  private:
+    const ObjectHandle<T>* first{nullptr};
+    size_t n{0};
+  };
+
+  //----------------------------------------------------------------------------
+
+  /** \brief An owning list of handles that can be moved but not copied
+   *
+   * Functions that need to pass the list on without taking ownership
+   * should use HandleSpan.
+   */
+  template<class T>
+  class HandleList
+  {
+  public:
+    using const_iterator = typename std::vector<ObjectHandle<T>>::const_iterator;
+
+    HandleList() = default;
+    HandleList(const HandleList<T>&) = delete;
+    HandleList<T>& operator=(const HandleList<T>&) = delete;
+    HandleList(HandleList<T>&&) = default;
+    HandleList<T>& operator=(HandleList<T>&&) = default;
+
+    void reserve(size_t n) { handles.reserve(n); }
+    void push_back(const ObjectHandle<T>& h) { handles.push_back(h); }
+    void emplace_back(int id) { handles.emplace_back(id); }
+    void clear() { handles.clear(); }
+
+    const_iterator begin() const { return handles.cbegin(); }
+    const_iterator end() const { return handles.cend(); }
+    size_t size() const { return handles.size(); }
+    bool empty() const { return handles.empty(); }
+    const ObjectHandle<T>& operator[](size_t idx) const { return handles[idx]; }
+
+    HandleSpan<T> span() const { return HandleSpan<T>{handles.data(), handles.size()}; }
+    operator HandleSpan<T>() const { return span(); }
+
+    /** \brief Sorts the handles by a precomputed key per handle; the
+     * keys are in the same order as the handles
+     */
+    template<class Key>
+    void sortByKeys(std::vector<Key>&& keys);
+
+  private:
+    std::vector<ObjectHandle<T>> handles;
+  };
+
+  using MatchHandleList = HandleList<Match>;
+  using PlayerHandleList = HandleList<Player>;
+  using PlayerPairHandleList = HandleList<PlayerPair>;
+
+  //----------------------------------------------------------------------------
+
+  /** \returns the full database objects for a span of handles, e.g., for the
+   * currently visible part of a list
+   */
+  template<class T>
+  std::vector<T> resolveHandles(const TournamentDB& db, HandleSpan<T> handles)
+  {
+    std::vector<T> result;
+    result.reserve(handles.size());
+    for (const ObjectHandle<T>& h : handles) result.push_back(h.get(db));
+
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+  template<class T>
+  template<class Key>
+  void HandleList<T>::sortByKeys(std::vector<Key>&& keys)
+  {
+    std::vector<size_t> idx(handles.size());
+    for (size_t i = 0; i < idx.size(); ++i) idx[i] = i;
+    std::stable_sort(idx.begin(), idx.end(), [&keys](size_t i1, size_t i2) { return (keys[i1] < keys[i2]); });
+
+    std::vector<ObjectHandle<T>> sorted;
+    sorted.reserve(handles.size());
+    for (size_t i : idx) sorted.push_back(handles[i]);
+    handles = std::move(sorted);
+  }
+
+}
+
+#endif // OBJECTHANDLE_H
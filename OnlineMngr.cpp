@@ -1,5 +1,6 @@
 #include <iostream>
 #include <chrono>
+#include <stdexcept>
 
 #include <Sloppy/json.hpp>
 #include <Sloppy/Crypto/Crypto.h>
@@ -9,13 +10,9 @@
 #include "TournamentDB.h"
 #include "OnlineMngr.h"
 #include "HttpClient.h"
-#include "TeamMngr.h"
-#include "CourtMngr.h"
-#include "CatMngr.h"
-#include "MatchMngr.h"
-#include "PlayerMngr.h"
-#include "RankingMngr.h"
+#include "SyncString.h"
 #include "HelperFunc.h"
+#include "BackgroundReader.h"
 
 using namespace std;
 
@@ -72,6 +69,7 @@ namespace QTournament
     HttpResponse re = cli.blockingRequest(url, hdr, body, defaultTimeout_ms);
     auto _elapsedTime = chrono::high_resolution_clock::now() - startTime;
     lastReqTime_ms = chrono::duration_cast<chrono::milliseconds>(_elapsedTime).count();
+    lastRespCode = re.respCode;
 
     // did we get a response?
     if (re.respCode < 0) return OnlineError::Timeout;
@@ -295,12 +293,23 @@ namespace QTournament
     }
 
     // force a full sync at session start
+    //
+    // the full sync works on a snapshot of the database while
+    // the user may continue to work, so we need to enable the
+    // database changelog before the snapshot is taken. If the
+    // sync fails, the changelog is disabled again.
+    pendingChanges.clear();
+    db.get().enableChangeLog(true);
     err = doFullSync(errCodeOut);
 
-    // if the sync was successfull,
-    // enable the database changelog,
-    // otherwise terminate the session
-    if (err != OnlineError::Okay) return err;
+    // if the sync was not successfull,
+    // terminate the session
+    if (err != OnlineError::Okay)
+    {
+      db.get().disableChangeLog(true);
+      pendingChanges.clear();
+      return err;
+    }
 
     if (errCodeOut != "OK")
     {
@@ -308,7 +317,6 @@ namespace QTournament
       return OnlineError::TransportOkay_AppError;
     }
 
-    db.get().enableChangeLog(true);
     return OnlineError::Okay;
   }
 
@@ -331,6 +339,9 @@ namespace QTournament
     QByteArray response;
     OnlineError err = execSignedServerRequest("/terminateSession", true, QByteArray{}, response);
     db.get().disableChangeLog(true);
+    pendingChanges.clear();
+    syncShadow.clear();
+    serverHasDeltaSync = true;
     syncState = SyncState{};  // reset all clocks, session keys, etc.
 
     //cout << "Terminate Session, server said: " << response.constData() << endl;
@@ -419,37 +430,9 @@ namespace QTournament
       return OnlineError::NoSession;
     }
 
-    //
-    // collect all CSV-data
-    //
-    string csv;
-
-    // courts
-    CourtMngr cm{db};
-    csv += cm.getSyncString({});
-
-    // Teams
-    TeamMngr tm{db};
-    csv += tm.getSyncString({});
-
-    // players
-    PlayerMngr pm{db};
-    csv += pm.getSyncString({});
-    csv += pm.getSyncString_P2C({});
-    csv += pm.getSyncString_Pairs({});
-
-    // categories
-    CatMngr caMngr{db};
-    csv += caMngr.getSyncString({});
-
-    // matches
-    MatchMngr mm{db};
-    csv += mm.getSyncString({});
-    csv += mm.getSyncString_MatchGroups({});
-
-    // rankings
-    RankingMngr rm{db};
-    csv += rm.getSyncString({});
+    // collect all CSV-data in the background; the
+    // GUI remains usable in the meantime
+    const string csv = runOnSnapshot<string>(db, &getFullSyncString);
 
     //cout << csv << endl;
 
@@ -462,6 +445,19 @@ namespace QTournament
     errCodeOut = QString::fromUtf8(response.constData());
     if (errCodeOut == "OK0")
     {
+      // this is what the server knows now
+      syncShadow.clear();
+      try
+      {
+        syncShadow.apply(csv);
+      }
+      catch (std::exception& ex)
+      {
+        cerr << "Invalid full sync string, delta syncs disabled: " << ex.what() << endl;
+        syncShadow.clear();
+        serverHasDeltaSync = false;
+      }
+
       UTCTimestamp now;
       syncState.lastFullSync = now;
       syncState.lastPartialSync  = now;
@@ -481,8 +477,12 @@ namespace QTournament
   {
     if (!(syncState.hasSession())) return false;
 
-    size_t logLen = db.get().getChangeLogLength();
-    if (logLen == 0) return false;
+    // repeated edits of the same row don't increase the number
+    // of pending changes, so we use the number of edits for
+    // detecting database activity
+    absorbDatabaseChangeLog();
+    if (pendingChanges.empty()) return false;
+    size_t logLen = pendingChanges.getEditCount();
 
     // check the "inactivity hystersis"
     UTCTimestamp now;
@@ -526,19 +526,61 @@ namespace QTournament
     // sorry...
     auto trans = db.get().startTransaction(SqliteOverlay::TransactionType::Exclusive);
 
-    // get all recent database changes
-    auto log = db.get().getAllChangesAndClearQueue();
-    if (log.empty()) return OnlineError::Okay;
-
-    // remove unnecessary, redundant entries from the log
-    compactDatabaseChangeLog(log);
+    // get all changes since the last successful sync; they remain
+    // in the store until the server has confirmed the sync
+    absorbDatabaseChangeLog();
+    auto log = pendingChanges.getCompactedLog();
+    if (log.empty())
+    {
+      pendingChanges.clear();
+      return OnlineError::Okay;
+    }
 
     // get the CSV update string
-    string csv = log2SyncString(log);
+    string csv = getSyncStringForChanges(db, log);
 
-    // trigger the update
+    // most changes only affect one or two columns of a row,
+    // so we only send these columns if the server supports it
     QByteArray response;
-    OnlineError err = execSignedServerRequest("/partialSync", true, QByteArray(csv.c_str()), response);
+    OnlineError err{OnlineError::BadRequest};
+    if (serverHasDeltaSync)
+    {
+      string delta;
+      try
+      {
+        delta = syncShadow.encodeDelta(csv);
+      }
+      catch (std::exception& ex)
+      {
+        cerr << "Delta encoding failed, falling back to complete rows: " << ex.what() << endl;
+        serverHasDeltaSync = false;
+      }
+
+      // maybe all changes have been reverted in the meantime
+      if (serverHasDeltaSync && delta.empty())
+      {
+        pendingChanges.clear();
+        syncState.lastPartialSync = UTCTimestamp{};
+        return OnlineError::Okay;
+      }
+
+      if (serverHasDeltaSync)
+      {
+        err = execSignedServerRequest("/partialDeltaSync", true, QByteArray(delta.c_str()), response);
+
+        // older servers don't know the delta endpoint; other
+        // errors (e.g., a temporarily unavailable server) are
+        // no reason to give up delta syncs for the whole session
+        if ((err == OnlineError::BadRequest) && ((lastRespCode == 404) || (lastRespCode == 405)))
+        {
+          serverHasDeltaSync = false;
+        }
+      }
+    }
+    if (!serverHasDeltaSync)
+    {
+      err = execSignedServerRequest("/partialSync", true, QByteArray(csv.c_str()), response);
+    }
     if (err != OnlineError::Okay) return err;
 
     errCodeOut = QString::fromUtf8(response.constData());
@@ -554,6 +596,9 @@ namespace QTournament
 
       errCodeOut = "OK";
 
+      pendingChanges.clear();
+      if (serverHasDeltaSync) syncShadow.apply(csv);
+
       UTCTimestamp now;
       syncState.lastPartialSync  = now;
       ++syncState.partialSyncCounter;
@@ -579,6 +624,14 @@ namespace QTournament
 
   //----------------------------------------------------------------------------
 
+  size_t OnlineMngr::getPendingChangeCount()
+  {
+    absorbDatabaseChangeLog();
+    return pendingChanges.size();
+  }
+
+  //----------------------------------------------------------------------------
+
   QString OnlineMngr::getCustomUrl()
   {
     if (cfgTab.hasKey(CfgKey_CustomServer))
@@ -745,174 +798,12 @@ namespace QTournament
 
   //----------------------------------------------------------------------------
 
-  void OnlineMngr::compactDatabaseChangeLog(vector<SqliteOverlay::ChangeLogEntry>& log)
-  {
-    size_t oldLen = log.size();
-
-    // step one:
-    // search from the end of the list if there are any prior
-    // updates for the same row. If yes, remove the prior update
-    // because we'll always transmit the whole row
-    size_t outerIdx = log.size();
-    while (outerIdx > 0)
-    {
-      --outerIdx;
-
-      const SqliteOverlay::ChangeLogEntry cle = log[outerIdx];  // do NOT use references here, because content gets shifted in memory when deleted
-      if (cle.action != SqliteOverlay::RowChangeAction::Update) continue;
-
-      size_t innerIdx = outerIdx;
-      while (innerIdx != 0)
-      {
-        --innerIdx;
-        const SqliteOverlay::ChangeLogEntry& inner = log.at(innerIdx);
-        if ((inner.rowId == cle.rowId) &&
-            (inner.action == SqliteOverlay::RowChangeAction::Update) &&
-            (inner.tabName == cle.tabName))
-        {
-          log.erase(log.begin() + innerIdx);
-
-          // now innerIdx points to the element after the deleted
-          // element but since we're doing a "--" in the loop's head
-          // that's fine
-
-          // but we have to adjust the value of the outerIdx!
-          --outerIdx;
-        }
-      }
-    }
-
-    // step two:
-    // if there is an deletion, remove prior insertions or updates of the same row
-    outerIdx = log.size();
-    while (outerIdx > 0)
-    {
-      --outerIdx;
-
-      const SqliteOverlay::ChangeLogEntry cle = log[outerIdx];  // do NOT use references here, because content gets shifted in memory when deleted
-      if (cle.action != SqliteOverlay::RowChangeAction::Delete) continue;
-
-      bool foundInsert = false;
-      size_t innerIdx = outerIdx;
-      while (innerIdx != 0)
-      {
-        --innerIdx;
-        const SqliteOverlay::ChangeLogEntry& inner = log.at(innerIdx);
-        if ((inner.rowId == cle.rowId) && (inner.tabName == cle.tabName))
-        {
-          foundInsert = (inner.action == SqliteOverlay::RowChangeAction::Insert);
-
-          log.erase(log.begin() + innerIdx);
-
-          // now innerIdx points to the element after the deleted
-          // element but since we're doing a "--" in the loop's head
-          // that's fine
-
-          // but we have to adjust the value of the outerIdx!
-          --outerIdx;
-
-          // there is no need to go back before the first insert
-          if (foundInsert) break;
-        }
-      }
-
-      // if we found and deleted the insert, we can also delete
-      // the deletion
-      if (foundInsert) log.erase(log.begin() + outerIdx);
-    }
-
-    cerr << "Log compacter could delete " << (oldLen - log.size()) << " entries!" << endl;
-  }
-
-  //----------------------------------------------------------------------------
-
-  string OnlineMngr::log2SyncString(const SqliteOverlay::ChangeLogList& log)
+  void OnlineMngr::absorbDatabaseChangeLog()
   {
-    // copy the log
-    SqliteOverlay::ChangeLogList cll = log;
-
-    // sort copied entries by table name
-    std::stable_sort(cll.begin(), cll.end(), [](const SqliteOverlay::ChangeLogEntry& e1, const SqliteOverlay::ChangeLogEntry& e2)
-    {
-      return (e1.tabName < e2.tabName);
-    });
-
-    // append a dummy entry at the end that triggers
-    // a bogus tablename change in the following algorithm.
-    // the dummy entry never makes it to the result string
-    cll.push_back(SqliteOverlay::ChangeLogEntry{SqliteOverlay::RowChangeAction::Delete, "xxx", "___", 42});
-
-    string result;
-    string curTabName;
-    std::vector<int> idxList;
-    for (auto it = cll.begin(); it != cll.end(); ++it)
-    {
-      const auto& cle = *it;
-
-      if (cle.tabName != curTabName)
-      {
-        if (!(idxList.empty()))
-        {
-          if (curTabName == TabCourt)
-          {
-            CourtMngr mngr{db};
-            result += mngr.getSyncString(idxList);
-          }
-          if (curTabName == TabTeam)
-          {
-            TeamMngr mngr{db};
-            result += mngr.getSyncString(idxList);
-          }
-          if (curTabName == TabPlayer)
-          {
-            PlayerMngr mngr{db};
-            result += mngr.getSyncString(idxList);
-          }
-          if (curTabName == TabP2C)
-          {
-            PlayerMngr mngr{db};
-            result += mngr.getSyncString_P2C(idxList);
-          }
-          if (curTabName == TabPairs)
-          {
-            PlayerMngr mngr{db};
-            result += mngr.getSyncString_Pairs(idxList);
-          }
-          if (curTabName == TabCategory)
-          {
-            CatMngr mngr{db};
-            result += mngr.getSyncString(idxList);
-          }
-          if (curTabName == TabMatch)
-          {
-            MatchMngr mngr{db};
-            result += mngr.getSyncString(idxList);
-          }
-          if (curTabName == TabMatchGroup)
-          {
-            MatchMngr mngr{db};
-            result += mngr.getSyncString_MatchGroups(idxList);
-          }
-          if (curTabName == TabMatchSystem)
-          {
-            RankingMngr mngr{db};
-            result += mngr.getSyncString(idxList);
-          }
-        }
-
-        curTabName = cle.tabName;
-        idxList.clear();
-      }
-
-      if (cle.action == SqliteOverlay::RowChangeAction::Delete)
-      {
-        idxList.push_back(- cle.rowId);  // negative ID ==> deletion
-      } else {
-        idxList.push_back(cle.rowId);
-      }
-    }
-
-    return result;
+    // move the changes from SQLite's in-memory queue into
+    // the compacting store so that the queue stays short even
+    // if we can't reach the server for hours
+    pendingChanges.add(db.get().getAllChangesAndClearQueue());
   }
 
   //----------------------------------------------------------------------------
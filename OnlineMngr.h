@@ -11,11 +11,8 @@
 
 #include <SqliteOverlay/KeyValueTab.h>
 
-// forward
-namespace SqliteOverlay
-{
-  class ChangeLogEntry;
-}
+#include "ChangeLogStore.h"
+#include "SyncShadow.h"
 
 
 namespace QTournament
@@ -151,6 +148,10 @@ namespace QTournament
     // status info for the GUI
     SyncState getSyncState() const;
 
+    /** \returns the number of changed rows that still need to be sent to the server
+     */
+    size_t getPendingChangeCount();
+
     int getLastReqTime_ms() const { return lastReqTime_ms; }
 
     // custom connection settings
@@ -164,8 +165,7 @@ namespace QTournament
 
   protected:
     bool initKeyboxWithFreshKeys(const QString& pw);
-    void compactDatabaseChangeLog(std::vector<SqliteOverlay::ChangeLogEntry>& log);
-    std::string log2SyncString(const SqliteOverlay::ChangeLogList& log);
+    void absorbDatabaseChangeLog();
 
   private:
     std::reference_wrapper<QTournament::TournamentDB> db;
@@ -179,6 +179,10 @@ namespace QTournament
     PubSignKey srvPubKey;
     SyncState syncState;
     int lastReqTime_ms;
+    int lastRespCode{-1};   ///< HTTP status code of the last request; -1 if there was no response
+    ChangeLogStore pendingChanges;   ///< compacted changes since the last successful sync
+    SyncShadow syncShadow;   ///< the server's data for delta-encoded partial syncs
+    bool serverHasDeltaSync{true};   ///< `false` if the server rejected delta-encoded syncs in this session
   };
 
 }
@@ -157,6 +157,21 @@ namespace QTournament
     return getAllObjects<Player>();
   }
 
+//----------------------------------------------------------------------------
+
+  PlayerHandleList PlayerMngr::getAllPlayerHandles() const
+  {
+    auto stmt = db.prepStatement("SELECT id FROM " TabPlayer " ORDER BY id ASC");
+
+    PlayerHandleList result;
+    for (stmt.step(); stmt.hasData(); stmt.step())
+    {
+      result.emplace_back(stmt.getInt(0));
+    }
+
+    return result;
+  }
+
 //----------------------------------------------------------------------------
 
   Error PlayerMngr::renamePlayer(const Player& p, const QString& nf, const QString& nl)
@@ -924,45 +939,16 @@ namespace QTournament
 
   std::vector<Match> PlayerMngr::getAllScheduledMatchesForPlayer(const Player &p, bool findFirstOnly)
   {
-    // find all player pairs for the requested player
-    Sloppy::estring pairWhere = std::string{Pairs_Player1Ref} + "=%1 or " + std::string{Pairs_Player2Ref} + "=%1";
-    pairWhere.arg(p.getId());
-    DbTab pairTab{db, TabPairs, false};
-    const auto allPairRows = pairTab.getRowsByWhereClause(pairWhere);
+    // a single, pre-compiled query for all matches that reference
+    // any of the player's pairs
+    auto stmt = db.getStatementCache().get(CachedQuery::ScheduledMatchesForPlayer);
+    stmt.bind(1, p.getId());
 
-    if (allPairRows.empty()) return {};
-
-    // build a giant SQL request for all matches that reference
-    // any of the pairs we found
-    static const Sloppy::estring baseWhere{
-      std::string{MA_Num} + ">0 AND " +
-      std::string{GenericStateFieldName} + "!=" + std::to_string(static_cast<int>(ObjState::MA_Running)) + " AND " +
-      std::string{GenericStateFieldName} + "!=" + std::to_string(static_cast<int>(ObjState::MA_Finished)) + " AND ("
-    };
-    static const Sloppy::estring orFragment{
-      std::string{MA_Pair1Ref} + "=%1 OR " + std::string{MA_Pair2Ref} + "=%1 OR "
-    };
-
-    Sloppy::estring where{baseWhere};
-    for (const auto& pairRow : allPairRows)
-    {
-      Sloppy::estring orClause{orFragment};
-      orClause.arg(pairRow.id());
-      where += orClause;
-    }
-    where.chopRight(3);  // the last "OR"
-    where += ") ORDER BY " + std::string{MA_Num} + " ASC";
-    if (findFirstOnly)
-    {
-      where += " LIMIT 1";
-    }
-
-    DbTab matchTab{db, TabMatch, false};
-    const auto allMatchRows = matchTab.getRowsByWhereClause(where);
     std::vector<Match> result;
-    for (const auto& pairRow : allMatchRows)
+    while (stmt.step())
     {
-      result.push_back(Match{db, pairRow});
+      result.push_back(Match{db, stmt.getInt(0)});
+      if (findFirstOnly) break;
     }
 
     return result;
@@ -35,6 +35,7 @@
 #include "TournamentDatabaseObjectManager.h"
 #include "Match.h"
 #include "ExternalPlayerDB.h"
+#include "ObjectHandle.h"
 
 
 namespace QTournament
@@ -55,6 +56,9 @@ namespace QTournament
     bool hasPlayer (const QString& firstName, const QString& lastName);
     Player getPlayer(const QString& firstName, const QString& lastName);
     std::vector<Player> getAllPlayers();
+
+    /** \returns the handles of all players in ID order; one query, no objects */
+    PlayerHandleList getAllPlayerHandles() const;
     std::optional<Player> getPlayerBySeqNum(int seqNum);
     bool hasPlayer(int id);
     Player getPlayer(int id);
@@ -16,6 +16,7 @@
  *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <limits>
 #include <vector>
 
 #include "PlayerProfile.h"
@@ -93,8 +94,9 @@ namespace QTournament
     // the currently running match and the last finished match
     QDateTime lastFinishTime;
     int nextMatchNum = -1;
-    for (const Match& ma : matchesAsUmpire)
+    for (const MatchHandle& h : matchesAsUmpire)
     {
+      const Match ma = h.get(db);
       ObjState stat = ma.getState();
 
       if (stat == ObjState::MA_Finished) ++umpireFinishedCount;
@@ -132,8 +134,9 @@ namespace QTournament
     // the currently running match and the last finished match
     lastFinishTime = QDateTime{};   // set to "invalid"
     nextMatchNum = -1;
-    for (const Match& ma : matchesAsPlayer)
+    for (const MatchHandle& h : matchesAsPlayer)
     {
+      const Match ma = h.get(db);
       ObjState stat = ma.getState();
       int maNum = ma.getMatchNumber();
 
@@ -180,81 +183,42 @@ namespace QTournament
     // find all matches involving the participant as a PLAYER
     //
 
-    // step 1: search via PlayerPairs
-    QString where = "%1=%2 OR %3=%2";
-    where = where.arg(Pairs_Player1Ref);
-    where = where.arg(p.getId());
-    where = where.arg(Pairs_Player2Ref);
-    DbTab pairsTab{db, TabPairs, false};
-    auto rows = pairsTab.getRowsByWhereClause(where.toUtf8().constData());
-    std::vector<int> matchIdList;
-
-    DbTab matchTab{db, TabMatch, false};
-    MatchMngr mm{db};
-    for (const auto& r : rows)
-    {
-      int ppId = r.id();
-
-      // search for all matches involving this player pair
-      where = "%1=%2 OR %3=%2";
-      where = where.arg(MA_Pair1Ref);
-      where = where.arg(ppId);
-      where = where.arg(MA_Pair2Ref);
-      auto matchRows = matchTab.getRowsByWhereClause(where.toUtf8().constData());
-      for (const auto& matchRow : matchRows)
-      {
-        int maId = matchRow.id();
-        if (!(Sloppy::isInVector<int>(matchIdList, maId))) matchIdList.push_back(maId);
-      }
-    }
-
-    // step 2: search via ACTUAL_PLAYER
-    where = "%1=%2 OR %3=%2 OR %4=%2 OR %5=%2";
-    where = where.arg(MA_ActualPlayer1aRef);
-    where = where.arg(p.getId());
-    where = where.arg(MA_ActualPlayer1bRef);
-    where = where.arg(MA_ActualPlayer2aRef);
-    where = where.arg(MA_ActualPlayer2bRef);
-    auto matchRows = matchTab.getRowsByWhereClause(where.toUtf8().constData());
-    for (const auto& matchRow : matchRows)
-    {
-      int maId = matchRow.id();
-      if (!(Sloppy::isInVector<int>(matchIdList, maId))) matchIdList.push_back(maId);
-    }
-
-    // copy the results to the matchesAsPlayer-list
-    for (int maId : matchIdList)
+    // search via PlayerPairs and via ACTUAL_PLAYER
+    // in one pre-compiled query that also returns
+    // the match numbers; no match objects are created here
+    std::vector<int> sortKeys;
+    auto stmt = db.get().getStatementCache().get(CachedQuery::MatchesForPlayer);
+    stmt.bind(1, p.getId());
+    while (stmt.step())
     {
-      auto ma = mm.getMatch(maId);
-      matchesAsPlayer.push_back(*ma);
+      matchesAsPlayer.emplace_back(stmt.getInt(0));
+      sortKeys.push_back(matchNumToSortKey(stmt.getInt(1)));
     }
-
-    // sort by match number
-    std::sort(matchesAsPlayer.begin(), matchesAsPlayer.end(), [](const Match& ma1, const Match& ma2)
-    {
-      return ma1.getMatchNumber() < ma2.getMatchNumber();
-    });
+    matchesAsPlayer.sortByKeys(std::move(sortKeys));
 
 
     //
     // find all matches involving the participant as an UMPIRE
     //
-    matchIdList.clear();
-    matchRows = matchTab.getRowsByColumnValue(MA_RefereeRef, p.getId());
-    for (const auto& matchRow : matchRows)
+    sortKeys.clear();
+    auto umpireStmt = db.get().prepStatement("SELECT id, IFNULL(" MA_Num ", ?2) FROM " TabMatch " WHERE " MA_RefereeRef " = ?1");
+    umpireStmt.bind(1, p.getId());
+    umpireStmt.bind(2, MatchNumNotAssigned);
+    for (umpireStmt.step(); umpireStmt.hasData(); umpireStmt.step())
     {
-      int maId = matchRow.id();
-
-      auto ma = mm.getMatch(maId);
-      matchesAsUmpire.push_back(*ma);
+      matchesAsUmpire.emplace_back(umpireStmt.getInt(0));
+      sortKeys.push_back(matchNumToSortKey(umpireStmt.getInt(1)));
     }
+    matchesAsUmpire.sortByKeys(std::move(sortKeys));
 
-    // sort by match number
-    std::sort(matchesAsUmpire.begin(), matchesAsUmpire.end(), [](const Match& ma1, const Match& ma2)
-    {
-      return ma1.getMatchNumber() < ma2.getMatchNumber();
-    });
+  }
+
+  //----------------------------------------------------------------------------
 
+  int PlayerProfile::matchNumToSortKey(int maNum)
+  {
+    // not yet scheduled matches go to the end of the list
+    return (maNum == MatchNumNotAssigned) ? std::numeric_limits<int>::max() : maNum;
   }
 
   //----------------------------------------------------------------------------
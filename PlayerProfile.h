@@ -25,6 +25,7 @@
 
 #include "TournamentDB.h"
 #include "Match.h"
+#include "ObjectHandle.h"
 
 namespace QTournament
 {
@@ -43,18 +44,27 @@ namespace QTournament
     std::optional<Match> getCurrentUmpireMatch() const;
     std::optional<Match> getNextUmpireMatch() const;
 
-    QList<Match> getMatchesAsPlayer() const { return matchesAsPlayer; }
-    QList<Match> getMatchesAsUmpire() const { return matchesAsUmpire; }
+    /** \returns the handles of all matches of the player, sorted by match number
+     * with the not yet scheduled matches at the end; the span is valid as long as
+     * the profile exists
+     */
+    HandleSpan<Match> getMatchesAsPlayer() const { return matchesAsPlayer.span(); }
+
+    /** \returns the handles of all matches with the player as umpire, sorted by match number
+     * with the not yet scheduled matches at the end; the span is valid as long as
+     * the profile exists
+     */
+    HandleSpan<Match> getMatchesAsUmpire() const { return matchesAsUmpire.span(); }
 
     int getWalkoverCount() const { return walkoverCount; }
     int getFinishCount() const { return finishCount; }  // includes walkovers
     int getActuallyPlayedCount() const { return (finishCount - walkoverCount); }
     int getScheduledMatchesCount() const { return scheduledCount; }
-    int getYetToBePlayedCount() const { return (matchesAsPlayer.length() - finishCount); }
+    int getYetToBePlayedCount() const { return (static_cast<int>(matchesAsPlayer.size()) - finishCount); }
     int getScheduledAndNotFinishedCount() const { return (scheduledCount - finishCount); }
-    int getOthersCount() const { return (matchesAsPlayer.length() - scheduledCount); }
+    int getOthersCount() const { return (static_cast<int>(matchesAsPlayer.size()) - scheduledCount); }
     int getUmpireFinishedCount() const { return umpireFinishedCount; }
-    int getUmpireScheduledAndNotFinishedCount() const { return (matchesAsUmpire.length() - umpireFinishedCount); }
+    int getUmpireScheduledAndNotFinishedCount() const { return (static_cast<int>(matchesAsUmpire.size()) - umpireFinishedCount); }
 
   protected:
     std::reference_wrapper<const QTournament::TournamentDB> db;
@@ -71,13 +81,14 @@ namespace QTournament
     int scheduledCount;
     int umpireFinishedCount;
 
-    QList<Match> matchesAsPlayer;
-    QList<Match> matchesAsUmpire;
+    MatchHandleList matchesAsPlayer;
+    MatchHandleList matchesAsUmpire;
 
     void initMatchIds();
     void initMatchLists();
 
     std::optional<Match> returnMatchOrEmpty(int maId) const;
+    static int matchNumToSortKey(int maNum);
   };
 
 }
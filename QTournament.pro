@@ -78,6 +78,7 @@ HEADERS += \
     Court.h \
     CourtMngr.h \
     models/CourtTabModel.h \
+    models/MatchLogTableModel.h \
     ui/CourtTableView.h \
     Score.h \
     ui/delegates/CourtItemDelegate.h \
@@ -134,6 +135,8 @@ HEADERS += \
     ui/TeamTableView.h \
     ui/delegates/CatTabPlayerItemDelegate.h \
     MatchTimePredictor.h \
+    MatchDurationStats.h \
+    SchedulePlanner.h \
     ui/TournamentProgressBar.h \
     ui/MatchLogTabWidget.h \
     ui/CommonMatchTableWidget.h \
@@ -145,7 +148,18 @@ HEADERS += \
     ui/AutoSizingTable.h \
     ui/delegates/BaseItemDelegate.h \
     SwissLadderGenerator.h \
+    SwissLadderState.h \
+    StatementCache.h \
+    BackgroundReader.h \
+    BackgroundBackup.h \
+    ChangeLogStore.h \
+    SyncShadow.h \
+    SyncString.h \
     CSVImporter.h \
+    MatchDependencyGraph.h \
+    BracketStateCache.h \
+    RefereeAssigner.h \
+    ObjectHandle.h \
     ui/DlgImportCSV_Step1.h \
     ui/DlgImportCSV_Step2.h \
     ui/DlgPickTeam.h \
@@ -217,6 +231,7 @@ SOURCES += \
     Court.cpp \
     CourtMngr.cpp \
     models/CourtTabModel.cpp \
+    models/MatchLogTableModel.cpp \
     ui/CourtTableView.cpp \
     Score.cpp \
     ui/delegates/CourtItemDelegate.cpp \
@@ -273,6 +288,8 @@ SOURCES += \
     ui/TeamTableView.cpp \
     ui/delegates/CatTabPlayerItemDelegate.cpp \
     MatchTimePredictor.cpp \
+    MatchDurationStats.cpp \
+    SchedulePlanner.cpp \
     ui/TournamentProgressBar.cpp \
     ui/MatchLogTabWidget.cpp \
     ui/CommonMatchTableWidget.cpp \
@@ -284,7 +301,16 @@ SOURCES += \
     ui/AutoSizingTable.cpp \
     ui/delegates/BaseItemDelegate.cpp \
     SwissLadderGenerator.cpp \
+    SwissLadderState.cpp \
+    StatementCache.cpp \
     CSVImporter.cpp \
+    MatchDependencyGraph.cpp \
+    BracketStateCache.cpp \
+    RefereeAssigner.cpp \
+    BackgroundBackup.cpp \
+    ChangeLogStore.cpp \
+    SyncShadow.cpp \
+    SyncString.cpp \
     ui/DlgImportCSV_Step1.cpp \
     ui/DlgImportCSV_Step2.cpp \
     ui/DlgPickTeam.cpp \
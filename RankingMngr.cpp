@@ -18,6 +18,8 @@
 
 #include <stdexcept>
 #include <algorithm>
+#include <array>
+#include <unordered_map>
 
 #include <SqliteOverlay/Transaction.h>
 #include <QDebug>
@@ -62,153 +64,195 @@ namespace QTournament
       ppList = _ppList;
     }
 
+    const int catId = cat.getId();
+
+    // fetch all matches of the round along with their
+    // group number and result in one go
+    struct RoundMatch
+    {
+      int pair1Id;
+      int grpNum;
+      std::optional<MatchScore> score;
+      Error scoreErr;
+    };
+    std::unordered_map<int, RoundMatch> matchByPair;
+    auto maStmt = db.prepStatement("SELECT IFNULL(m." MA_Pair1Ref ", -1), IFNULL(m." MA_Pair2Ref ", -1), g." MG_GrpNum ","
+                                   " IFNULL(m." MA_PackedResult ", -1), IFNULL(m." MA_Result ", '') FROM " TabMatch " m JOIN " TabMatchGroup " g"
+                                   " ON m." MA_GrpRef " = g.id WHERE g." MG_CatRef " = ?1 AND g." MG_Round " = ?2 ORDER BY m.id ASC");
+    maStmt.bind(1, catId);
+    maStmt.bind(2, lastRound);
+    for (maStmt.step(); maStmt.hasData(); maStmt.step())
+    {
+      RoundMatch rm{maStmt.getInt(0), maStmt.getInt(2), {}, Error::OK};
+
+      // same logic as in Match::getScore(): the packed
+      // result takes precedence over the result string
+      rm.score = MatchScore::fromPackedInt(maStmt.getInt(3));
+      const std::string resultString = maStmt.getString(4);
+      if (!rm.score && !resultString.empty())
+      {
+        rm.score = MatchScore::fromCharsWithoutValidation(resultString);
+        if (!rm.score) rm.scoreErr = Error::InconsistentMatchResultString;
+      }
+      if (!rm.score && (rm.scoreErr == Error::OK)) rm.scoreErr = Error::NoMatchResultSet;
+
+      // if a pair should appear in more than one match,
+      // the match with the lowest ID wins
+      for (int col : {0, 1})
+      {
+        const int pairId = maStmt.getInt(col);
+        if (pairId > 0) matchByPair.emplace(pairId, rm);
+      }
+    }
+
     // make sure that all matches for these player pairs have
-    // valid results. We need to check this in a separate loop
-    // to avoid that the ranking entries have already been
+    // valid results. We need to check this before writing
+    // anything to avoid that the ranking entries have already been
     // halfway written to the database when we encounter an invalid
     // match
-    MatchMngr mm{db};
-    for (PlayerPair pp : ppList)
+    for (const PlayerPair& pp : ppList)
     {
-      auto ma = mm.getMatchForPlayerPairAndRound(pp, lastRound);
-      if (ma.has_value())
+      auto it = matchByPair.find(pp.getPairId());
+      if ((it != matchByPair.end()) && (it->second.scoreErr != Error::OK))
       {
-        Error e;
-        auto score = ma->getScore(&e);
-        if (e != Error::OK)
-        {
-          if (err != nullptr) *err = e;
-          return RankingEntryList();
-        }
-        if (!score.has_value())
-        {
-          if (err != nullptr) *err = Error::NoMatchResultSet;
-          return RankingEntryList();
-        }
+        if (err != nullptr) *err = it->second.scoreErr;
+        return RankingEntryList();
       }
     }
 
+    // the ranking entries of the previous round, if required
+    std::unordered_map<int, std::array<int, 7>> prevStatsByPair;
+    if (!reset)
+    {
+      auto prevStmt = db.prepStatement("SELECT " RA_PairRef ", " RA_MatchesWon ", " RA_MatchesDraw ", " RA_MatchesLost ", "
+                                       RA_GamesWon ", " RA_GamesLost ", " RA_PointsWon ", " RA_PointsLost " FROM " TabMatchSystem
+                                       " WHERE " RA_CatRef " = ?1 AND " RA_Round " = ?2 AND " RA_PairRef " IS NOT NULL");
+      prevStmt.bind(1, catId);
+      prevStmt.bind(2, lastRound - 1);
+      for (prevStmt.step(); prevStmt.hasData(); prevStmt.step())
+      {
+        std::array<int, 7> stats;
+        for (size_t i = 0; i < stats.size(); ++i) stats[i] = prevStmt.getInt(static_cast<int>(i) + 1);
+        prevStatsByPair.emplace(prevStmt.getInt(0), stats);
+      }
+    }
+
+    // the match groups of the round; required for pairs that
+    // haven't played in this round
+    std::vector<int> roundGroupNumbers;
+    auto grpStmt = db.prepStatement("SELECT " MG_GrpNum " FROM " TabMatchGroup " WHERE " MG_CatRef " = ?1 AND " MG_Round " = ?2 ORDER BY id ASC");
+    grpStmt.bind(1, catId);
+    grpStmt.bind(2, lastRound);
+    for (grpStmt.step(); grpStmt.hasData(); grpStmt.step())
+    {
+      roundGroupNumbers.push_back(grpStmt.getInt(0));
+    }
+
     //
     // Okay, we can be pretty sure that the rest of this method
     // succeeds and that we leave the database in a consistent state
     //
 
-    // iterate over the player pair list and create entries
-    // based on match result and, possibly, previous ranking entries
-    RankingEntryList result;
-    for (PlayerPair pp : ppList)
+    // ranking entries are always appended, so we
+    // can identify the new rows by their ID
+    const int lastIdBefore = db.execScalarQueryIntOrNull("SELECT MAX(id) FROM " TabMatchSystem).value_or(0);
+
+    try
     {
-      // prepare the values for the new entry
-      int wonMatches = 0;
-      int drawMatches = 0;
-      int lostMatches = 0;
-      int wonGames = 0;
-      int lostGames = 0;
-      int wonPoints = 0;
-      int lostPoints = 0;
-
-      // get match results, if the player played in this round
-      // (maybe the player had a bye; in this case we skip this section)
-      auto ma = mm.getMatchForPlayerPairAndRound(pp, lastRound);
-      if (ma.has_value())
-      {
-        // determine whether our pp is player 1 or player 2
-        int pp1Id = ma->getPlayerPair1().getPairId();
-        int playerNum = (pp1Id == pp.getPairId()) ? 1 : 2;
-
-        // create column values for match data
-        Error e;
-        auto score = ma->getScore(&e);
-        assert(score.has_value());
-        wonMatches = (score->getWinner() == playerNum) ? 1 : 0;
-        lostMatches = (score->getLoser() == playerNum) ? 1 : 0;
-        drawMatches = (score->getWinner() == 0) ? 1 : 0;
-
-        // create column values for game data
-        std::tuple<int, int> gameSum = score->getGameSum();
-        int gamesTotal = std::get<0>(gameSum) + std::get<1>(gameSum);
-        wonGames = (playerNum == 1) ? std::get<0>(gameSum) : std::get<1>(gameSum);
-        lostGames = gamesTotal - wonGames;
-
-        // create column values for point data
-        std::tuple<int, int> scoreSum = score->getScoreSum();
-        wonPoints = (playerNum == 1) ? std::get<0>(scoreSum) : std::get<1>(scoreSum);
-        lostPoints = score->getPointsSum() - wonPoints;
-      }
+      auto trans = db.startTransaction(DefaultTransactionType);
 
-      // add values from previous round, if required
-      std::optional<RankingEntry> prevEntry{};
-      if (!reset)
-      {
-        // the next call may return nullptr, but this is fine.
-        // it just means that there is no old entry to build upon
-        // and thus we start with the scoring at zero
-        prevEntry = getRankingEntry(pp, lastRound-1);
-      }
+      // all entries are inserted without a rank
+      auto insertStmt = db.prepStatement("INSERT INTO " TabMatchSystem " (" RA_MatchesWon ", " RA_MatchesDraw ", " RA_MatchesLost ", "
+                                         RA_GamesWon ", " RA_GamesLost ", " RA_PointsWon ", " RA_PointsLost ", "
+                                         RA_PairRef ", " RA_Round ", " RA_CatRef ", " RA_GrpNum ") VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
 
-      if (prevEntry.has_value())
+      // iterate over the player pair list and create entries
+      // based on match result and, possibly, previous ranking entries
+      for (const PlayerPair& pp : ppList)
       {
-        std::tuple<int, int, int, int> maStat = prevEntry->getMatchStats();
-        wonMatches += std::get<0>(maStat);
-        drawMatches += std::get<1>(maStat);
-        lostMatches += std::get<2>(maStat);
-
-        std::tuple<int, int, int> gameStat = prevEntry->getGameStats();
-        wonGames += std::get<0>(gameStat);
-        lostGames += std::get<1>(gameStat);
-
-        std::tuple<int, int> pointStat = prevEntry->getPointStats();
-        wonPoints += std::get<0>(pointStat);
-        lostPoints += std::get<1>(pointStat);
-      }
+        const int ppId = pp.getPairId();
 
-      // determine the match group number for this entry
-      int grpNum;
-      if (ma.has_value())
-      {
-        // easiest and most likely case
-        grpNum = ma->getMatchGroup().getGroupNumber();
-      } else {
-        // hmmmm, we need to determine the group number of a
-        // playerPair that hasn't played in this round
-
-        // case 1:
-        // we are in some sort of round-robin round with
-        // multiple match groups. In this case, the group
-        // number can be derived directly from the PlayerPair
-        if (mm.getMatchGroupsForCat(cat, lastRound).size() > 1)
+        // won, draw and lost matches, won and lost games, won and lost points
+        std::array<int, 7> stats{};
+
+        // get match results, if the player played in this round
+        // (maybe the player had a bye; in this case we skip this section)
+        auto itMatch = matchByPair.find(ppId);
+        int grpNum;
+        if (itMatch != matchByPair.end())
         {
-          grpNum = pp.getPairsGroupNum();
+          const RoundMatch& rm = itMatch->second;
+          const MatchScore& score = *rm.score;
+
+          // determine whether our pp is player 1 or player 2
+          int playerNum = (rm.pair1Id == ppId) ? 1 : 2;
+
+          // match data
+          stats[0] = (score.getWinner() == playerNum) ? 1 : 0;
+          stats[1] = (score.getWinner() == 0) ? 1 : 0;
+          stats[2] = (score.getLoser() == playerNum) ? 1 : 0;
+
+          // game data
+          std::tuple<int, int> gameSum = score.getGameSum();
+          int gamesTotal = std::get<0>(gameSum) + std::get<1>(gameSum);
+          stats[3] = (playerNum == 1) ? std::get<0>(gameSum) : std::get<1>(gameSum);
+          stats[4] = gamesTotal - stats[3];
+
+          // point data
+          std::tuple<int, int> scoreSum = score.getScoreSum();
+          stats[5] = (playerNum == 1) ? std::get<0>(scoreSum) : std::get<1>(scoreSum);
+          stats[6] = score.getPointsSum() - stats[5];
+
+          // easiest and most likely case
+          grpNum = rm.grpNum;
         } else {
-
+          // hmmmm, we need to determine the group number of a
+          // playerPair that hasn't played in this round
+          //
+          // case 1:
+          // we are in some sort of round-robin round with
+          // multiple match groups. In this case, the group
+          // number can be derived directly from the PlayerPair
+          //
           // case 2:
           // we are either in a round-robin phase with only
           // one group or in a KO-round or similar. So we have
           // only one match group. Thus, we can derive the
           // group number from the match group
-          grpNum = mm.getMatchGroupsForCat(cat, lastRound).at(0).getGroupNumber();
+          grpNum = (roundGroupNumbers.size() == 1) ? roundGroupNumbers[0] : pp.getPairsGroupNum();
         }
+
+        // add values from previous round, if any
+        auto itPrev = prevStatsByPair.find(ppId);
+        if (itPrev != prevStatsByPair.end())
+        {
+          for (size_t i = 0; i < stats.size(); ++i) stats[i] += itPrev->second[i];
+        }
+
+        for (size_t i = 0; i < stats.size(); ++i) insertStmt.bind(static_cast<int>(i) + 1, stats[i]);
+        insertStmt.bind(8, ppId);
+        insertStmt.bind(9, lastRound);
+        insertStmt.bind(10, catId);  // eases searching, but is redundant information
+        insertStmt.bind(11, grpNum); // eases searching, but is redundant information
+        insertStmt.step();
+        insertStmt.reset(true);
       }
 
-      // prep the complete data set for the entry,
-      // but leave the "rank" column empty
-      ColumnValueClause cvc;
-      cvc.addCol(RA_MatchesWon, wonMatches);
-      cvc.addCol(RA_MatchesDraw, drawMatches);
-      cvc.addCol(RA_MatchesLost, lostMatches);
-      cvc.addCol(RA_GamesWon, wonGames);
-      cvc.addCol(RA_GamesLost, lostGames);
-      cvc.addCol(RA_PointsWon, wonPoints);
-      cvc.addCol(RA_PointsLost, lostPoints);
-      cvc.addCol(RA_PairRef, pp.getPairId());
-      cvc.addCol(RA_Round, lastRound);
-      cvc.addCol(RA_CatRef, cat.getId());  // eases searching, but is redundant information
-      cvc.addCol(RA_GrpNum, grpNum); // eases searching, but is redundant information
-
-      // create the new entry and add an instance
-      // of the entry to the result list
-      int newId = tab.insertRow(cvc);
-      result.push_back(RankingEntry(db, newId));
+      trans.commit();
+    }
+    catch (SqliteOverlay::GenericSqliteException&)
+    {
+      if (err != nullptr) *err = Error::DatabaseError;
+      return RankingEntryList();
+    }
+
+    // create instances of the new entries for the result list
+    RankingEntryList result;
+    auto newIdStmt = db.prepStatement("SELECT id FROM " TabMatchSystem " WHERE id > ?1 ORDER BY id ASC");
+    newIdStmt.bind(1, lastIdBefore);
+    for (newIdStmt.step(); newIdStmt.hasData(); newIdStmt.step())
+    {
+      result.push_back(RankingEntry(db, newIdStmt.getInt(0)));
     }
 
     if (err != nullptr) *err = Error::OK;
@@ -391,44 +435,51 @@ namespace QTournament
     if (!re.has_value()) return Error::OK;  // no ranking entries yet
     int grpNum = re->getGroupNumber();
 
+    // nothing to do if the correction doesn't
+    // change any of the accumulated values
+    if ((deltaMatches_P1 == std::tuple<int, int, int>{0, 0, 0}) && (deltaGames_P1 == std::tuple<int, int>{0, 0}) &&
+        (deltaGames_P2 == std::tuple<int, int>{0, 0}) && (deltaPoints_P1 == std::tuple<int, int>{0, 0}))
+    {
+      return Error::OK;
+    }
+
     //
     // a helper function that does the actual modification
     //
+    // The ranking entries contain accumulated values, so
+    // the delta is added to all entries of the pair
+    // from the modified round onwards in one statement
+    //
+    std::string modSql{"UPDATE " TabMatchSystem " SET "
+                       RA_MatchesWon " = " RA_MatchesWon " + ?1, " RA_MatchesLost " = " RA_MatchesLost " + ?2, "
+                       RA_MatchesDraw " = " RA_MatchesDraw " + ?3, " RA_GamesWon " = " RA_GamesWon " + ?4, "
+                       RA_GamesLost " = " RA_GamesLost " + ?5, " RA_PointsWon " = " RA_PointsWon " + ?6, "
+                       RA_PointsLost " = " RA_PointsLost " + ?7"
+                       " WHERE " RA_CatRef " = ?8 AND " RA_PairRef " = ?9 AND " RA_Round " >= ?10 AND "};
+    if (grpNum > 0)
+    {
+      modSql += RA_GrpNum " = ?11";   // a dedicated group number (1, 2, 3...)
+    } else {
+      modSql += RA_GrpNum " < 0";   // a functional number (iteration, quarter finals, ...)
+    }
+    auto modStmt = db.prepStatement(modSql);
+
     auto doMod = [&](int pairId, const std::tuple<int, int, int>& matchDelta,
                      const std::tuple<int, int>& gamesDelta, const std::tuple<int, int>& pointsDelta)
     {
-      // let's build a where clause that captures all entries
-      // to modified
-      w.clear();
-      w.addCol(RA_CatRef, catId);
-      w.addCol(RA_PairRef, pairId);
-      w.addCol(RA_Round, ">=", firstRoundToModify);
-      if (grpNum > 0)
-      {
-        w.addCol(RA_GrpNum, grpNum);   // a dedicated group number (1, 2, 3...)
-      } else {
-        w.addCol(RA_GrpNum, "<", 0);   // a functional number (iteration, quarter finals, ...)
-      }
-
-      auto rowsList = tab.getRowsByWhereClause(w);
-      for (const auto& r : rowsList)
-      {
-        std::vector<std::tuple <std::string, int>> colDelta = {
-          {RA_MatchesWon, std::get<0>(matchDelta)},
-          {RA_MatchesLost, std::get<1>(matchDelta)},
-          {RA_MatchesDraw, std::get<2>(matchDelta)},
-          {RA_GamesWon, std::get<0>(gamesDelta)},
-          {RA_GamesLost, std::get<1>(gamesDelta)},
-          {RA_PointsWon, std::get<0>(pointsDelta)},
-          {RA_PointsLost, std::get<1>(pointsDelta)},
-        };
-
-        for (auto [colName, deltaVal] : colDelta)
-        {
-          int oldVal = r.getInt(colName);
-          r.update(colName, oldVal + deltaVal);
-        }
-      }
+      modStmt.bind(1, std::get<0>(matchDelta));
+      modStmt.bind(2, std::get<1>(matchDelta));
+      modStmt.bind(3, std::get<2>(matchDelta));
+      modStmt.bind(4, std::get<0>(gamesDelta));
+      modStmt.bind(5, std::get<1>(gamesDelta));
+      modStmt.bind(6, std::get<0>(pointsDelta));
+      modStmt.bind(7, std::get<1>(pointsDelta));
+      modStmt.bind(8, catId);
+      modStmt.bind(9, pairId);
+      modStmt.bind(10, firstRoundToModify);
+      if (grpNum > 0) modStmt.bind(11, grpNum);
+      modStmt.step();
+      modStmt.reset(true);
     };
     //------------------------- end of helper func -------------------
 
@@ -452,30 +503,51 @@ namespace QTournament
       {
         auto specializedCat = cat.convertToSpecializedObject();
         auto lessThanFunc = specializedCat->getLessThanFunction();
+        auto rankStmt = db.prepStatement("UPDATE " TabMatchSystem " SET " RA_Rank " = ?1 WHERE id = ?2");
         int round = firstRoundToModify;
         while (true)
         {
+          // get the ranking entries in their current order
           w.clear();
           w.addCol(RA_CatRef, catId);
           w.addCol(RA_Round, round);
           w.addCol(RA_GrpNum, grpNum);
-
-          // get the ranking entries
+          w.setOrderColumn_Asc(RA_Rank);
           RankingEntryList rankList = getObjectsByWhereClause<RankingEntry>(w);
           if (rankList.empty()) break;   // no more rounds to modify
+          ++round;
+
+          // skip the group if the modified values
+          // didn't change the order of the entries
+          bool isSorted = true;
+          for (size_t i = 0; i < rankList.size(); ++i)
+          {
+            if ((rankList[i].getRank() != static_cast<int>(i + 1)) ||
+                ((i > 0) && lessThanFunc(rankList[i], rankList[i - 1])))
+            {
+              isSorted = false;
+              break;
+            }
+          }
+          if (isSorted) continue;
 
           // call the standard sorting algorithm
           std::sort(rankList.begin(), rankList.end(), lessThanFunc);
 
-          // write the sort results back to the database
+          // write only those ranks back to the database
+          // that have actually changed
           int rank = 1;
-          for (RankingEntry re : rankList)
+          for (const RankingEntry& re : rankList)
           {
-            re.rowRef().update(RA_Rank, rank);
+            if (re.getRank() != rank)
+            {
+              rankStmt.bind(1, rank);
+              rankStmt.bind(2, re.getId());
+              rankStmt.step();
+              rankStmt.reset(true);
+            }
             ++rank;
           }
-
-          ++round;
         }
       }
 
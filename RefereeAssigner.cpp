@@ -0,0 +1,211 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2019  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <tuple>
+
+#include <SqliteOverlay/KeyValueTab.h>
+
+#include "RefereeAssigner.h"
+#include "TournamentDB.h"
+#include "PlayerPair.h"
+#include "Score.h"
+
+using namespace std;
+
+namespace QTournament
+{
+
+  RefereeAssigner::RefereeAssigner(const TournamentDB& _db, int _recentMatchCount)
+    :db{_db}, recentMatchCount{_recentMatchCount}
+  {
+    reload();
+  }
+
+  //----------------------------------------------------------------------------
+
+  void RefereeAssigner::reload()
+  {
+    players.clear();
+
+    const int finishedState = static_cast<int>(ObjState::MA_Finished);
+
+    // all players along with their team names
+    auto stmt = db.get().prepStatement("SELECT p.id, p." PL_Fname ", p." PL_Lname ", p." GenericStateFieldName ", p." PL_RefereeCount ","
+                                       " IFNULL(p." PL_TeamRef ", -1), IFNULL(t." GenericNameFieldName ", '')"
+                                       " FROM " TabPlayer " p LEFT JOIN " TabTeam " t ON t.id = p." PL_TeamRef);
+    for (stmt.step(); stmt.hasData(); stmt.step())
+    {
+      const int plId = stmt.getInt(0);
+      const QString first = QString::fromUtf8(stmt.getString(1).c_str());
+      const QString last = QString::fromUtf8(stmt.getString(2).c_str());
+
+      RefereeCandidate cand{plId, last + ", " + first, stmt.getInt(5), QString::fromUtf8(stmt.getString(6).c_str()),
+            static_cast<ObjState>(stmt.getInt(3)), stmt.getInt(4), 0, RefereeTag::Neutral};
+      players.emplace(plId, PlayerEntry{cand, -1});
+    }
+
+    // the finish time of each player's last match
+    stmt = db.get().prepStatement("SELECT pl, MAX(ft) FROM ("
+                                  " SELECT " MA_ActualPlayer1aRef " AS pl, " MA_FinishTime " AS ft FROM " TabMatch " WHERE " GenericStateFieldName " = ?1"
+                                  " UNION ALL SELECT " MA_ActualPlayer1bRef ", " MA_FinishTime " FROM " TabMatch " WHERE " GenericStateFieldName " = ?1"
+                                  " UNION ALL SELECT " MA_ActualPlayer2aRef ", " MA_FinishTime " FROM " TabMatch " WHERE " GenericStateFieldName " = ?1"
+                                  " UNION ALL SELECT " MA_ActualPlayer2bRef ", " MA_FinishTime " FROM " TabMatch " WHERE " GenericStateFieldName " = ?1"
+                                  ") WHERE pl IS NOT NULL AND ft IS NOT NULL GROUP BY pl");
+    stmt.bind(1, finishedState);
+    for (stmt.step(); stmt.hasData(); stmt.step())
+    {
+      auto it = players.find(stmt.getInt(0));
+      if (it != players.end()) it->second.cand.lastFinishTime = stmt.getInt(1);
+    }
+
+    // the recently finished matches, most recent first; the
+    // same selection as PlayerMngr::getRecentFinishers()
+    stmt = db.get().prepStatement("SELECT IFNULL(p1." Pairs_Player1Ref ", -1), IFNULL(p1." Pairs_Player2Ref ", -1),"
+                                  " IFNULL(p2." Pairs_Player1Ref ", -1), IFNULL(p2." Pairs_Player2Ref ", -1),"
+                                  " IFNULL(m." MA_PackedResult ", -1), IFNULL(m." MA_Result ", '')"
+                                  " FROM " TabMatch " m LEFT JOIN " TabPairs " p1 ON p1.id = m." MA_Pair1Ref
+                                  " LEFT JOIN " TabPairs " p2 ON p2.id = m." MA_Pair2Ref
+                                  " WHERE m." GenericStateFieldName " = ?1 ORDER BY m." MA_FinishTime " DESC LIMIT ?2");
+    stmt.bind(1, finishedState);
+    stmt.bind(2, recentMatchCount);
+    int recentRank = 0;
+    for (stmt.step(); stmt.hasData(); stmt.step())
+    {
+      // matches without a score are treated like draws
+      int winner = 0;
+      const int packed = stmt.getInt(4);
+      auto score = (packed > 0) ? MatchScore::fromPackedInt(packed) : std::optional<MatchScore>{};
+      if (!score)
+      {
+        const string resultString = stmt.getString(5);
+        if (!resultString.empty()) score = MatchScore::fromCharsWithoutValidation(resultString);
+      }
+      if (score) winner = score->getWinner();
+
+      for (int col = 0; col < 4; ++col)
+      {
+        auto it = players.find(stmt.getInt(col));
+        if (it == players.end()) continue;
+
+        // only the most recent match counts
+        PlayerEntry& pe = it->second;
+        if (pe.recentRank >= 0) continue;
+        pe.recentRank = recentRank;
+
+        const int pairPos = (col < 2) ? 1 : 2;
+        if (winner == 0)
+        {
+          pe.cand.tag = RefereeTag::Neutral;
+        } else {
+          pe.cand.tag = (winner == pairPos) ? RefereeTag::Winner : RefereeTag::Loser;
+        }
+      }
+      ++recentRank;
+    }
+
+    SqliteOverlay::KeyValueTab cfg{db.get(), TabCfg};
+    defaultTeamId = cfg.getInt2(CfgKey_RefereeTeamId).value_or(-1);
+  }
+
+  //----------------------------------------------------------------------------
+
+  vector<RefereeCandidate> RefereeAssigner::getCandidates(const Match& ma, RefereeMode mode, RefereeAction refAction, int teamId) const
+  {
+    if ((mode != RefereeMode::AllPlayers) && (mode != RefereeMode::RecentFinishers) && (mode != RefereeMode::SpecialTeam)) return {};
+    if ((mode == RefereeMode::SpecialTeam) && (teamId < 1)) return {};
+
+    // the players of the match itself
+    vector<int> matchPlayerIds;
+    for (const PlayerPair& pp : {ma.getPlayerPair1(), ma.getPlayerPair2()})
+    {
+      matchPlayerIds.push_back(pp.getPlayer1().getId());
+      if (pp.hasPlayer2()) matchPlayerIds.push_back(pp.getPlayer2().getId());
+    }
+
+    vector<RefereeCandidate> result;
+    for (const auto& [plId, pe] : players)
+    {
+      if (find(begin(matchPlayerIds), end(matchPlayerIds), plId) != end(matchPlayerIds)) continue;
+
+      // only idle players can be called immediately
+      if ((refAction != RefereeAction::PreAssign) && (pe.cand.state != ObjState::PL_Idle)) continue;
+
+      if ((mode == RefereeMode::SpecialTeam) && (pe.cand.teamId != teamId)) continue;
+      if (mode == RefereeMode::RecentFinishers)
+      {
+        if (pe.recentRank < 0) continue;
+        if (pe.cand.state == ObjState::PL_Referee) continue;
+      }
+
+      result.push_back(pe.cand);
+    }
+
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+  vector<RefereeCandidate> RefereeAssigner::getRankedCandidates(const Match& ma, RefereeMode mode, RefereeAction refAction, int teamId) const
+  {
+    vector<RefereeCandidate> result = getCandidates(ma, mode, refAction, teamId);
+
+    // all sort criteria are already in memory
+    sort(begin(result), end(result), [](const RefereeCandidate& c1, const RefereeCandidate& c2)
+    {
+      const auto k1 = make_tuple(c1.refereeCount, static_cast<int>(c1.tag), c1.lastFinishTime);
+      const auto k2 = make_tuple(c2.refereeCount, static_cast<int>(c2.tag), c2.lastFinishTime);
+      if (k1 != k2) return (k1 < k2);
+      return (c1.displayName < c2.displayName);
+    });
+
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+  std::optional<int> RefereeAssigner::suggestReferee(const Match& ma, RefereeAction refAction) const
+  {
+    const auto ranked = getRankedCandidates(ma, ma.get_EFFECTIVE_RefereeMode(), refAction, defaultTeamId);
+    if (ranked.empty()) return {};
+
+    return ranked.front().playerId;
+  }
+
+  //----------------------------------------------------------------------------
+
+  void RefereeAssigner::markMatchCalled(const Match& ma, int refereeId)
+  {
+    for (const PlayerPair& pp : {ma.getPlayerPair1(), ma.getPlayerPair2()})
+    {
+      setPlayerState(pp.getPlayer1().getId(), ObjState::PL_Playing);
+      if (pp.hasPlayer2()) setPlayerState(pp.getPlayer2().getId(), ObjState::PL_Playing);
+    }
+
+    if (refereeId > 0) setPlayerState(refereeId, ObjState::PL_Referee);
+  }
+
+  //----------------------------------------------------------------------------
+
+  void RefereeAssigner::setPlayerState(int playerId, ObjState newState)
+  {
+    auto it = players.find(playerId);
+    if (it != players.end()) it->second.cand.state = newState;
+  }
+
+}
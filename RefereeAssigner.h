@@ -0,0 +1,155 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2019  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REFEREEASSIGNER_H
+#define REFEREEASSIGNER_H
+
+#include <ctime>
+#include <functional>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include <QString>
+
+#include "TournamentDataDefs.h"
+#include "Match.h"
+
+namespace QTournament
+{
+  class TournamentDB;
+
+  /** \brief The result of a player's most recent match; used
+   * for tagging recent finishers
+   */
+  enum class RefereeTag
+  {
+    Loser = -1,
+    Neutral = 0,   ///< draw or not a recent finisher
+    Winner = 1,
+  };
+
+  //----------------------------------------------------------------------------
+
+  /** \brief A possible referee for a match along with all data
+   * that is necessary for displaying and ranking the candidates
+   */
+  struct RefereeCandidate
+  {
+    int playerId;
+    QString displayName;   ///< same format as Player::getDisplayName()
+    int teamId;   ///< -1 if the player has no team
+    QString teamName;
+    ObjState state;
+    int refereeCount;
+    time_t lastFinishTime;   ///< 0 if the player hasn't finished any match yet
+    RefereeTag tag;
+  };
+
+  //----------------------------------------------------------------------------
+
+  /** \brief In-memory data for selecting and automatically assigning referees
+   *
+   * All players along with their referee counts, states, teams and the
+   * time of their last finished match are loaded with a fixed number of
+   * queries. Selecting and ranking candidates afterwards doesn't
+   * access the database at all.
+   *
+   * The candidates are ranked by:
+   *   1. number of previous referee assignments (fewest first)
+   *   2. result of the last match (losers before draws before winners)
+   *   3. time of the last finished match (longest break first)
+   *   4. display name
+   *
+   * The in-memory data is not automatically updated. If an assigner is
+   * used for several match calls (e.g., in a batch), the caller has to
+   * report each call via markMatchCalled().
+   */
+  class RefereeAssigner
+  {
+  public:
+    static constexpr int DefaultRecentMatchCount = 30;   ///< number of recently finished matches for RefereeMode::RecentFinishers
+
+    explicit RefereeAssigner(
+        const TournamentDB& _db,
+        int _recentMatchCount = DefaultRecentMatchCount   ///< number of recently finished matches for RefereeMode::RecentFinishers
+        );
+
+    /** \brief Re-reads all player data from the database
+     */
+    void reload();
+
+    /** \returns all candidates for a match in no particular order
+     *
+     * The players of the match itself are never included. For match calls
+     * and umpire swaps, only idle players are included.
+     */
+    std::vector<RefereeCandidate> getCandidates(
+        const Match& ma,
+        RefereeMode mode,   ///< AllPlayers, RecentFinishers or SpecialTeam
+        RefereeAction refAction,
+        int teamId = -1   ///< the team for RefereeMode::SpecialTeam
+        ) const;
+
+    /** \returns the same candidates as getCandidates(), but sorted
+     * from most to least suitable
+     */
+    std::vector<RefereeCandidate> getRankedCandidates(
+        const Match& ma,
+        RefereeMode mode,   ///< AllPlayers, RecentFinishers or SpecialTeam
+        RefereeAction refAction,
+        int teamId = -1   ///< the team for RefereeMode::SpecialTeam
+        ) const;
+
+    /** \returns the ID of the most suitable referee for a match, if any
+     *
+     * The mode and, for RefereeMode::SpecialTeam, the team are taken
+     * from the match and the tournament settings.
+     */
+    std::optional<int> suggestReferee(
+        const Match& ma,
+        RefereeAction refAction
+        ) const;
+
+    /** \brief Updates the in-memory player states after a match call: all
+     * players of the match are playing and the referee, if any, is busy
+     */
+    void markMatchCalled(
+        const Match& ma,
+        int refereeId = -1   ///< the ID of the match's referee, -1 for none
+        );
+
+  protected:
+    struct PlayerEntry
+    {
+      RefereeCandidate cand;
+      int recentRank;   ///< position in the list of recent finishers; -1 if not a recent finisher
+    };
+
+    void setPlayerState(int playerId, ObjState newState);
+
+  private:
+    std::reference_wrapper<const TournamentDB> db;
+    int recentMatchCount;
+    std::unordered_map<int, PlayerEntry> players;
+    int defaultTeamId{-1};
+  };
+
+}
+
+#endif // REFEREEASSIGNER_H
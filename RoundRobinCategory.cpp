@@ -109,16 +109,17 @@ namespace QTournament
     if (allGrp.size() != 0) return Error::OK;
 
     // alright, this is a virgin category. Generate group matches
-    // for each group
+    // for each group and create them all at once
     KO_Config cfg = KO_Config(getParameter_string(CatParameter::GroupConfig));
+    MatchPlan plan;
     for (int grpIndex = 0; grpIndex < cfg.getNumGroups(); ++grpIndex)
     {
       PlayerPairList grpMembers = getPlayerPairs(grpIndex+1);
-      Error e = generateGroupMatches(grpMembers, grpIndex+1, 1);
+      Error e = addGroupMatchesToPlan(grpMembers, grpIndex+1, 1, plan);
       if (e != Error::OK) return e;
     }
 
-    return Error::OK;
+    return mm.createMatchesFromPlan(*this, plan);
   }
 
 //----------------------------------------------------------------------------
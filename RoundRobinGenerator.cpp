@@ -94,10 +94,71 @@
  *
  */
 
+#include <algorithm>
+#include <array>
+
 #include "RoundRobinGenerator.h"
 
 namespace QTournament {
 
+  namespace
+  {
+    // the number of matches in the full schedule for an even
+    // number of players, including the matches of a dummy player
+    constexpr int circleScheduleSize(int nEven)
+    {
+      return (nEven - 1) * (nEven / 2);
+    }
+
+    //----------------------------------------------------------------------------
+
+    // writes the complete schedule for an even number of players
+    // to "out", round by round, using the formula for n_p from above.
+    //
+    // usable at compile time and at runtime
+    constexpr void fillCircleSchedule(int nEven, RoundRobinPairing* out)
+    {
+      const int pMax = nEven - 1;
+      int idx = 0;
+      for (int r = 0; r < pMax; ++r)
+      {
+        for (int matchNum = 0; matchNum < (nEven / 2); ++matchNum)
+        {
+          const int p2 = pMax - matchNum;
+          out[idx].player1 = static_cast<uint16_t>((matchNum == 0) ? 0 : (r + matchNum - 1) % pMax + 1);
+          out[idx].player2 = static_cast<uint16_t>((r + p2 - 1) % pMax + 1);
+          ++idx;
+        }
+      }
+    }
+
+    //----------------------------------------------------------------------------
+
+    template<int NEven>
+    constexpr std::array<RoundRobinPairing, circleScheduleSize(NEven)> makeCircleTable()
+    {
+      std::array<RoundRobinPairing, circleScheduleSize(NEven)> result{};
+      fillCircleSchedule(NEven, result.data());
+      return result;
+    }
+
+    template<int NEven>
+    constexpr auto circleTable = makeCircleTable<NEven>();
+
+    //----------------------------------------------------------------------------
+
+    template<size_t... I>
+    constexpr std::array<const RoundRobinPairing*, sizeof...(I)> makeCircleTableIndex(std::index_sequence<I...>)
+    {
+      return {circleTable<2 * (static_cast<int>(I) + 1)>.data()...};
+    }
+
+    // element i points to the schedule for 2 * (i + 1) players
+    constexpr auto circleTableIndex = makeCircleTableIndex(std::make_index_sequence<RoundRobinSchedule::MaxTabulatedPlayers / 2>{});
+  }
+
+//----------------------------------------------------------------------------
+
   RoundRobinGenerator::RoundRobinGenerator()
   {
   }
@@ -146,6 +207,103 @@ namespace QTournament {
 
 //----------------------------------------------------------------------------
 
+  RoundRobinSchedule::RoundRobinSchedule(int numPlayers, const RoundRobinOptions& opt)
+    :nPlayers{numPlayers}
+  {
+    if (numPlayers < 2) return;
+
+    // fake a dummy player, if necessary
+    const bool isOdd = (numPlayers % 2) != 0;
+    const int nEven = isOdd ? (numPlayers + 1) : numPlayers;
+    nRounds = nEven - 1;
+    nMatchesPerRound = numPlayers / 2;   // this always rounds down
+
+    // take the plain schedule from the tables or compute
+    // it now for very large groups
+    const int fullSize = circleScheduleSize(nEven);
+    std::vector<RoundRobinPairing> computed;
+    const RoundRobinPairing* full = nullptr;
+    if (nEven <= MaxTabulatedPlayers)
+    {
+      full = circleTableIndex[nEven / 2 - 1];
+    } else {
+      computed.resize(fullSize);
+      fillCircleSchedule(nEven, computed.data());
+      full = computed.data();
+    }
+
+    // copy the schedule and skip all matches involving the dummy
+    // player; the dummy player has exactly one match per round, so
+    // the number of matches per round remains constant
+    matches.reserve(nRounds * nMatchesPerRound);
+    const int dummy = nEven - 1;
+    for (int idx = 0; idx < fullSize; ++idx)
+    {
+      RoundRobinPairing p = full[idx];
+      if (isOdd && ((p.player1 == dummy) || (p.player2 == dummy))) continue;
+
+      // the pivot player n0 alternates between the positions from round
+      // to round. For all other matches, the player on the even position
+      // of the number block becomes player 1. Since the players move by one
+      // position per round, they alternate between player 1 and player 2.
+      if (opt.balanceHomeAway)
+      {
+        const int r = idx / (nEven / 2);
+        const int matchNum = idx % (nEven / 2);
+        if ((matchNum == 0) ? ((r % 2) != 0) : ((matchNum % 2) != 0))
+        {
+          std::swap(p.player1, p.player2);
+        }
+      }
+
+      matches.push_back(p);
+    }
+
+    if (opt.restBetweenRounds) applyRestBetweenRounds();
+  }
+
+//----------------------------------------------------------------------------
+
+  std::pair<const RoundRobinPairing*, const RoundRobinPairing*> RoundRobinSchedule::getRound(int round) const
+  {
+    if ((round < 0) || (round >= nRounds)) return {nullptr, nullptr};
+
+    const RoundRobinPairing* first = matches.data() + round * nMatchesPerRound;
+    return {first, first + nMatchesPerRound};
+  }
+
+//----------------------------------------------------------------------------
+
+  void RoundRobinSchedule::applyRestBetweenRounds()
+  {
+    // the position of each player's match in the previous round; -1 for a bye
+    std::vector<int> lastSlot(nPlayers, -1);
+
+    for (int r = 0; r < nRounds; ++r)
+    {
+      auto first = matches.begin() + r * nMatchesPerRound;
+      auto last = first + nMatchesPerRound;
+
+      // players who played late in the previous round
+      // get a late match in this round, too
+      if (r > 0)
+      {
+        std::stable_sort(first, last, [&lastSlot](const RoundRobinPairing& m1, const RoundRobinPairing& m2)
+        {
+          return (std::max(lastSlot[m1.player1], lastSlot[m1.player2]) < std::max(lastSlot[m2.player1], lastSlot[m2.player2]));
+        });
+      }
+
+      std::fill(lastSlot.begin(), lastSlot.end(), -1);
+      int slot = 0;
+      for (auto it = first; it != last; ++it)
+      {
+        lastSlot[it->player1] = slot;
+        lastSlot[it->player2] = slot;
+        ++slot;
+      }
+    }
+  }
 
 //----------------------------------------------------------------------------
 
@@ -21,6 +21,8 @@
 
 #include <vector>
 #include <tuple>
+#include <cstdint>
+#include <utility>
 
 
 namespace QTournament
@@ -37,5 +39,63 @@ private:
   int n(int r, int p);
 };
 
+//----------------------------------------------------------------------------
+
+/** \brief A match between two group members, identified by their
+ * index in the group
+ */
+struct RoundRobinPairing
+{
+  uint16_t player1;
+  uint16_t player2;
+};
+
+/** \brief Optional modifications of the plain circle method
+ */
+struct RoundRobinOptions
+{
+  bool balanceHomeAway{false};   ///< alternate first / second position so that every player is "player 1" in about half of the matches
+  bool restBetweenRounds{false};   ///< order the matches within a round so that players of late matches in the previous round play late again
+};
+
+/** \brief The complete round robin schedule for a group of players
+ *
+ * All matches are stored round by round in one flat, contiguous array
+ * with a fixed number of matches per round. For up to MaxTabulatedPlayers
+ * players the schedule is copied from tables that are computed at compile
+ * time; larger groups are computed on construction.
+ *
+ * Without options, the schedule is identical to the results of
+ * RoundRobinGenerator::operator().
+ */
+class RoundRobinSchedule
+{
+public:
+  static constexpr int MaxTabulatedPlayers = 64;
+
+  RoundRobinSchedule(int numPlayers, const RoundRobinOptions& opt = RoundRobinOptions{});
+
+  int getNumPlayers() const { return nPlayers; }
+  int getNumRounds() const { return nRounds; }
+  int getMatchesPerRound() const { return nMatchesPerRound; }
+
+  /** \returns all matches of all rounds; round `r` starts at index `r * getMatchesPerRound()`
+   */
+  const std::vector<RoundRobinPairing>& getAllMatches() const { return matches; }
+
+  /** \returns begin and end of the matches of a (zero-based) round
+   */
+  std::pair<const RoundRobinPairing*, const RoundRobinPairing*> getRound(int round) const;
+
+protected:
+  void applyRestBetweenRounds();
+
+private:
+  int nPlayers;
+  int nRounds{0};
+  int nMatchesPerRound{0};
+  std::vector<RoundRobinPairing> matches;
+};
+
 }
 #endif // ROUNDROBINGENERATOR_H
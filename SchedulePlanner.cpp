@@ -0,0 +1,495 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2019  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <cstdlib>
+#include <unordered_map>
+
+#include <QDateTime>
+
+#include <SqliteOverlay/Transaction.h>
+
+#include "SchedulePlanner.h"
+#include "TournamentDataDefs.h"
+#include "MatchTimePredictor.h"
+#include "MatchMngr.h"
+#include "CatMngr.h"
+#include "CourtMngr.h"
+#include "CentralSignalEmitter.h"
+
+using namespace std;
+
+namespace QTournament
+{
+  namespace
+  {
+    // a point in time that will never be reached, e.g. the
+    // finish time of a match that hasn't been scheduled yet
+    constexpr time_t Never = numeric_limits<time_t>::max();
+
+    //----------------------------------------------------------------------------
+
+    // all matches that have a match number but haven't been called yet,
+    // optionally followed by all matches in staged match groups
+    string getQueueSql(bool includeStagedGroups)
+    {
+      string sql = "SELECT m.id, g." MG_CatRef ", m." MA_Pair1Ref ", m." MA_Pair2Ref ", m." MA_Pair1SymbolicVal
+                   ", m." MA_Pair2SymbolicVal ", m." GenericStateFieldName ", g." MG_Round
+                   " FROM " TabMatch " m JOIN " TabMatchGroup " g ON m." MA_GrpRef " = g.id"
+                   " WHERE ((m." MA_Num " > 0) AND (m." GenericStateFieldName " <> "
+                   + to_string(static_cast<int>(ObjState::MA_Running)) + ") AND (m." GenericStateFieldName " <> "
+                   + to_string(static_cast<int>(ObjState::MA_Finished)) + "))";
+
+      if (includeStagedGroups)
+      {
+        sql += " OR (g." MG_StageSeqNum " > 0)";
+      }
+
+      // scheduled matches first, then the staged ones in the
+      // same order as scheduleAllStagedMatchGroups() would number them
+      sql += " ORDER BY IFNULL(m." MA_Num ", 0) <= 0, m." MA_Num ", g." MG_StageSeqNum ", m.id";
+
+      return sql;
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  SchedulePlanner::SchedulePlanner(const TournamentDB& _db, const SchedulePlannerConfig& _cfg)
+    :db{_db}, cfg{_cfg}
+  {
+  }
+
+  //----------------------------------------------------------------------------
+
+  SchedulePlan SchedulePlanner::createPlan(bool includeStagedGroups, std::optional<time_t> refTime)
+  {
+    SchedulePlan plan;
+    plan.includesStagedGroups = includeStagedGroups;
+
+    loadQueue(includeStagedGroups, refTime ? *refTime : time(nullptr));
+    for (const PlannedMatch& pm : matches)
+    {
+      plan.currentOrder.push_back(pm.matchId);
+    }
+    plan.proposedOrder = plan.currentOrder;
+
+    // without courts or matches there's nothing to optimize
+    if (courtFreeTimes.empty() || matches.empty()) return plan;
+
+    // the order is handled as a list of indices into "matches"
+    vector<int> order(matches.size());
+    iota(begin(order), end(order), 0);
+
+    ScheduleEvaluation best = evaluate(order);
+    plan.current = best;
+    int nEvaluations = 1;
+
+    // local search: move single matches a few positions forward or
+    // backward and keep every change that strictly reduces the cost.
+    // Repeat until no move helps anymore or the budget is exhausted.
+    const int n = static_cast<int>(order.size());
+    bool hasImproved = true;
+    while (hasImproved && (nEvaluations < cfg.maxEvaluations))
+    {
+      hasImproved = false;
+      for (int i = 0; (i < n) && (nEvaluations < cfg.maxEvaluations); ++i)
+      {
+        for (int d = -cfg.moveWindow; (d <= cfg.moveWindow) && (nEvaluations < cfg.maxEvaluations); ++d)
+        {
+          const int j = i + d;
+          if ((d == 0) || (j < 0) || (j >= n)) continue;
+          if (!isMoveAllowed(order, i, j)) continue;
+
+          vector<int> candidate{order};
+          const int idx = candidate[i];
+          candidate.erase(candidate.begin() + i);
+          candidate.insert(candidate.begin() + j, idx);
+
+          const ScheduleEvaluation eval = evaluate(candidate);
+          ++nEvaluations;
+          if (eval.cost < best.cost)
+          {
+            order.swap(candidate);
+            best = eval;
+            hasImproved = true;
+          }
+        }
+      }
+    }
+
+    plan.proposed = best;
+    plan.nEvaluations = nEvaluations;
+    transform(begin(order), end(order), begin(plan.proposedOrder), [this](int idx) { return matches[idx].matchId; });
+
+    return plan;
+  }
+
+  //----------------------------------------------------------------------------
+
+  Error SchedulePlanner::applyPlan(const SchedulePlan& plan) const
+  {
+    // the queue must not have changed since the plan has been created
+    if (getQueuedMatchIds(plan.includesStagedGroups) != plan.currentOrder) return Error::WrongState;
+
+    // the models re-read everything once at the end; the status
+    // signals emitted while scheduling staged groups still reach
+    // the non-model listeners
+    CentralSignalEmitter* cse = CentralSignalEmitter::getInstance();
+    cse->beginResetAllModels();
+
+    Error result{Error::OK};
+    try
+    {
+      auto trans = db.get().startTransaction(DefaultTransactionType);
+
+      // after this step, all matches in the plan have a match number
+      if (plan.includesStagedGroups)
+      {
+        MatchMngr mm{db};
+        mm.scheduleAllStagedMatchGroups();
+      }
+
+      // collect the match numbers that are currently used by the queue
+      // and temporarily negate them to avoid conflicts with the
+      // UNIQUE constraint while re-assigning them
+      vector<int> matchNumbers;
+      auto selectNumStmt = db.get().prepStatement("SELECT " MA_Num " FROM " TabMatch " WHERE id = ?1");
+      auto negateNumStmt = db.get().prepStatement("UPDATE " TabMatch " SET " MA_Num " = -" MA_Num " WHERE id = ?1");
+      for (int maId : plan.currentOrder)
+      {
+        selectNumStmt.bind(1, maId);
+        selectNumStmt.step();
+        matchNumbers.push_back(selectNumStmt.getInt(0));
+        selectNumStmt.reset(true);
+
+        negateNumStmt.bind(1, maId);
+        negateNumStmt.step();
+        negateNumStmt.reset(true);
+      }
+      sort(begin(matchNumbers), end(matchNumbers));
+
+      // hand out the numbers in the proposed order
+      auto updateNumStmt = db.get().prepStatement("UPDATE " TabMatch " SET " MA_Num " = ?1 WHERE id = ?2");
+      for (size_t i = 0; i < plan.proposedOrder.size(); ++i)
+      {
+        updateNumStmt.bind(1, matchNumbers[i]);
+        updateNumStmt.bind(2, plan.proposedOrder[i]);
+        updateNumStmt.step();
+        updateNumStmt.reset(true);
+      }
+
+      trans.commit();
+    }
+    catch (...)
+    {
+      // the transaction has been rolled back
+      result = Error::DatabaseError;
+    }
+
+    cse->endResetAllModels();
+
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+  vector<int> SchedulePlanner::getQueuedMatchIds(bool includeStagedGroups) const
+  {
+    vector<int> result;
+
+    auto stmt = db.get().prepStatement(getQueueSql(includeStagedGroups));
+    for (stmt.step(); stmt.hasData(); stmt.step())
+    {
+      result.push_back(stmt.getInt(0));
+    }
+
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+  void SchedulePlanner::loadQueue(bool includeStagedGroups, time_t _now)
+  {
+    now = _now;
+    courtFreeTimes.clear();
+    playerFreeTimes.clear();
+    matches.clear();
+
+    // use the same durations as the time predictor
+    MatchTimePredictor predictor{db};
+    CatMngr cm{db};
+    unordered_map<int, int> catId2Duration;
+    auto getDuration = [&](int catId)
+    {
+      auto it = catId2Duration.find(catId);
+      if (it != catId2Duration.end()) return it->second;
+
+      const int duration = predictor.getAverageMatchDurationForCat__secs(cm.getCategoryById(catId));
+      catId2Duration.emplace(catId, duration);
+      return duration;
+    };
+
+    // map player IDs to dense indices; "0" as free time means
+    // that the player hasn't played recently
+    unordered_map<int, int> playerId2Idx;
+    auto getPlayerIdx = [&](int playerId)
+    {
+      auto [it, isNew] = playerId2Idx.try_emplace(playerId, static_cast<int>(playerFreeTimes.size()));
+      if (isNew) playerFreeTimes.push_back(0);
+      return it->second;
+    };
+
+    // the predicted finish time of running matches, same as in MatchTimePredictor
+    auto getPredictedFinish = [&](const Match& ma)
+    {
+      const QDateTime start = ma.getStartTime();
+      if (start.isNull()) return now + MatchTimePredictor::CourtIsBusyAndPredictionWrong_CorrectionOffset_secs;
+
+      const time_t finish = start.toTime_t() + getDuration(ma.getCategory().getId());
+      return (finish < now) ? (now + MatchTimePredictor::CourtIsBusyAndPredictionWrong_CorrectionOffset_secs) : finish;
+    };
+
+    // courts and the players of running matches
+    MatchMngr mm{db};
+    unordered_map<int, time_t> runningMatchFinish;
+    for (const Match& ma : mm.getCurrentlyRunningMatches())
+    {
+      const time_t finish = getPredictedFinish(ma);
+      runningMatchFinish.emplace(ma.getId(), finish);
+
+      for (const Player& p : ma.determineActualPlayers())
+      {
+        const int idx = getPlayerIdx(p.getId());
+        playerFreeTimes[idx] = max(playerFreeTimes[idx], finish);
+      }
+    }
+
+    CourtMngr com{db};
+    for (const Court& co : com.getAllCourts())
+    {
+      if (co.isInState(ObjState::CO_Disabled)) continue;
+
+      auto ma = mm.getMatchForCourt(co);
+      courtFreeTimes.push_back(ma ? runningMatchFinish[ma->getId()] : (now - MatchTimePredictor::GraceTimeBetweenMatches_secs));
+    }
+
+    // all player pairs in one go
+    unordered_map<int, vector<int>> pairId2PlayerIds;
+    auto pairStmt = db.get().prepStatement("SELECT id, " Pairs_Player1Ref ", " Pairs_Player2Ref " FROM " TabPairs);
+    for (pairStmt.step(); pairStmt.hasData(); pairStmt.step())
+    {
+      vector<int>& playerIds = pairId2PlayerIds[pairStmt.getInt(0)];
+      playerIds.push_back(pairStmt.getInt(1));
+      if (pairStmt.getInt(2) > 0) playerIds.push_back(pairStmt.getInt(2));
+    }
+
+    // the queue itself; read it completely before resolving the
+    // symbolic names, because a match could refer to a later one
+    struct QueueRow
+    {
+      int pairId[2];
+      int symbolicVal[2];
+      int round;
+    };
+    vector<QueueRow> rows;
+    unordered_map<int, int> matchId2Idx;
+    unordered_map<int, vector<int>> pairId2Idx;   // all queued matches of a player pair
+    auto queueStmt = db.get().prepStatement(getQueueSql(includeStagedGroups));
+    for (queueStmt.step(); queueStmt.hasData(); queueStmt.step())
+    {
+      const int maId = queueStmt.getInt(0);
+      const bool isPostponed = (queueStmt.getInt(6) == static_cast<int>(ObjState::MA_Postponed));
+
+      matchId2Idx.emplace(maId, static_cast<int>(matches.size()));
+      matches.push_back(PlannedMatch{maId, getDuration(queueStmt.getInt(1)), {}, {}, 0, !isPostponed});
+      rows.push_back(QueueRow{{queueStmt.getInt(2), queueStmt.getInt(3)}, {queueStmt.getInt(4), queueStmt.getInt(5)}, queueStmt.getInt(7)});
+      for (int pairId : rows.back().pairId)
+      {
+        if (pairId > 0) pairId2Idx[pairId].push_back(static_cast<int>(matches.size()) - 1);
+      }
+    }
+
+    auto stateStmt = db.get().prepStatement("SELECT " GenericStateFieldName " FROM " TabMatch " WHERE id = ?1");
+    for (size_t i = 0; i < matches.size(); ++i)
+    {
+      PlannedMatch& pm = matches[i];
+      for (int pos = 0; pos < 2; ++pos)
+      {
+        // a regular player pair
+        const int pairId = rows[i].pairId[pos];
+        if (pairId > 0)
+        {
+          for (int playerId : pairId2PlayerIds[pairId]) pm.players.push_back(getPlayerIdx(playerId));
+
+          // like in the MatchDependencyGraph, the pair's match in the
+          // previous round has to be finished first
+          int prevIdx = -1;
+          for (int otherIdx : pairId2Idx[pairId])
+          {
+            const int otherRound = rows[otherIdx].round;
+            if ((otherRound < rows[i].round) && ((prevIdx < 0) || (otherRound > rows[prevIdx].round))) prevIdx = otherIdx;
+          }
+          if (prevIdx >= 0) pm.predecessors.push_back(prevIdx);
+
+          continue;
+        }
+
+        // winner or loser of another match
+        const int srcId = abs(rows[i].symbolicVal[pos]);
+        if (srcId == 0)
+        {
+          pm.isPlayable = false;
+          continue;
+        }
+
+        auto itSrc = matchId2Idx.find(srcId);
+        if (itSrc != matchId2Idx.end())
+        {
+          pm.predecessors.push_back(itSrc->second);
+          continue;
+        }
+
+        auto itRunning = runningMatchFinish.find(srcId);
+        if (itRunning != runningMatchFinish.end())
+        {
+          pm.earliestStart = max(pm.earliestStart, itRunning->second);
+          continue;
+        }
+
+        // the source match is neither queued nor running; unless it's
+        // already finished, the match can't be called with this queue
+        stateStmt.bind(1, srcId);
+        stateStmt.step();
+        const bool isFinished = stateStmt.hasData() && (stateStmt.getInt(0) == static_cast<int>(ObjState::MA_Finished));
+        stateStmt.reset(true);
+        if (!isFinished) pm.isPlayable = false;
+      }
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  bool SchedulePlanner::isMoveAllowed(const vector<int>& order, int from, int to) const
+  {
+    const int idx = order[from];
+    auto isPredecessor = [this](int pre, int succ)
+    {
+      const vector<int>& preds = matches[succ].predecessors;
+      return (find(begin(preds), end(preds), pre) != end(preds));
+    };
+
+    // a match may not overtake one of its predecessors...
+    for (int k = to; k < from; ++k)
+    {
+      if (isPredecessor(order[k], idx)) return false;
+    }
+
+    // ... and may not fall behind one of its successors
+    for (int k = from + 1; k <= to; ++k)
+    {
+      if (isPredecessor(idx, order[k])) return false;
+    }
+
+    return true;
+  }
+
+  //----------------------------------------------------------------------------
+
+  ScheduleEvaluation SchedulePlanner::evaluate(const vector<int>& order) const
+  {
+    ScheduleEvaluation result;
+    result.endTime = now;
+
+    vector<time_t> courtFree{courtFreeTimes};
+    vector<time_t> playerFree{playerFreeTimes};
+    vector<time_t> finish(matches.size(), Never);
+
+    vector<int> pending;
+    pending.reserve(order.size());
+    for (int idx : order)
+    {
+      if (matches[idx].isPlayable) pending.push_back(idx);
+      else ++result.nUnplayable;
+    }
+
+    // the earliest time at which a match could be called; "Never"
+    // as long as a predecessor hasn't been scheduled
+    auto getReadyTime = [&](const PlannedMatch& pm)
+    {
+      time_t t = pm.earliestStart;
+      for (int p : pm.players) t = max(t, playerFree[p]);
+      for (int pre : pm.predecessors) t = max(t, finish[pre]);
+      return t;
+    };
+
+    while (!pending.empty())
+    {
+      auto itCourt = min_element(begin(courtFree), end(courtFree));
+      const time_t callTime = *itCourt + MatchTimePredictor::GraceTimeBetweenMatches_secs;
+
+      // like the operator, skip all matches that are not ready
+      // and call the first one in the queue that is
+      time_t nextReadyTime = Never;
+      auto itMatch = begin(pending);
+      for (; itMatch != end(pending); ++itMatch)
+      {
+        const time_t t = getReadyTime(matches[*itMatch]);
+        if (t <= callTime) break;
+        nextReadyTime = min(nextReadyTime, t);
+      }
+
+      // no match is ready; the court stays idle until the next one is
+      if (itMatch == end(pending))
+      {
+        if (nextReadyTime == Never) break;   // circular dependencies; shouldn't happen
+        *itCourt = nextReadyTime - MatchTimePredictor::GraceTimeBetweenMatches_secs;
+        continue;
+      }
+
+      const int idx = *itMatch;
+      pending.erase(itMatch);
+      const PlannedMatch& pm = matches[idx];
+      const time_t matchFinish = callTime + pm.duration_secs;
+
+      bool isBackToBack = false;
+      for (int p : pm.players)
+      {
+        if ((playerFree[p] > 0) && ((callTime - playerFree[p]) < cfg.backToBackWindow_secs)) isBackToBack = true;
+        playerFree[p] = matchFinish;
+      }
+      for (int pre : pm.predecessors)
+      {
+        if ((callTime - finish[pre]) < cfg.backToBackWindow_secs) isBackToBack = true;
+      }
+      if (isBackToBack) ++result.nBackToBack;
+
+      finish[idx] = matchFinish;
+      *itCourt = matchFinish;
+      result.endTime = max(result.endTime, matchFinish);
+    }
+    result.nUnplayable += static_cast<int>(pending.size());
+
+    result.cost = (result.endTime - now) + static_cast<long>(cfg.backToBackPenalty_secs) * result.nBackToBack;
+
+    return result;
+  }
+
+}
@@ -0,0 +1,140 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2019  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SCHEDULEPLANNER_H
+#define SCHEDULEPLANNER_H
+
+#include <vector>
+#include <optional>
+#include <ctime>
+#include <functional>
+
+#include "TournamentDB.h"
+#include "TournamentErrorCodes.h"
+
+namespace QTournament
+{
+  /** \brief Tuning parameters for the SchedulePlanner
+   */
+  struct SchedulePlannerConfig
+  {
+    int backToBackWindow_secs{10 * 60};   ///< a player who starts a match less than this after their previous match has no real break
+    int backToBackPenalty_secs{5 * 60};   ///< cost of one back-to-back match, expressed as additional tournament time
+    int moveWindow{8};   ///< max. number of positions a match is moved forward or backward in one step
+    int maxEvaluations{3000};   ///< upper limit for the number of simulated orders
+  };
+
+  /** \brief The predicted outcome of one match order
+   */
+  struct ScheduleEvaluation
+  {
+    time_t endTime{0};   ///< predicted finish time of the last playable match
+    int nBackToBack{0};   ///< number of matches with at least one player without a break
+    int nUnplayable{0};   ///< number of matches that can't be called with the current queue
+    long cost{0};   ///< the value that is minimized by the planner
+  };
+
+  /** \brief A proposed order of the match queue
+   */
+  struct SchedulePlan
+  {
+    std::vector<int> currentOrder;   ///< match IDs in the current order
+    std::vector<int> proposedOrder;   ///< the same match IDs in the proposed order
+    ScheduleEvaluation current;
+    ScheduleEvaluation proposed;
+    bool includesStagedGroups{false};   ///< if `true`, staged match groups have to be scheduled when applying the plan
+    int nEvaluations{0};
+
+    /** \returns `true` if the proposed order is predicted to be better than the current one
+     */
+    bool isImprovement() const { return (proposed.cost < current.cost); }
+  };
+
+  //----------------------------------------------------------------------------
+
+  /** \brief Searches for a match order that keeps all courts busy
+   *
+   * MatchTimePredictor simply plays the queue in its fixed order. In reality,
+   * matches whose players are still busy are skipped and courts may run
+   * idle if no other match is ready. The planner simulates exactly this
+   * calling behavior (same average durations per category as the predictor)
+   * and uses a local search with insertion moves to find an order with an
+   * earlier tournament end and fewer back-to-back matches for the players.
+   *
+   * The result is only a proposal; nothing is changed in the database
+   * until applyPlan() is called.
+   */
+  class SchedulePlanner
+  {
+  public:
+    SchedulePlanner(const TournamentDB& _db, const SchedulePlannerConfig& _cfg = SchedulePlannerConfig{});
+
+    /** \brief Calculates an optimized order for all matches
+     * that have a match number but haven't been called yet
+     *
+     * \param includeStagedGroups if `true`, the matches of all staged match groups
+     * are appended to the queue (in the order of their stage sequence numbers) and
+     * included in the optimization
+     *
+     * \param refTime replaces the wall clock as "now"; for simulations only
+     */
+    SchedulePlan createPlan(bool includeStagedGroups = true, std::optional<time_t> refTime = {});
+
+    /** \brief Assigns new match numbers according to a plan
+     *
+     * The queued matches swap their existing match numbers, so that
+     * no gaps are introduced in the numbering. If the plan includes staged
+     * match groups, these groups are scheduled first.
+     *
+     * \returns Error::WrongState if the queue has changed since the plan has been created
+     */
+    Error applyPlan(const SchedulePlan& plan) const;
+
+  protected:
+    struct PlannedMatch
+    {
+      int matchId;
+      int duration_secs;
+      std::vector<int> players;   ///< dense player indices
+      std::vector<int> predecessors;   ///< indices of queued matches that have to be finished first
+      time_t earliestStart;   ///< e.g., the predicted finish of a running predecessor
+      bool isPlayable;
+    };
+
+    std::vector<int> getQueuedMatchIds(bool includeStagedGroups) const;
+    void loadQueue(bool includeStagedGroups, time_t now);
+    ScheduleEvaluation evaluate(const std::vector<int>& order) const;
+
+    /** \returns `true` if moving a match from one position to another keeps
+     * all of its predecessors in front of it and all of its successors behind it
+     */
+    bool isMoveAllowed(const std::vector<int>& order, int from, int to) const;
+
+  private:
+    std::reference_wrapper<const TournamentDB> db;
+    SchedulePlannerConfig cfg;
+
+    time_t now{0};
+    std::vector<time_t> courtFreeTimes;   ///< initial court availability
+    std::vector<time_t> playerFreeTimes;   ///< initial player availability, indexed by dense player index
+    std::vector<PlannedMatch> matches;   ///< the queue in its current order
+  };
+
+}
+
+#endif // SCHEDULEPLANNER_H
@@ -324,7 +324,7 @@ std::optional<MatchScore> MatchScore::fromGameScoreListWithoutValidation(const G
   MatchScore result;
   for (GameScore game : gsl)
   {
-    result.addGame(game);
+    if (!(result.addGame(game))) return {};
   }
 
   return result;
@@ -332,36 +332,168 @@ std::optional<MatchScore> MatchScore::fromGameScoreListWithoutValidation(const G
 
 //----------------------------------------------------------------------------
 
-bool MatchScore::addGame(const GameScore& sc)
+std::optional<MatchScore> MatchScore::fromCharsWithoutValidation(std::string_view s)
 {
-  games.append(sc);
+  MatchScore result;
+
+  // reads a number with optional surrounding blanks
+  // and advances "pos" to the first character after it
+  size_t pos = 0;
+  auto readNumber = [&s, &pos]() -> int
+  {
+    while ((pos < s.size()) && (s[pos] == ' ')) ++pos;
+
+    int val = 0;
+    int nDigits = 0;
+    while ((pos < s.size()) && (s[pos] >= '0') && (s[pos] <= '9') && (nDigits < 3))
+    {
+      val = val * 10 + (s[pos] - '0');
+      ++pos;
+      ++nDigits;
+    }
+
+    while ((pos < s.size()) && (s[pos] == ' ')) ++pos;
+
+    return (nDigits > 0) ? val : -1;
+  };
+
+  // games are comma-separated, the two scores
+  // of a game are separated by a colon
+  while (true)
+  {
+    const int sc1 = readNumber();
+    if ((sc1 < 0) || (pos == s.size()) || (s[pos] != ':')) return {};
+    ++pos;
+
+    const int sc2 = readNumber();
+    if (sc2 < 0) return {};
+
+    if (!(result.addGame(sc1, sc2))) return {};
+
+    if (pos == s.size()) break;
+    if (s[pos] != ',') return {};
+    ++pos;
+  }
+
+  return result;
+}
+
+//----------------------------------------------------------------------------
+
+std::optional<MatchScore> MatchScore::fromPackedInt(int packed)
+{
+  if (packed < 0) return {};
+
+  MatchScore result;
+  while (packed != 0)
+  {
+    const int loserScore = (packed & 0x1f) - 1;
+    const bool p2Won = ((packed & 0x20) != 0);
+    packed >>= 6;
+
+    // an empty slot in front of another game results
+    // in an invalid loser score and thus in an error
+    const int winnerScore = GameScore::getWinnerScoreForLoserScore(loserScore);
+    if (winnerScore < 0) return {};
+
+    const bool isOk = p2Won ? result.addGame(loserScore, winnerScore) : result.addGame(winnerScore, loserScore);
+    if (!isOk) return {};
+  }
+
+  return result;
+}
+
+//----------------------------------------------------------------------------
+
+bool MatchScore::addGame(int sc1, int sc2)
+{
+  if (nGames == MaxNumGames) return false;
+  if (!(GameScore::isValidScore(sc1, sc2))) return false;
+
+  games[nGames] = {static_cast<uint8_t>(sc1), static_cast<uint8_t>(sc2)};
+  ++nGames;
   return true;
 }
 
 //----------------------------------------------------------------------------
 
+bool MatchScore::addGame(const GameScore& sc)
+{
+  return addGame(sc.player1Score, sc.player2Score);
+}
+
+//----------------------------------------------------------------------------
+
 bool MatchScore::addGame(const QString& scString)
 {
   auto sc = GameScore::fromString(scString);
   if (!sc.has_value()) return false;
 
-  games.append(*sc);
-  return true;
+  return addGame(*sc);
+}
+
+//----------------------------------------------------------------------------
+
+GameScoreList MatchScore::getGameScoreList() const
+{
+  GameScoreList result;
+  for (int i = 0; i < nGames; ++i)
+  {
+    result.append(GameScore{games[i][0], games[i][1]});
+  }
+
+  return result;
 }
 
 //----------------------------------------------------------------------------
 
 QString MatchScore::toString() const
 {
-  if (games.isEmpty()) return "";
+  StringBuffer buf;
+  auto s = toChars(buf);
+
+  return QString::fromLatin1(s.data(), static_cast<int>(s.size()));
+}
+
+//----------------------------------------------------------------------------
+
+std::string_view MatchScore::toChars(StringBuffer& buf) const
+{
+  size_t pos = 0;
+
+  // all scores are in the range 0...30
+  auto writeNumber = [&buf, &pos](int val)
+  {
+    if (val >= 10) buf[pos++] = static_cast<char>('0' + val / 10);
+    buf[pos++] = static_cast<char>('0' + val % 10);
+  };
 
-  QString result;
-  for (GameScore g : games)
+  for (int i = 0; i < nGames; ++i)
   {
-    result += g.toString() + ",";
+    if (i > 0) buf[pos++] = ',';
+    writeNumber(games[i][0]);
+    buf[pos++] = ':';
+    writeNumber(games[i][1]);
   }
 
-  return result.left(result.length() - 1);
+  return std::string_view{buf.data(), pos};
+}
+
+//----------------------------------------------------------------------------
+
+int MatchScore::toPackedInt() const
+{
+  int result = 0;
+  for (int i = nGames - 1; i >= 0; --i)
+  {
+    const bool p2Won = (games[i][1] > games[i][0]);
+    const int loserScore = p2Won ? games[i][0] : games[i][1];
+
+    result <<= 6;
+    result |= (loserScore + 1) | (p2Won ? 0x20 : 0);
+  }
+
+  return result;
 }
 
 //----------------------------------------------------------------------------
@@ -388,7 +520,13 @@ int MatchScore::getLoser() const
 
 std::tuple<int, int> MatchScore::getGameSum() const
 {
-  return getGameSum(games);
+  int p1Wins = 0;
+  for (int i = 0; i < nGames; ++i)
+  {
+    if (games[i][0] > games[i][1]) ++p1Wins;
+  }
+
+  return std::tuple{p1Wins, nGames - p1Wins};
 }
 
 //----------------------------------------------------------------------------
@@ -421,11 +559,10 @@ std::tuple<int, int> MatchScore::getScoreSum() const
 {
   int p1Score = 0;
   int p2Score = 0;
-  for (GameScore game : games)
+  for (int i = 0; i < nGames; ++i)
   {
-    auto sc = game.getScore();
-    p1Score += std::get<0>(sc);
-    p2Score += std::get<1>(sc);
+    p1Score += games[i][0];
+    p2Score += games[i][1];
   }
 
   return std::tuple{p1Score, p2Score};
@@ -435,7 +572,7 @@ std::tuple<int, int> MatchScore::getScoreSum() const
 
 bool MatchScore::isValidScore(int numWinGames, bool drawAllowed) const
 {
-  return isValidScore(games, numWinGames, drawAllowed);
+  return isValidScore(getGameScoreList(), numWinGames, drawAllowed);
 }
 
 //----------------------------------------------------------------------------
@@ -514,19 +651,19 @@ std::optional<MatchScore> MatchScore::genRandomScore(int numWinGames, bool drawA
 
 std::optional<GameScore> MatchScore::getGame(int n) const
 {
-  if ((n < 0) || (n > (games.count() - 1)))
+  if ((n < 0) || (n > (nGames - 1)))
   {
     return {};
   }
 
-  return games.at(n);
+  return GameScore{games[n][0], games[n][1]};
 }
 
 //----------------------------------------------------------------------------
 
 int MatchScore::getNumGames() const
 {
-  return games.count();
+  return nGames;
 }
 
 //----------------------------------------------------------------------------
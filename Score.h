@@ -21,6 +21,9 @@
 
 #include <memory>
 #include <tuple>
+#include <array>
+#include <cstdint>
+#include <string_view>
 
 #include <QString>
 #include <QList>
@@ -45,6 +48,7 @@ namespace QTournament {
     int getLoserScore() const;
 
   private:
+    friend class MatchScore;
     GameScore(int sc1, int sc2);
 
     int player1Score;
@@ -57,16 +61,56 @@ namespace QTournament {
   class MatchScore
   {
   public:
+    static constexpr int MaxNumGames = 5;   ///< maximum number of games in a match ("best of five")
+    static constexpr size_t MaxStringLength = MaxNumGames * 6 - 1;   ///< "30:29" per game plus the separating commas
+
+    /** \brief A fixed-size buffer that is large enough for the string form of any score
+     */
+    using StringBuffer = std::array<char, MaxStringLength>;
+
     static std::optional<MatchScore> fromString(const QString& s, int numWinGames=2, bool drawAllowed=false);
     static std::optional<MatchScore> fromStringWithoutValidation(const QString& s);
     static std::optional<MatchScore> fromGameScoreList(const GameScoreList& gsl, int numWinGames=2, bool drawAllowed=false);
     static std::optional<MatchScore> fromGameScoreListWithoutValidation(const GameScoreList& gsl);
+
+    /** \brief Parses the string form of a score (e.g. "21:15,19:21,21:10")
+     * without any heap allocation
+     *
+     * Like fromStringWithoutValidation(), this only checks the individual
+     * games and not whether the games form a valid match.
+     */
+    static std::optional<MatchScore> fromCharsWithoutValidation(std::string_view s);
+
+    /** \brief Restores a score from its packed integer form
+     *
+     * \returns an empty optional if the value doesn't represent
+     * a sequence of valid games
+     */
+    static std::optional<MatchScore> fromPackedInt(int packed);
+
     static bool isValidScore(const QString& s, int numWinGames=2, bool drawAllowed=false);
     static bool isValidScore(const GameScoreList& gsl, int numWinGames=2, bool drawAllowed=false);
     bool isValidScore(int numWinGames=2, bool drawAllowed=false) const;
 
     QString toString() const;
 
+    /** \brief Writes the string form of the score to a caller-provided buffer
+     *
+     * \returns a view on the used part of the buffer; it is only valid
+     * as long as the buffer exists
+     */
+    std::string_view toChars(StringBuffer& buf) const;
+
+    /** \brief Packs the score into a single, non-negative integer
+     *
+     * Each game occupies six bits, starting with the first game in the
+     * least significant bits. The lower five bits contain the loser's score
+     * plus one and the sixth bit is set if player 2 won the game; the
+     * winner's score follows from the loser's score. Unused game slots
+     * are zero.
+     */
+    int toPackedInt() const;
+
     int getWinner() const;
     int getLoser() const;
 
@@ -86,11 +130,16 @@ namespace QTournament {
 
   private:
     MatchScore() {}
+    bool addGame(int sc1, int sc2);
     bool addGame(const GameScore& sc);
     bool addGame(const QString& scString);
+    GameScoreList getGameScoreList() const;
     static GameScoreList string2GameScoreList(QString s);
 
-    GameScoreList games;
+    // player 1 and player 2 scores of all games;
+    // only the first "nGames" entries are used
+    std::array<std::array<uint8_t, 2>, MaxNumGames> games{};
+    int nGames{0};
 
   };
 
@@ -0,0 +1,197 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2019  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdexcept>
+
+#include <sqlite3.h>
+
+#include "StatementCache.h"
+#include "TournamentDataDefs.h"
+
+using namespace std;
+
+namespace QTournament
+{
+
+  StatementCache::Statement::Statement(sqlite3_stmt* _stmt, bool* _inUseFlag)
+    :stmt{_stmt}, inUseFlag{_inUseFlag}
+  {
+    if (inUseFlag != nullptr) *inUseFlag = true;
+  }
+
+  //----------------------------------------------------------------------------
+
+  StatementCache::Statement::Statement(Statement&& other)
+    :stmt{other.stmt}, inUseFlag{other.inUseFlag}
+  {
+    other.stmt = nullptr;
+    other.inUseFlag = nullptr;
+  }
+
+  //----------------------------------------------------------------------------
+
+  StatementCache::Statement::~Statement()
+  {
+    if (stmt == nullptr) return;
+
+    if (inUseFlag == nullptr)
+    {
+      sqlite3_finalize(stmt);
+      return;
+    }
+
+    // hand the statement back to the cache
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+    *inUseFlag = false;
+  }
+
+  //----------------------------------------------------------------------------
+
+  void StatementCache::Statement::bind(int idx, int val)
+  {
+    sqlite3_bind_int(stmt, idx, val);
+  }
+
+  //----------------------------------------------------------------------------
+
+  bool StatementCache::Statement::step()
+  {
+    int rc = sqlite3_step(stmt);
+    if ((rc != SQLITE_ROW) && (rc != SQLITE_DONE))
+    {
+      throw std::runtime_error{string{"StatementCache: "} + sqlite3_errmsg(sqlite3_db_handle(stmt))};
+    }
+
+    return (rc == SQLITE_ROW);
+  }
+
+  //----------------------------------------------------------------------------
+
+  int StatementCache::Statement::getInt(int col) const
+  {
+    return sqlite3_column_int(stmt, col);
+  }
+
+  //----------------------------------------------------------------------------
+
+  StatementCache::StatementCache(sqlite3* _dbPtr)
+    :dbPtr{_dbPtr}
+  {
+  }
+
+  //----------------------------------------------------------------------------
+
+  StatementCache::~StatementCache()
+  {
+    // we have to finalize all statements before
+    // the database connection can be closed
+    for (auto& [q, e] : entries)
+    {
+      sqlite3_finalize(e.stmt);
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  StatementCache::Statement StatementCache::get(CachedQuery q)
+  {
+    auto it = entries.find(static_cast<int>(q));
+    if (it == entries.end())
+    {
+      it = entries.emplace(static_cast<int>(q), Entry{prepare(q), false}).first;
+      return Statement{it->second.stmt, &(it->second.inUse)};
+    }
+
+    // the cached statement is busy; use a temporary one
+    if (it->second.inUse)
+    {
+      return Statement{prepare(q), nullptr};
+    }
+
+    ++hitCount;
+    return Statement{it->second.stmt, &(it->second.inUse)};
+  }
+
+  //----------------------------------------------------------------------------
+
+  int StatementCache::getReprepareCount() const
+  {
+    int result{0};
+    for (const auto& [q, e] : entries)
+    {
+      result += sqlite3_stmt_status(e.stmt, SQLITE_STMTSTATUS_REPREPARE, 0);
+    }
+
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+  string StatementCache::getSql(CachedQuery q)
+  {
+    switch (q)
+    {
+    case CachedQuery::ScheduledMatchesForPlayer:
+      return "SELECT id FROM " TabMatch " WHERE " MA_Num " > 0"
+             " AND " GenericStateFieldName " != " + to_string(static_cast<int>(ObjState::MA_Running)) +
+             " AND " GenericStateFieldName " != " + to_string(static_cast<int>(ObjState::MA_Finished)) +
+             " AND (" MA_Pair1Ref " IN (SELECT id FROM " TabPairs " WHERE " Pairs_Player1Ref " = ?1 OR " Pairs_Player2Ref " = ?1)"
+             " OR " MA_Pair2Ref " IN (SELECT id FROM " TabPairs " WHERE " Pairs_Player1Ref " = ?1 OR " Pairs_Player2Ref " = ?1))"
+             " ORDER BY " MA_Num " ASC";
+
+    case CachedQuery::MatchForPairAndRound:
+      return "SELECT id FROM " TabMatch " WHERE (" MA_Pair1Ref " = ?1 OR " MA_Pair2Ref " = ?1)"
+             " AND " MA_GrpRef " IN (SELECT id FROM " TabMatchGroup " WHERE " MG_Round " = ?2"
+             " AND " MG_CatRef " = (SELECT " Pairs_CatRef " FROM " TabPairs " WHERE id = ?1)) LIMIT 1";
+
+    case CachedQuery::MatchesForPlayer:
+      return "SELECT id, IFNULL(" MA_Num ", " + to_string(MatchNumNotAssigned) + ") FROM " TabMatch " WHERE"
+             " " MA_Pair1Ref " IN (SELECT id FROM " TabPairs " WHERE " Pairs_Player1Ref " = ?1 OR " Pairs_Player2Ref " = ?1)"
+             " OR " MA_Pair2Ref " IN (SELECT id FROM " TabPairs " WHERE " Pairs_Player1Ref " = ?1 OR " Pairs_Player2Ref " = ?1)"
+             " OR " MA_ActualPlayer1aRef " = ?1 OR " MA_ActualPlayer1bRef " = ?1"
+             " OR " MA_ActualPlayer2aRef " = ?1 OR " MA_ActualPlayer2bRef " = ?1";
+
+    case CachedQuery::UnfinishedPredecessorOfMatch:
+      return "SELECT d." MD_PredecessorRef " FROM " TabMatchDependency " d JOIN " TabMatch " p ON p.id = d." MD_PredecessorRef
+             " WHERE d." MD_MatchRef " = ?1 AND p." GenericStateFieldName " != " + to_string(static_cast<int>(ObjState::MA_Finished)) +
+             " LIMIT 1";
+    }
+
+    return "";
+  }
+
+  //----------------------------------------------------------------------------
+
+  sqlite3_stmt* StatementCache::prepare(CachedQuery q)
+  {
+    const string sql = getSql(q);
+
+    sqlite3_stmt* stmt{nullptr};
+    int rc = sqlite3_prepare_v3(dbPtr, sql.c_str(), static_cast<int>(sql.size()) + 1, SQLITE_PREPARE_PERSISTENT, &stmt, nullptr);
+    if (rc != SQLITE_OK)
+    {
+      sqlite3_finalize(stmt);
+      throw std::runtime_error{"StatementCache: could not prepare " + sql + ": " + sqlite3_errmsg(dbPtr)};
+    }
+
+    ++prepareCount;
+    return stmt;
+  }
+
+}
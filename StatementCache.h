@@ -0,0 +1,131 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2019  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STATEMENTCACHE_H
+#define STATEMENTCACHE_H
+
+#include <string>
+#include <unordered_map>
+
+struct sqlite3;
+struct sqlite3_stmt;
+
+namespace QTournament
+{
+  /** \brief Named, parameterized queries for hot code paths
+   *
+   * The parameters are documented as "?n" along with each query.
+   */
+  enum class CachedQuery
+  {
+    ScheduledMatchesForPlayer,   ///< ?1 = player ID; IDs of all matches with a match number that are neither running nor finished, sorted by match number
+    MatchForPairAndRound,   ///< ?1 = pair ID, ?2 = round; ID of the pair's match in that round
+    MatchesForPlayer,   ///< ?1 = player ID; IDs and match numbers (MatchNumNotAssigned if none) of all matches with the player as a pair member or as an actual player
+    UnfinishedPredecessorOfMatch,   ///< ?1 = match ID; ID of a predecessor of the match that is not yet finished
+  };
+
+  //----------------------------------------------------------------------------
+
+  /** \brief A registry of prepared statements for frequently used queries
+   *
+   * Each statement is prepared once per database connection and then only
+   * bound and reset. This saves parsing and planning the same SQL text
+   * over and over again.
+   */
+  class StatementCache
+  {
+  public:
+    /** \brief A cached statement that is borrowed from the cache
+     *
+     * The statement is reset and its bindings are cleared when the
+     * handle goes out of scope.
+     */
+    class Statement
+    {
+    public:
+      Statement(const Statement&) = delete;
+      Statement& operator=(const Statement&) = delete;
+      Statement(Statement&& other);
+      Statement& operator=(Statement&& other) = delete;
+      ~Statement();
+
+      void bind(int idx, int val);
+
+      /** \brief Executes the next step of the statement
+       *
+       * \returns `true` if a result row is available
+       */
+      bool step();
+
+      int getInt(int col) const;
+
+    private:
+      friend class StatementCache;
+      Statement(sqlite3_stmt* _stmt, bool* _inUseFlag);
+
+      sqlite3_stmt* stmt;
+      bool* inUseFlag;   ///< nullptr for temporary statements that are finalized afterwards
+    };
+
+    explicit StatementCache(sqlite3* _dbPtr);
+    ~StatementCache();
+    StatementCache(const StatementCache&) = delete;
+    StatementCache& operator=(const StatementCache&) = delete;
+
+    /** \brief Provides the prepared statement for a named query
+     *
+     * If the statement is already in use (e.g., in a recursive call),
+     * a temporary statement is prepared instead.
+     *
+     * \throws std::runtime_error if the statement can't be prepared
+     */
+    Statement get(CachedQuery q);
+
+    /** \returns the number of requests that could be served by an already prepared statement
+     */
+    int getHitCount() const { return hitCount; }
+
+    /** \returns the number of calls to sqlite3_prepare() by this cache
+     */
+    int getPrepareCount() const { return prepareCount; }
+
+    /** \returns the number of automatic re-prepares by SQLite, e.g., after schema changes
+     */
+    int getReprepareCount() const;
+
+    static std::string getSql(CachedQuery q);
+
+  protected:
+    sqlite3_stmt* prepare(CachedQuery q);
+
+  private:
+    struct Entry
+    {
+      sqlite3_stmt* stmt;
+      bool inUse;
+    };
+
+    sqlite3* dbPtr;
+    std::unordered_map<int, Entry> entries;
+    int hitCount{0};
+    int prepareCount{0};
+  };
+
+}
+
+#endif // STATEMENTCACHE_H
@@ -248,6 +248,7 @@ namespace QTournament
     //
     // "no future match" can mean player "eliminated" or "ranked"
     MatchMngr mm{db};
+    const PairRoundMatchMap matchMap = mm.getMatchesByPairAndRound(*this);
     for (MatchGroup mg : mm.getMatchGroupsForCat(*this, round))
     {
       for (Match ma : mg.getMatches())
@@ -286,13 +287,9 @@ namespace QTournament
         DbTab matchTab{db, TabMatch, false};
         auto hasFutureMatch = [&](const PlayerPair& pp, bool asWinner) {
           // step 1: search by pair
-          for (int r=round+1; r <= lastRoundInThisCat; ++r)
+          if (matchMap.getFirstMatchInRounds(pp, round+1, lastRoundInThisCat))
           {
-            auto next = mm.getMatchForPlayerPairAndRound(pp, r);
-            if (next)
-            {
-              return true;
-            }
+            return true;
           }
 
           // step 2: search for "is winner of" or "is loser of"
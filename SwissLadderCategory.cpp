@@ -29,6 +29,7 @@
 #include "PlayerMngr.h"
 #include "CentralSignalEmitter.h"
 #include "SwissLadderGenerator.h"
+#include "SwissLadderState.h"
 #include "MatchMngr.h"
 
 using namespace std;
@@ -61,8 +62,8 @@ namespace QTournament
     }
 
     // create the input data for the SwissLadderGenerator:
-    // a list of ranked player pairs and a list of all
-    // matches played so far
+    // a list of ranked player pairs and the persisted state
+    // with all matches played so far
     PlayerPairList rankedPairs;
     std::vector<int> rankedPairs_Int;
     CatMngr cm{db};
@@ -87,30 +88,14 @@ namespace QTournament
     int pairCount = rankedPairs.size();
     assert(pairCount == getPlayerPairs().size());
 
+    // the state has been updated by MatchMngr with every
+    // finished match, so we don't need to scan all matches here
     MatchMngr mm{db};
-    std::vector<std::tuple<int,int>> pastMatches;
-    for (MatchGroup mg : mm.getMatchGroupsForCat(*this))
-    {
-      for (Match ma : mg.getMatches())
-      {
-        // ignore unfinished matches. However, there
-        // shouldn't be any when this function is called
-        if (ma.is_NOT_InState(ObjState::MA_Finished))
-        {
-          continue;
-        }
-
-        // store the match as CSV-strings of the
-        // playerpair combinations
-        int pp1Id = ma.getPlayerPair1().getPairId();
-        int pp2Id = ma.getPlayerPair2().getPairId();
-        pastMatches.push_back(make_tuple(pp1Id, pp2Id));
-      }
-    }
+    const SwissLadderState state = SwissLadderState::load(db, getId());
 
     // instantiate the SwissLadderGenerator and let it
     // generate the next set of matches
-    SwissLadderGenerator slg{rankedPairs_Int, pastMatches};
+    SwissLadderGenerator slg{rankedPairs_Int, state};
     std::vector<std::tuple<int, int>> nextMatches;
     int errCode = slg.getNextMatches(nextMatches);
 
@@ -195,13 +180,15 @@ namespace QTournament
 
     // deletion 2a: matches of future match groups (rounds > last finished round; equivalent to: groups that are not yet FINISHED)
     // deletion 2b: match groups for these future matches
+    MatchGroupList futureGroups;
     for (const MatchGroup& mg : mm.getMatchGroupsForCat(*this))
     {
       if (mg.is_NOT_InState(ObjState::MG_Finished))
       {
-        mm.deleteMatchGroupAndMatch(mg);
+        futureGroups.push_back(mg);
       }
     }
+    mm.deleteMatchGroupsAndMatches(futureGroups);
 
     //
     // deletion completed
@@ -295,6 +282,10 @@ namespace QTournament
       mm.closeMatchGroup(*mg);
     }
 
+    // start with a clean list of played matches, just in case
+    // there are leftovers from a deleted category with the same ID
+    SwissLadderState::reset(db, getId());
+
     // Fill the first round of matches based on the initial seeding
     genMatchesForNextRound();
 
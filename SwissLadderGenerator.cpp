@@ -24,10 +24,17 @@ namespace QTournament
 {
 
   SwissLadderGenerator::SwissLadderGenerator(const std::vector<int>& _ranking, const std::vector<std::tuple<int, int> >& _pastMatches)
-    :ranking{_ranking}, pastMatches{_pastMatches}, nPairs{_ranking.size()}
+    :SwissLadderGenerator(_ranking, SwissLadderState{_pastMatches})
+  {
+  }
+
+  //----------------------------------------------------------------------------
+
+  SwissLadderGenerator::SwissLadderGenerator(const std::vector<int>& _ranking, const SwissLadderState& _state)
+    :ranking{_ranking}, state{_state}, nPairs{_ranking.size()}
   {
     // no consistency checks here (e.g., do the PlayerPairIDs
-    // in _ranking match those in _pastMatches). Just make sure that
+    // in _ranking match those in _state). Just make sure that
     // ranking is not empty
     if (ranking.empty())
     {
@@ -38,27 +45,13 @@ namespace QTournament
     matchesPerRound = ((nPairs % 2) == 0) ? nPairs / 2 : (nPairs - 1) / 2;
 
     // determine the number of rounds that have been played
-    roundsPlayed = pastMatches.size() / matchesPerRound;
+    roundsPlayed = state.size() / matchesPerRound;
 
     // cross-check to ensure that the size of pastMatches is consistent
-    if ((roundsPlayed * matchesPerRound) != pastMatches.size())
+    if ((roundsPlayed * matchesPerRound) != state.size())
     {
       throw std::invalid_argument("SwissLadderGenerator: inconsistent size of list of past matches");
     }
-
-    // count the number of matches that each player already has played
-    for (const std::tuple<int, int>& m : pastMatches)
-    {
-      int pp1Id = get<0>(m);
-      int pp2Id = get<1>(m);
-
-      int& ref1 = matchCount[pp1Id];
-      ++ref1;
-
-      int& ref2 = matchCount[pp2Id];
-      ++ref2;
-    }
-
   }
 
   //----------------------------------------------------------------------------
@@ -219,15 +212,7 @@ namespace QTournament
 
   bool SwissLadderGenerator::hasMatchBeenPlayed(int pair1Id, int pair2Id) const
   {
-    std::tuple<int, int> regular{pair1Id, pair2Id};
-    std::tuple<int, int> swapped{pair2Id, pair1Id};
-
-    auto it = find_if(pastMatches.cbegin(), pastMatches.cend(), [&](const std::tuple<int, int>& m) {
-      if (m == regular) return true;
-      return (m == swapped);
-    });
-
-    return (it != pastMatches.cend());
+    return state.hasMatchBeenPlayed(pair1Id, pair2Id);
   }
 
   //----------------------------------------------------------------------------
@@ -248,7 +233,7 @@ namespace QTournament
     while (nextByeRank >= 0)
     {
       int ppId = ranking[nextByeRank];
-      int nRounds = matchCount[ppId];
+      int nRounds = state.getMatchCount(ppId);
 
       // if the player has participated in all rounds
       // so far, this player will get the next bye
@@ -343,16 +328,17 @@ namespace QTournament
     // Algorithm:
     //
     // Step 1: determine all matches for this category (means: all player pair combinations)
-    // Step 2: subtract what has been played in the previous rounds (pastMatches)
-    // Step 3: subtract what is to be played in the next round (nextMatches)
-    // Step 4: check if the remaining matches allow for at least one more round
+    //         that have not been played in the previous rounds
+    // Step 2: subtract what is to be played in the next round (nextMatches)
+    // Step 3: check if the remaining matches allow for at least one more round
     //
-    // Do steps 1 and 2 only once to avoid too many computations
+    // Do step 1 only once to avoid too many computations
 
     if (remainingMatches.empty())
     {
       //
-      // Step 1: determine all matches and store them in "remainingMatches"
+      // Step 1: determine all unplayed matches and store them in "remainingMatches";
+      // the opponent graph in "state" tells us in O(1) whether a match has been played
       //
       for (size_t idxFirst = 0; idxFirst < (ranking.size() - 1); ++idxFirst)
       {
@@ -361,30 +347,14 @@ namespace QTournament
         for (size_t idxSecond = idxFirst + 1; idxSecond < ranking.size(); ++idxSecond)
         {
           int idSecond = ranking[idxSecond];
+          if (state.hasMatchBeenPlayed(idFirst, idSecond)) continue;
           remainingMatches.push_back(make_tuple(idFirst, idSecond));
         }
       }
-
-      //
-      // Step 2: subtract already played matches
-      //
-      for (tuple<int, int>& m : pastMatches)
-      {
-        std::tuple<int, int> swapped = make_tuple(get<1>(m), get<0>(m));
-        auto it = find(remainingMatches.begin(), remainingMatches.end(), m);
-        if (it == remainingMatches.end())
-        {
-          it = find(remainingMatches.begin(), remainingMatches.end(), swapped);
-        }
-        if (it != remainingMatches.end())
-        {
-          remainingMatches.erase(it);
-        }
-      }
     }
 
     //
-    // Step 3: subtract next matches
+    // Step 2: subtract next matches
     //
     std::vector<std::tuple<int, int>> remain = remainingMatches;
     for (const std::tuple<int, int>& m : nextMatches)
@@ -402,7 +372,7 @@ namespace QTournament
     }
 
     //
-    // Step 4: check if we can create at least one more round from the
+    // Step 3: check if we can create at least one more round from the
     // remaining matches
     //
     return !(canBuildAnotherRound(remain, nextMatches));
@@ -543,7 +513,11 @@ namespace QTournament
 
   std::vector<int> SwissLadderGenerator::getPotentialByePairs(const std::vector<std::tuple<int, int> >& optionalAdditionalMatches) const
   {
-    unordered_map<int, int> matchCountCopy = matchCount;
+    unordered_map<int, int> matchCountCopy;
+    for (int ppId : ranking)
+    {
+      matchCountCopy[ppId] = state.getMatchCount(ppId);
+    }
 
     for (const std::tuple<int, int>& m : optionalAdditionalMatches)
     {
@@ -27,6 +27,8 @@
 
 #include <QList>
 
+#include "SwissLadderState.h"
+
 namespace QTournament
 {
   class SwissLadderGenerator
@@ -36,6 +38,7 @@ namespace QTournament
     static constexpr int NO_MORE_ROUNDS = -1;
     static constexpr int DEADLOCK = -2;
     SwissLadderGenerator(const std::vector<int>& _ranking, const std::vector<std::tuple<int, int>>& _pastMatches);
+    SwissLadderGenerator(const std::vector<int>& _ranking, const SwissLadderState& _state);
     int getNextMatches(std::vector<std::tuple<int, int>>& resultVector);
 
   protected:
@@ -51,11 +54,10 @@ namespace QTournament
 
   private:
     std::vector<int> ranking;
-    std::vector<std::tuple<int, int>> pastMatches;
+    SwissLadderState state;
     int roundsPlayed;
     int matchesPerRound;
     size_t nPairs;
-    std::unordered_map<int, int> matchCount;
     std::vector<std::tuple<int, int>> remainingMatches;  // will be initialized upon the first call of matchSelectionCausesDeadlock()
   };
 
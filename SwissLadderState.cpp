@@ -0,0 +1,193 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2019  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <SqliteOverlay/KeyValueTab.h>
+
+#include <Sloppy/String.h>
+
+#include "SwissLadderState.h"
+#include "TournamentDB.h"
+#include "TournamentDataDefs.h"
+
+using namespace std;
+
+namespace QTournament
+{
+
+  SwissLadderState::SwissLadderState(const vector<tuple<int, int>>& _pastMatches)
+  {
+    for (const auto& [pp1Id, pp2Id] : _pastMatches)
+    {
+      addMatch(pp1Id, pp2Id);
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  void SwissLadderState::addMatch(int pair1Id, int pair2Id)
+  {
+    pastMatches.push_back(make_tuple(pair1Id, pair2Id));
+    opponents[pair1Id].insert(pair2Id);
+    opponents[pair2Id].insert(pair1Id);
+    ++matchCount[pair1Id];
+    ++matchCount[pair2Id];
+  }
+
+  //----------------------------------------------------------------------------
+
+  bool SwissLadderState::hasMatchBeenPlayed(int pair1Id, int pair2Id) const
+  {
+    auto it = opponents.find(pair1Id);
+    if (it == opponents.end()) return false;
+
+    return (it->second.find(pair2Id) != it->second.end());
+  }
+
+  //----------------------------------------------------------------------------
+
+  int SwissLadderState::getMatchCount(int pairId) const
+  {
+    auto it = matchCount.find(pairId);
+    return (it == matchCount.end()) ? 0 : it->second;
+  }
+
+  //----------------------------------------------------------------------------
+
+  string SwissLadderState::toString() const
+  {
+    // format: "pp1,pp2:pp1,pp2:..."
+    Sloppy::StringList matchStr;
+    for (const auto& [pp1Id, pp2Id] : pastMatches)
+    {
+      matchStr.push_back(to_string(pp1Id) + "," + to_string(pp2Id));
+    }
+
+    return Sloppy::estring{matchStr, ":"};
+  }
+
+  //----------------------------------------------------------------------------
+
+  SwissLadderState SwissLadderState::fromString(const string& s)
+  {
+    SwissLadderState result;
+
+    Sloppy::estring es{s};
+    try
+    {
+      for (const auto& m : es.split(":", false, true))
+      {
+        auto ids = m.split(",", false, true);
+        if (ids.size() != 2) return SwissLadderState{};
+
+        result.addMatch(stoi(ids[0]), stoi(ids[1]));
+      }
+    }
+    catch (...)
+    {
+      return SwissLadderState{};
+    }
+
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+  SwissLadderState SwissLadderState::load(const TournamentDB& db, int catId)
+  {
+    SqliteOverlay::KeyValueTab cfg{db, TabCfg};
+    auto s = cfg.getString2(cfgKeyForCat(catId));
+    SwissLadderState result = s ? fromString(*s) : SwissLadderState{};
+
+    // a cheap consistency check: the persisted state has
+    // to contain all finished matches of the category
+    Sloppy::estring sql{"SELECT COUNT(*) FROM %1 m JOIN %2 g ON m.%3 = g.id WHERE g.%4 = %5 AND m.%6 = %7"};
+    sql.arg(TabMatch);
+    sql.arg(TabMatchGroup);
+    sql.arg(MA_GrpRef);
+    sql.arg(MG_CatRef);
+    sql.arg(catId);
+    sql.arg(GenericStateFieldName);
+    sql.arg(static_cast<int>(ObjState::MA_Finished));
+    if (db.execScalarQueryInt(sql) == static_cast<int>(result.size())) return result;
+
+    result = fromMatchTable(db, catId);
+    cfg.set(cfgKeyForCat(catId), result.toString());
+
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+  void SwissLadderState::recordFinishedMatch(const TournamentDB& db, int catId, int pair1Id, int pair2Id)
+  {
+    SqliteOverlay::KeyValueTab cfg{db, TabCfg};
+    const string key = cfgKeyForCat(catId);
+
+    // simply append the new match; there's no need
+    // to parse the existing state
+    string s = cfg.getString2(key).value_or("");
+    if (!s.empty()) s += ":";
+    s += to_string(pair1Id) + "," + to_string(pair2Id);
+
+    cfg.set(key, s);
+  }
+
+  //----------------------------------------------------------------------------
+
+  void SwissLadderState::reset(const TournamentDB& db, int catId)
+  {
+    SqliteOverlay::KeyValueTab cfg{db, TabCfg};
+    cfg.set(cfgKeyForCat(catId), string{});
+  }
+
+  //----------------------------------------------------------------------------
+
+  string SwissLadderState::cfgKeyForCat(int catId)
+  {
+    return CfgKey_StatePrefix + to_string(catId);
+  }
+
+  //----------------------------------------------------------------------------
+
+  SwissLadderState SwissLadderState::fromMatchTable(const TournamentDB& db, int catId)
+  {
+    // one query for all finished matches of the category
+    Sloppy::estring sql{"SELECT m.%1, m.%2 FROM %3 m JOIN %4 g ON m.%5 = g.id "
+                        "WHERE g.%6 = %7 AND m.%8 = %9"};
+    sql.arg(MA_Pair1Ref);
+    sql.arg(MA_Pair2Ref);
+    sql.arg(TabMatch);
+    sql.arg(TabMatchGroup);
+    sql.arg(MA_GrpRef);
+    sql.arg(MG_CatRef);
+    sql.arg(catId);
+    sql.arg(GenericStateFieldName);
+    sql.arg(static_cast<int>(ObjState::MA_Finished));
+    sql += " ORDER BY g." MG_Round ", m.id";
+
+    SwissLadderState result;
+    auto stmt = db.prepStatement(sql);
+    for (stmt.step(); stmt.hasData(); stmt.step())
+    {
+      result.addMatch(stmt.getInt(0), stmt.getInt(1));
+    }
+
+    return result;
+  }
+
+}
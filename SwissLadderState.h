@@ -0,0 +1,93 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2019  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SWISSLADDERSTATE_H
+#define SWISSLADDERSTATE_H
+
+#include <string>
+#include <vector>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace QTournament
+{
+  class TournamentDB;
+
+  /** \brief The pairings that have already been played in a Swiss ladder category
+   *
+   * Contains the list of played matches along with an opponent graph
+   * for O(1) lookups of past pairings and per-pair match counts.
+   *
+   * The state is persisted in the config table and extended by MatchMngr
+   * whenever a match of a Swiss ladder category is finished. Generating the
+   * next round thus doesn't require iterating over all matches of the category.
+   */
+  class SwissLadderState
+  {
+  public:
+    static constexpr const char* CfgKey_StatePrefix = "SwissLadderState_";
+
+    SwissLadderState() = default;
+    explicit SwissLadderState(const std::vector<std::tuple<int, int>>& _pastMatches);
+
+    void addMatch(int pair1Id, int pair2Id);
+
+    /** \returns `true` if the two pairs have already played against each other, regardless of the order
+     */
+    bool hasMatchBeenPlayed(int pair1Id, int pair2Id) const;
+
+    /** \returns the number of matches that a pair has played so far
+     */
+    int getMatchCount(int pairId) const;
+
+    const std::vector<std::tuple<int, int>>& getPastMatches() const { return pastMatches; }
+    size_t size() const { return pastMatches.size(); }
+
+    std::string toString() const;
+    static SwissLadderState fromString(const std::string& s);
+
+    /** \brief Loads the persisted state of a category
+     *
+     * If the persisted state is missing or doesn't match the number
+     * of finished matches in the category (e.g., for databases created
+     * by older versions), it is rebuilt from the match table and stored.
+     */
+    static SwissLadderState load(const TournamentDB& db, int catId);
+
+    /** \brief Adds a finished match to the persisted state of its category
+     */
+    static void recordFinishedMatch(const TournamentDB& db, int catId, int pair1Id, int pair2Id);
+
+    /** \brief Clears the persisted state of a category, e.g. when the category starts
+     */
+    static void reset(const TournamentDB& db, int catId);
+
+  protected:
+    static std::string cfgKeyForCat(int catId);
+    static SwissLadderState fromMatchTable(const TournamentDB& db, int catId);
+
+  private:
+    std::vector<std::tuple<int, int>> pastMatches;   ///< in the order in which they have been finished
+    std::unordered_map<int, std::unordered_set<int>> opponents;   ///< pair ID --> IDs of all pairs it has played against
+    std::unordered_map<int, int> matchCount;   ///< pair ID --> number of played matches
+  };
+
+}
+
+#endif // SWISSLADDERSTATE_H
@@ -0,0 +1,250 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2019  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdexcept>
+#include <map>
+
+#include "SyncShadow.h"
+
+using namespace std;
+
+namespace QTournament
+{
+  namespace
+  {
+    // one "table:count" block of a sync string
+    struct SyncBlock
+    {
+      string tabName;
+      vector<string> colNames;
+      vector<vector<string>> rows;   ///< raw CSV fields
+    };
+
+    //----------------------------------------------------------------------------
+
+    // reads one CSV record starting at "pos"; commas and line breaks
+    // within double quotes are part of the field. The fields are returned
+    // verbatim (including quotes and escapes) so that they can be compared
+    // and re-emitted without any conversion
+    vector<string> nextRecord(const string& s, size_t& pos)
+    {
+      vector<string> result;
+      string field;
+      bool inQuotes{false};
+      while (pos < s.size())
+      {
+        const char c = s[pos++];
+
+        if (inQuotes)
+        {
+          field += c;
+          if ((c == '\\') && (pos < s.size()))
+          {
+            field += s[pos++];
+          } else if (c == '"') {
+            inQuotes = false;   // a doubled quote re-enters with the next character
+          }
+          continue;
+        }
+
+        if (c == '\n') break;
+        if (c == ',')
+        {
+          result.push_back(std::move(field));
+          field.clear();
+          continue;
+        }
+        if (c == '"') inQuotes = true;
+        field += c;
+      }
+      result.push_back(std::move(field));
+
+      return result;
+    }
+
+    //----------------------------------------------------------------------------
+
+    vector<SyncBlock> parseSyncString(const string& s)
+    {
+      vector<SyncBlock> result;
+      size_t pos{0};
+      while (pos < s.size())
+      {
+        const auto hdr = nextRecord(s, pos);
+        if ((hdr.size() == 1) && hdr[0].empty()) continue;
+
+        const size_t colon = hdr[0].rfind(':');
+        if ((hdr.size() != 1) || (colon == string::npos))
+        {
+          throw std::invalid_argument{"SyncShadow: invalid block header: " + hdr[0]};
+        }
+
+        SyncBlock blk;
+        blk.tabName = hdr[0].substr(0, colon);
+        const int cnt = stoi(hdr[0].substr(colon + 1));
+        blk.colNames = nextRecord(s, pos);
+        for (int i = 0; (i < cnt) && (pos < s.size()); ++i)
+        {
+          blk.rows.push_back(nextRecord(s, pos));
+        }
+        if (static_cast<int>(blk.rows.size()) != cnt)
+        {
+          throw std::invalid_argument{"SyncShadow: truncated block for table " + blk.tabName};
+        }
+
+        result.push_back(std::move(blk));
+      }
+
+      return result;
+    }
+
+    //----------------------------------------------------------------------------
+
+    // deletions are sent as a single, negative row ID
+    bool isDeletion(const vector<string>& row)
+    {
+      return ((row.size() == 1) && !row[0].empty() && (row[0][0] == '-'));
+    }
+
+    //----------------------------------------------------------------------------
+
+    int rowIdOf(const vector<string>& row)
+    {
+      string f = row[0];
+      if ((f.size() >= 2) && (f.front() == '"') && (f.back() == '"')) f = f.substr(1, f.size() - 2);
+      return stoi(f);
+    }
+
+    //----------------------------------------------------------------------------
+
+    string blockHeader(const string& tabName, size_t cnt)
+    {
+      return tabName + ":" + to_string(cnt) + "\n";
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  string SyncShadow::encodeDelta(const string& fullRowSync) const
+  {
+    string result;
+    for (const SyncBlock& blk : parseSyncString(fullRowSync))
+    {
+      // the shadow can only be used if it has
+      // been created with the same columns
+      const TableShadow* ts{nullptr};
+      auto itTab = tables.find(blk.tabName);
+      if ((itTab != tables.end()) && (itTab->second.colNames == blk.colNames)) ts = &(itTab->second);
+
+      // group the rows by their set of changed columns;
+      // the map key are the column indices
+      map<vector<size_t>, vector<string>> groups;
+      vector<vector<size_t>> groupOrder;
+      vector<string> deletions;
+      for (const auto& row : blk.rows)
+      {
+        if (isDeletion(row))
+        {
+          deletions.push_back(row[0]);
+          continue;
+        }
+
+        const vector<string>* prev{nullptr};
+        if (ts != nullptr)
+        {
+          auto itRow = ts->rows.find(rowIdOf(row));
+          if ((itRow != ts->rows.end()) && (itRow->second.size() == row.size())) prev = &(itRow->second);
+        }
+
+        vector<size_t> changedCols;
+        for (size_t col = 1; col < row.size(); ++col)
+        {
+          if ((prev == nullptr) || ((*prev)[col] != row[col])) changedCols.push_back(col);
+        }
+        if (changedCols.empty() && (prev != nullptr)) continue;
+
+        string line = row[0];
+        for (size_t col : changedCols) line += "," + row[col];
+
+        auto itGroup = groups.find(changedCols);
+        if (itGroup == groups.end())
+        {
+          groupOrder.push_back(changedCols);
+          itGroup = groups.emplace(changedCols, vector<string>{}).first;
+        }
+        itGroup->second.push_back(std::move(line));
+      }
+
+      for (const auto& cols : groupOrder)
+      {
+        const auto& lines = groups.at(cols);
+        result += blockHeader(blk.tabName, lines.size());
+        result += blk.colNames[0];
+        for (size_t col : cols) result += "," + blk.colNames[col];
+        result += "\n";
+        for (const string& line : lines) result += line + "\n";
+      }
+
+      if (!deletions.empty())
+      {
+        result += blockHeader(blk.tabName, deletions.size());
+        result += blk.colNames[0] + "\n";
+        for (const string& d : deletions) result += d + "\n";
+      }
+    }
+
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+  void SyncShadow::apply(const string& fullRowSync)
+  {
+    for (SyncBlock& blk : parseSyncString(fullRowSync))
+    {
+      TableShadow& ts = tables[blk.tabName];
+      if (ts.colNames != blk.colNames)
+      {
+        ts.colNames = std::move(blk.colNames);
+        ts.rows.clear();
+      }
+
+      for (auto& row : blk.rows)
+      {
+        if (isDeletion(row))
+        {
+          ts.rows.erase(-rowIdOf(row));
+          continue;
+        }
+
+        const int id = rowIdOf(row);
+        ts.rows[id] = std::move(row);
+      }
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  size_t SyncShadow::getRowCount() const
+  {
+    size_t result{0};
+    for (const auto& [tabName, ts] : tables) result += ts.rows.size();
+
+    return result;
+  }
+}
@@ -0,0 +1,74 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2019  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYNCSHADOW_H
+#define SYNCSHADOW_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace QTournament
+{
+  /** \brief The server's view of the tournament data for column-level delta syncs
+   *
+   * The shadow holds the raw CSV fields of all rows that have been sent to the
+   * server. It is filled from the full sync and updated after each successful
+   * partial sync.
+   *
+   * encodeDelta() takes a regular sync string with complete rows (as produced
+   * by the managers' getSyncString()) and reduces each row to the columns that
+   * differ from the shadow. The result uses the same block format as the regular
+   * sync string ("table:count", column names, rows), but each table can have
+   * several blocks with different column lists:
+   *   - rows with identical changed columns share one block;
+   *   - rows that are unknown to the shadow are sent completely;
+   *   - unchanged rows are omitted;
+   *   - deletions go into a block with only the "id" column.
+   */
+  class SyncShadow
+  {
+  public:
+    /** \returns the delta-encoded version of a sync string with
+     * complete rows; the shadow itself remains unchanged
+     */
+    std::string encodeDelta(const std::string& fullRowSync) const;
+
+    /** \brief Updates the shadow with the rows of a sync string
+     * that has been accepted by the server
+     */
+    void apply(const std::string& fullRowSync);
+
+    void clear() { tables.clear(); }
+
+    /** \returns the number of rows in the shadow
+     */
+    size_t getRowCount() const;
+
+  private:
+    struct TableShadow
+    {
+      std::vector<std::string> colNames;
+      std::unordered_map<int, std::vector<std::string>> rows;   ///< row ID --> raw CSV fields
+    };
+
+    std::unordered_map<std::string, TableShadow> tables;
+  };
+}
+
+#endif // SYNCSHADOW_H
@@ -0,0 +1,161 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2019  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <vector>
+
+#include "SyncString.h"
+#include "TournamentDataDefs.h"
+#include "TeamMngr.h"
+#include "CourtMngr.h"
+#include "CatMngr.h"
+#include "MatchMngr.h"
+#include "PlayerMngr.h"
+#include "RankingMngr.h"
+
+using namespace std;
+
+namespace QTournament
+{
+
+  string getFullSyncString(const TournamentDB& srcDb)
+  {
+    string csv;
+
+    // courts
+    CourtMngr cm{srcDb};
+    csv += cm.getSyncString({});
+
+    // Teams
+    TeamMngr tm{srcDb};
+    csv += tm.getSyncString({});
+
+    // players
+    PlayerMngr pm{srcDb};
+    csv += pm.getSyncString({});
+    csv += pm.getSyncString_P2C({});
+    csv += pm.getSyncString_Pairs({});
+
+    // categories
+    CatMngr caMngr{srcDb};
+    csv += caMngr.getSyncString({});
+
+    // matches
+    MatchMngr mm{srcDb};
+    csv += mm.getSyncString({});
+    csv += mm.getSyncString_MatchGroups({});
+
+    // rankings
+    RankingMngr rm{srcDb};
+    csv += rm.getSyncString({});
+
+    return csv;
+  }
+
+  //----------------------------------------------------------------------------
+
+  string getSyncStringForChanges(const TournamentDB& db, const SqliteOverlay::ChangeLogList& log)
+  {
+    // copy the log
+    SqliteOverlay::ChangeLogList cll = log;
+
+    // sort copied entries by table name
+    std::stable_sort(cll.begin(), cll.end(), [](const SqliteOverlay::ChangeLogEntry& e1, const SqliteOverlay::ChangeLogEntry& e2)
+    {
+      return (e1.tabName < e2.tabName);
+    });
+
+    // append a dummy entry at the end that triggers
+    // a bogus tablename change in the following algorithm.
+    // the dummy entry never makes it to the result string
+    cll.push_back(SqliteOverlay::ChangeLogEntry{SqliteOverlay::RowChangeAction::Delete, "xxx", "___", 42});
+
+    string result;
+    string curTabName;
+    std::vector<int> idxList;
+    for (auto it = cll.begin(); it != cll.end(); ++it)
+    {
+      const auto& cle = *it;
+
+      if (cle.tabName != curTabName)
+      {
+        if (!(idxList.empty()))
+        {
+          if (curTabName == TabCourt)
+          {
+            CourtMngr mngr{db};
+            result += mngr.getSyncString(idxList);
+          }
+          if (curTabName == TabTeam)
+          {
+            TeamMngr mngr{db};
+            result += mngr.getSyncString(idxList);
+          }
+          if (curTabName == TabPlayer)
+          {
+            PlayerMngr mngr{db};
+            result += mngr.getSyncString(idxList);
+          }
+          if (curTabName == TabP2C)
+          {
+            PlayerMngr mngr{db};
+            result += mngr.getSyncString_P2C(idxList);
+          }
+          if (curTabName == TabPairs)
+          {
+            PlayerMngr mngr{db};
+            result += mngr.getSyncString_Pairs(idxList);
+          }
+          if (curTabName == TabCategory)
+          {
+            CatMngr mngr{db};
+            result += mngr.getSyncString(idxList);
+          }
+          if (curTabName == TabMatch)
+          {
+            MatchMngr mngr{db};
+            result += mngr.getSyncString(idxList);
+          }
+          if (curTabName == TabMatchGroup)
+          {
+            MatchMngr mngr{db};
+            result += mngr.getSyncString_MatchGroups(idxList);
+          }
+          if (curTabName == TabMatchSystem)
+          {
+            RankingMngr mngr{db};
+            result += mngr.getSyncString(idxList);
+          }
+        }
+
+        curTabName = cle.tabName;
+        idxList.clear();
+      }
+
+      if (cle.action == SqliteOverlay::RowChangeAction::Delete)
+      {
+        idxList.push_back(- cle.rowId);  // negative ID ==> deletion
+      } else {
+        idxList.push_back(cle.rowId);
+      }
+    }
+
+    return result;
+  }
+
+}
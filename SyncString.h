@@ -0,0 +1,41 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2019  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYNCSTRING_H
+#define SYNCSTRING_H
+
+#include <string>
+
+#include <SqliteOverlay/SqliteDatabase.h>
+
+#include "TournamentDB.h"
+
+namespace QTournament
+{
+  /** \returns the sync string with all rows of all tables
+   * that are mirrored on the server
+   */
+  std::string getFullSyncString(const TournamentDB& db);
+
+  /** \returns the sync string with the complete rows of
+   * all rows in a (compacted) changelog
+   */
+  std::string getSyncStringForChanges(const TournamentDB& db, const SqliteOverlay::ChangeLogList& log);
+}
+
+#endif // SYNCSTRING_H
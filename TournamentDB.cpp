@@ -18,10 +18,18 @@
 
 #include <tuple>
 #include <regex>
+#include <cstdio>
 
 #include <QString>
 #include <QStringList>
 #include <QFile>
+#include <QtGlobal>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#endif
+
+#include <sqlite3.h>
 
 #include <SqliteOverlay/TableCreator.h>
 #include <SqliteOverlay/KeyValueTab.h>
@@ -36,6 +44,9 @@
 #include "HelperFunc.h"
 #include "TournamentErrorCodes.h"
 #include "OnlineMngr.h"
+#include "Score.h"
+#include "MatchDependencyGraph.h"
+#include "BracketStateCache.h"
 
 using namespace std;
 
@@ -89,6 +100,19 @@ namespace QTournament
 
   //----------------------------------------------------------------------------
 
+  TournamentDB::TournamentDB(const string& fName, SnapshotTag)
+    :SqliteOverlay::SqliteDatabase(fName.empty() ? string{":memory:"} : fName,
+                                   fName.empty() ? SqliteOverlay::OpenMode::ForceNew : SqliteOverlay::OpenMode::OpenExisting_RO),
+      snapshot{true}
+  {
+  }
+
+  //----------------------------------------------------------------------------
+
+  TournamentDB::~TournamentDB() = default;
+
+  //----------------------------------------------------------------------------
+
   void TournamentDB::populateTables()
   {
     using cdt = SqliteOverlay::ColumnDataType;
@@ -184,6 +208,7 @@ namespace QTournament
     tc.addCol(MA_RefereeMode, cdt::Integer, cc::NotUsed, cc::Abort, -1);
     tc.addForeignKey(MA_RefereeRef, TabPlayer, ca::Cascade, ca::Cascade, cc::NotUsed, cc::NotUsed);
     tc.addCol(MA_BracketMatchNum, cdt::Integer, cc::NotUsed, cc::NotUsed);
+    tc.addCol(MA_PackedResult, cdt::Integer, cc::NotUsed, cc::NotUsed);  // MatchScore::toPackedInt()
     tc.createTableAndResetCreator(*this, TabMatch);
 
     // Generate a table with ranking information
@@ -201,6 +226,8 @@ namespace QTournament
     tc.addCol(RA_Rank, cdt::Integer, cc::NotUsed, cc::NotUsed);  // ranks can be temporarily NULL, because we first create the entry and assign the rank later on
     tc.createTableAndResetCreator(*this, TabMatchSystem);
 
+    // Generate a table for the dependencies between matches
+    createMatchDependencyTable();
   }
 
   //----------------------------------------------------------------------------
@@ -234,7 +261,6 @@ namespace QTournament
     indexCreationHelper(TabP2C, P2C_CatRef);
     indexCreationHelper(TabP2C, P2C_PlayerRef);
 
-    indexCreationHelper(TabPairs, Pairs_Player1Ref);
     indexCreationHelper(TabPairs, Pairs_Player1Ref);
     indexCreationHelper(TabPairs, Pairs_CatRef);
 
@@ -254,6 +280,101 @@ namespace QTournament
     indexCreationHelper(TabMatchSystem, RA_Round);
 
     //indexCreationHelper(TAB_, );
+
+    createQueryIndices();
+  }
+
+  //----------------------------------------------------------------------------
+
+  void TournamentDB::createQueryIndices()
+  {
+    // all statements use "IF NOT EXISTS" so that they
+    // can be safely applied to existing files, too
+    static const std::vector<std::string> allIndices{
+      // all pairs of a player; the index for the first
+      // player is created by createIndices()
+      "CREATE INDEX IF NOT EXISTS Idx_Pairs_Player2Ref ON " TabPairs "(" Pairs_Player2Ref ")",
+
+      // match groups by category and round; this
+      // also serves lookups by category only
+      "CREATE INDEX IF NOT EXISTS Idx_MatchGroup_CatRef_Round ON " TabMatchGroup "(" MG_CatRef ", " MG_Round ")",
+
+      // recently finished matches: filter by state, sort by finish time
+      "CREATE INDEX IF NOT EXISTS Idx_Match_State_FinishTime ON " TabMatch "(" GenericStateFieldName ", " MA_FinishTime ")",
+
+      // matches of a player; the actual players are only
+      // set for called matches, so we skip all other rows
+      "CREATE INDEX IF NOT EXISTS Idx_Match_ActualPlayer1aRef ON " TabMatch "(" MA_ActualPlayer1aRef ") WHERE " MA_ActualPlayer1aRef " IS NOT NULL",
+      "CREATE INDEX IF NOT EXISTS Idx_Match_ActualPlayer1bRef ON " TabMatch "(" MA_ActualPlayer1bRef ") WHERE " MA_ActualPlayer1bRef " IS NOT NULL",
+      "CREATE INDEX IF NOT EXISTS Idx_Match_ActualPlayer2aRef ON " TabMatch "(" MA_ActualPlayer2aRef ") WHERE " MA_ActualPlayer2aRef " IS NOT NULL",
+      "CREATE INDEX IF NOT EXISTS Idx_Match_ActualPlayer2bRef ON " TabMatch "(" MA_ActualPlayer2bRef ") WHERE " MA_ActualPlayer2bRef " IS NOT NULL",
+
+      // unresolved symbolic references (winner / loser of a previous match);
+      // most matches have none. Queries must contain the literal term
+      // "<column> <> 0", otherwise SQLite can't use these indices
+      "CREATE INDEX IF NOT EXISTS Idx_Match_Pair1SymbolicVal ON " TabMatch "(" MA_Pair1SymbolicVal ") WHERE " MA_Pair1SymbolicVal " <> 0",
+      "CREATE INDEX IF NOT EXISTS Idx_Match_Pair2SymbolicVal ON " TabMatch "(" MA_Pair2SymbolicVal ") WHERE " MA_Pair2SymbolicVal " <> 0",
+    };
+
+    for (const string& sql : allIndices)
+    {
+      auto stmt = prepStatement(sql);
+      stmt.step();
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  void TournamentDB::createMatchDependencyTable()
+  {
+    static const std::vector<std::string> allStatements{
+      "CREATE TABLE IF NOT EXISTS " TabMatchDependency " (id INTEGER NOT NULL PRIMARY KEY,"
+      " " MD_MatchRef " INTEGER NOT NULL REFERENCES " TabMatch "(id) ON DELETE CASCADE ON UPDATE CASCADE,"
+      " " MD_PredecessorRef " INTEGER NOT NULL REFERENCES " TabMatch "(id) ON DELETE CASCADE ON UPDATE CASCADE)",
+      "CREATE INDEX IF NOT EXISTS Idx_MatchDependency_MatchRef ON " TabMatchDependency "(" MD_MatchRef ")",
+      "CREATE INDEX IF NOT EXISTS Idx_MatchDependency_PredecessorRef ON " TabMatchDependency "(" MD_PredecessorRef ")",
+    };
+
+    for (const string& sql : allStatements)
+    {
+      auto stmt = prepStatement(sql);
+      stmt.step();
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  void TournamentDB::addPackedMatchResults()
+  {
+    // the column is already part of the table if the
+    // file has been created with version 3.2 or later
+    int nCols = execScalarQueryInt("SELECT COUNT(*) FROM pragma_table_info('" TabMatch "') WHERE name = '" MA_PackedResult "'");
+    if (nCols == 0)
+    {
+      auto stmt = prepStatement("ALTER TABLE " TabMatch " ADD COLUMN " MA_PackedResult " INTEGER");
+      stmt.step();
+    }
+
+    // read all result strings first; we shouldn't modify
+    // the table while iterating over it
+    vector<pair<int, int>> packedResults;
+    auto selStmt = prepStatement("SELECT id, " MA_Result " FROM " TabMatch " WHERE " MA_Result " IS NOT NULL AND " MA_PackedResult " IS NULL");
+    for (selStmt.step(); selStmt.hasData(); selStmt.step())
+    {
+      // broken strings are left alone; Match::getScore()
+      // detects and clears them when they're accessed
+      auto score = MatchScore::fromCharsWithoutValidation(selStmt.getString(1));
+      if (score) packedResults.push_back(make_pair(selStmt.getInt(0), score->toPackedInt()));
+    }
+
+    auto updStmt = prepStatement("UPDATE " TabMatch " SET " MA_PackedResult " = ?1 WHERE id = ?2");
+    for (const auto& pr : packedResults)
+    {
+      updStmt.bind(1, pr.second);
+      updStmt.bind(2, pr.first);
+      updStmt.step();
+      updStmt.reset(true);
+    }
   }
 
   //----------------------------------------------------------------------------
@@ -328,8 +449,47 @@ namespace QTournament
 
   bool TournamentDB::convertToLatestDatabaseVersion()
   {
-    // FIX: adapt to new database schema; drop support for old database versions
-    return false;
+    if (!needsConversion()) return isCompatibleDatabaseVersion();
+
+    auto[major, minor] = getVersion();
+
+    try
+    {
+      auto trans = startTransaction(DefaultTransactionType);
+
+      // 3.0 --> 3.1: additional indices, no changes to the tables
+      if (minor < 1)
+      {
+        createQueryIndices();
+      }
+
+      // 3.1 --> 3.2: match results in packed binary form
+      if (minor < 2)
+      {
+        addPackedMatchResults();
+      }
+
+      // 3.2 --> 3.3: dependencies between matches
+      if (minor < 3)
+      {
+        createMatchDependencyTable();
+        MatchDependencyGraph::rebuildAll(*this);
+      }
+
+      Sloppy::estring dbVersion = "%1.%2";
+      dbVersion.arg(major);
+      dbVersion.arg(DbVersionMinor);
+      SqliteOverlay::KeyValueTab cfg{*this, TabCfg};
+      cfg.set(CfgKey_DbVersion, dbVersion.toStdString());
+
+      trans.commit();
+    }
+    catch (...)
+    {
+      return false;
+    }
+
+    return true;
   }
 
   //----------------------------------------------------------------------------
@@ -341,6 +501,208 @@ namespace QTournament
 
   //----------------------------------------------------------------------------
 
+  sqlite3* TournamentDB::rawHandle() const
+  {
+    return dbPtr.get();
+  }
+
+  //----------------------------------------------------------------------------
+
+  StatementCache& TournamentDB::getStatementCache() const
+  {
+    if (!stmtCache)
+    {
+      stmtCache = make_unique<StatementCache>(rawHandle());
+    }
+
+    return *stmtCache;
+  }
+
+  //----------------------------------------------------------------------------
+
+  BracketStateCache& TournamentDB::getBracketStateCache() const
+  {
+    if (!bracketCache)
+    {
+      bracketCache = make_unique<BracketStateCache>(*this);
+    }
+
+    return *bracketCache;
+  }
+
+  //----------------------------------------------------------------------------
+
+  void TournamentDB::close()
+  {
+    stmtCache.reset();
+    bracketCache.reset();
+
+    SqliteDatabase::close();
+  }
+
+  //----------------------------------------------------------------------------
+
+  unique_ptr<TournamentDB> TournamentDB::createSnapshot() const
+  {
+    // WAL mode: a second reader on the same file doesn't block our writes
+    const char* fName = sqlite3_db_filename(rawHandle(), "main");
+    const bool useFile = walMode && (fName != nullptr) && (fName[0] != '\0');
+
+    unique_ptr<TournamentDB> result;
+    try
+    {
+      result.reset(new TournamentDB{useFile ? string{fName} : string{}, SnapshotTag{}});
+
+      if (useFile)
+      {
+        // pin the current state with a read transaction
+        // that lives as long as the snapshot
+        for (const string& sql : {"BEGIN", "SELECT count(*) FROM " TabCfg})
+        {
+          auto stmt = result->prepStatement(sql);
+          stmt.step();
+        }
+      } else {
+        // copy everything into the new in-memory database
+        sqlite3_backup* bck = sqlite3_backup_init(result->rawHandle(), "main", rawHandle(), "main");
+        if (bck == nullptr) return nullptr;
+        const int rcStep = sqlite3_backup_step(bck, -1);
+        const int rcFinish = sqlite3_backup_finish(bck);
+        if ((rcStep != SQLITE_DONE) || (rcFinish != SQLITE_OK)) return nullptr;
+      }
+
+      // refuse all write attempts
+      auto stmt = result->prepStatement("PRAGMA query_only=1");
+      stmt.step();
+    }
+    catch (...)
+    {
+      return nullptr;
+    }
+
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+  int TournamentDB::backupToFileIncremental(const string& dstFileName, const function<void (int, int)>& progress, int pagesPerStep, int* changeCountAtCompletion) const
+  {
+    const string tmpFileName = dstFileName + ".tmp";
+    QFile::remove(QString::fromStdString(tmpFileName));
+
+    sqlite3* dstDb{nullptr};
+    int rc = sqlite3_open_v2(tmpFileName.c_str(), &dstDb, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, nullptr);
+    if (rc == SQLITE_OK)
+    {
+      sqlite3_backup* bck = sqlite3_backup_init(dstDb, "main", rawHandle(), "main");
+      if (bck != nullptr)
+      {
+        // copy batch by batch and release the source in between;
+        // BUSY and LOCKED only mean that we should try again later
+        //
+        // the connection's mutex is held while reading the change
+        // counter so that no other thread can write between the
+        // final step and the counter; the mutex is recursive
+        sqlite3_mutex* srcMutex = sqlite3_db_mutex(rawHandle());
+        do
+        {
+          sqlite3_mutex_enter(srcMutex);
+          rc = sqlite3_backup_step(bck, pagesPerStep);
+          if ((rc == SQLITE_DONE) && (changeCountAtCompletion != nullptr)) *changeCountAtCompletion = getTotalChangeCount();
+          sqlite3_mutex_leave(srcMutex);
+
+          if (progress)
+          {
+            const int total = sqlite3_backup_pagecount(bck);
+            progress(total - sqlite3_backup_remaining(bck), total);
+          }
+          if ((rc == SQLITE_BUSY) || (rc == SQLITE_LOCKED)) sqlite3_sleep(10);
+        } while ((rc == SQLITE_OK) || (rc == SQLITE_BUSY) || (rc == SQLITE_LOCKED));
+
+        // finish() reports the first error that occurred
+        const int rcFinish = sqlite3_backup_finish(bck);
+        rc = (rc == SQLITE_DONE) ? rcFinish : rc;
+      } else {
+        rc = sqlite3_errcode(dstDb);
+      }
+    }
+    sqlite3_close(dstDb);
+
+    if (rc != SQLITE_OK)
+    {
+      QFile::remove(QString::fromStdString(tmpFileName));
+      return rc;
+    }
+
+    // rename() atomically replaces the destination on POSIX systems;
+    // on Windows it refuses existing destinations, so we need
+    // MoveFileEx() there which replaces the destination in one step
+#ifdef Q_OS_WIN
+    const std::wstring wTmp = QString::fromStdString(tmpFileName).toStdWString();
+    const std::wstring wDst = QString::fromStdString(dstFileName).toStdWString();
+    const bool isMoved = (MoveFileExW(wTmp.c_str(), wDst.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0);
+#else
+    const bool isMoved = (std::rename(tmpFileName.c_str(), dstFileName.c_str()) == 0);
+#endif
+    if (!isMoved)
+    {
+      QFile::remove(QString::fromStdString(tmpFileName));
+      return SQLITE_CANTOPEN;
+    }
+
+    return SQLITE_OK;
+  }
+
+  //----------------------------------------------------------------------------
+
+  int TournamentDB::getTotalChangeCount() const
+  {
+    return sqlite3_total_changes(rawHandle());
+  }
+
+  //----------------------------------------------------------------------------
+
+  bool TournamentDB::canBackupFromOtherThread() const
+  {
+    // connections in "multi-thread" or "single-thread"
+    // mode have no mutex and must stay in their thread
+    return (sqlite3_db_mutex(rawHandle()) != nullptr);
+  }
+
+  //----------------------------------------------------------------------------
+
+  bool TournamentDB::enableWalMode()
+  {
+    // SQLite returns the resulting journal mode which
+    // is still "memory" for in-memory databases
+    auto stmt = prepStatement("PRAGMA journal_mode=WAL");
+    stmt.step();
+    walMode = (stmt.hasData() && (stmt.getString(0) == "wal"));
+    if (!walMode) return false;
+
+    // with WAL, "NORMAL" can't corrupt the database; only the
+    // most recent transactions could be lost on power failure
+    for (const string& pragma : {"PRAGMA synchronous=NORMAL", "PRAGMA cache_size=-16384", "PRAGMA mmap_size=67108864"})
+    {
+      auto pragmaStmt = prepStatement(pragma);
+      pragmaStmt.step();
+    }
+
+    return true;
+  }
+
+  //----------------------------------------------------------------------------
+
+  bool TournamentDB::checkpoint(bool truncateWal) const
+  {
+    if (!walMode) return true;
+
+    int mode = truncateWal ? SQLITE_CHECKPOINT_TRUNCATE : SQLITE_CHECKPOINT_PASSIVE;
+    return (sqlite3_wal_checkpoint_v2(rawHandle(), nullptr, mode, nullptr, nullptr) == SQLITE_OK);
+  }
+
+  //----------------------------------------------------------------------------
+
   std::tuple<string, int> TournamentDB::tableDataToCSV(const string& tabName, const std::vector<Sloppy::estring>& colNames, int rowId) const
   {
     std::vector<int> v = (rowId < 0) ? std::vector<int>{} : std::vector<int>{rowId,};
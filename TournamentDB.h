@@ -23,6 +23,7 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <functional>
 
 #include <SqliteOverlay/SqliteDatabase.h>
 #include <SqliteOverlay/Transaction.h>
@@ -30,12 +31,17 @@
 #include "TournamentDataDefs.h"
 #include "TournamentErrorCodes.h"
 #include "OnlineMngr.h"
+#include "StatementCache.h"
+
+struct sqlite3;
 
 namespace QTournament
 {
   // the default transaction type for all transactional database operations
   static constexpr SqliteOverlay::TransactionType DefaultTransactionType{SqliteOverlay::TransactionType::Immediate};
 
+  class BracketStateCache;
+
   class TournamentDB : public SqliteOverlay::SqliteDatabase
   {
     friend class SqliteOverlay::SqliteDatabase;
@@ -53,12 +59,30 @@ namespace QTournament
      */
     TournamentDB(const std::string& fName);
 
-    ~TournamentDB() override = default;
+    ~TournamentDB() override;
 
     void populateTables() override;
     void populateViews() override;
     void createIndices();
 
+    /** \brief Creates the composite and partial indices that are tuned
+     * to the most frequent queries
+     *
+     * Existing indices are skipped, so this is also used for
+     * upgrading files from older database versions.
+     */
+    void createQueryIndices();
+
+    /** \brief Adds the column for packed match results to files
+     * from older database versions and fills it from the result strings
+     */
+    void addPackedMatchResults();
+
+    /** \brief Creates the table for the dependencies between matches,
+     * if it doesn't exist yet
+     */
+    void createMatchDependencyTable();
+
     std::tuple<int, int> getVersion();
 
     bool isCompatibleDatabaseVersion();
@@ -69,6 +93,115 @@ namespace QTournament
     // access to the tournament-wide instance of the OnlineMngr
     OnlineMngr* getOnlineManager() const;
 
+    /** \brief Provides the raw SQLite connection handle for low-level
+     * operations that are not covered by SqliteOverlay (e.g., statement tracing)
+     *
+     * \returns the raw handle; it remains valid for the lifetime of this object
+     */
+    sqlite3* rawHandle() const;
+
+    /** \brief Switches a file-based database to write-ahead logging and
+     * applies settings that are tuned for working directly on the file
+     *
+     * This has no effect on in-memory databases.
+     *
+     * \returns `true` if the database is in WAL mode afterwards
+     */
+    bool enableWalMode();
+
+    /** \returns `true` if we're working directly on a file in WAL mode
+     */
+    bool isWalMode() const { return walMode; }
+
+    /** \brief Transfers the content of the WAL file into the database file
+     *
+     * Does nothing if the database is not in WAL mode.
+     *
+     * \returns `true` if the checkpoint could be completed
+     */
+    bool checkpoint(
+        bool truncateWal = false   ///< if `true`, the WAL file is truncated to zero bytes afterwards
+        ) const;
+
+    /** \brief Creates an independent, read-only view of the current
+     * database content for background readers (reports, sync data, predictions)
+     *
+     * In WAL mode, the snapshot is a second connection to the same file
+     * with an open read transaction, so it is cheap and sees the state at
+     * the time of its creation while this connection continues to write.
+     * In all other cases (e.g., ":memory:" databases) the snapshot is an
+     * in-memory copy of the database.
+     *
+     * The snapshot has its own SQLite connection and may be handed over to
+     * a worker thread; it must be created in the thread that owns this
+     * connection, though. Snapshots have no OnlineMngr.
+     *
+     * \returns the snapshot or `nullptr` if it could not be created
+     */
+    std::unique_ptr<TournamentDB> createSnapshot() const;
+
+    /** \brief Number of pages that backupToFileIncremental() copies
+     * before it releases the source database again
+     */
+    static constexpr int DefaultBackupPagesPerStep = 256;
+
+    /** \brief Writes a copy of the database to a file in small batches of pages
+     *
+     * The copy is first written to a temporary file next to the destination
+     * which then replaces the destination in one rename. Thus, the destination
+     * either contains the old content or the complete new copy.
+     *
+     * Between two batches, this connection can be used for writing. Such writes
+     * are included in the copy by SQLite; writes from other connections restart
+     * the copy automatically.
+     *
+     * If this connection is in SQLite's "serialized" mode (see canBackupFromOtherThread()),
+     * this function may be called from a worker thread while the owning thread
+     * continues to use the connection.
+     *
+     * \returns the SQLite result code; SQLITE_OK (0) on success
+     */
+    int backupToFileIncremental(
+        const std::string& dstFileName,   ///< the destination file; will be overwritten
+        const std::function<void(int, int)>& progress = nullptr,   ///< called after each batch with the number of copied pages and the total number of pages
+        int pagesPerStep = DefaultBackupPagesPerStep,
+        int* changeCountAtCompletion = nullptr   ///< receives getTotalChangeCount() at the moment the last page has been copied
+        ) const;
+
+    /** \returns the number of rows that have been inserted, modified or
+     * deleted on this connection since it has been opened
+     */
+    int getTotalChangeCount() const;
+
+    /** \returns `true` if SQLite serializes all calls on this connection so
+     * that backupToFileIncremental() can run in a worker thread
+     */
+    bool canBackupFromOtherThread() const;
+
+    /** \returns `true` if this is a read-only snapshot created by createSnapshot()
+     */
+    bool isSnapshot() const { return snapshot; }
+
+    /** \brief Provides the prepared statements for frequently used queries
+     *
+     * The cache is created upon first use and lives as long as the connection.
+     */
+    StatementCache& getStatementCache() const;
+
+    /** \brief Provides the memoized bracket states of all bracket categories
+     *
+     * The cache is created upon first use and lives as long as the connection.
+     */
+    BracketStateCache& getBracketStateCache() const;
+
+    /** \brief Finalizes all cached statements and closes the connection
+     *
+     * Statements that are still prepared keep SQLite from closing the
+     * connection (SQLITE_BUSY) which would leak the handle and leave
+     * the -wal / -shm files behind.
+     */
+    void close();
+
     // conversion to CSV for syncing with the server
     std::tuple<std::string,int> tableDataToCSV(const std::string& tabName, const std::vector<Sloppy::estring>& colNames, int rowId=-1) const;
     std::tuple<std::string,int> tableDataToCSV(const std::string& tabName, const std::vector<Sloppy::estring>& colNames, const std::vector<int>& rowList) const;
@@ -76,11 +209,22 @@ namespace QTournament
     std::string getSyncStringForTable(const std::string& tabName, const std::vector<Sloppy::estring>& colNames, std::vector<int> rowList) const;
 
   protected:
+    struct SnapshotTag {};
+
+    /** \brief Ctor for snapshots; opens the file read-only or, for
+     * an empty file name, creates an empty in-memory database
+     */
+    TournamentDB(const std::string& fName, SnapshotTag);
+
     void initBlankDb(const TournamentSettings& cfg);
 
   private:
 
     std::unique_ptr<OnlineMngr> om;
+    bool walMode{false};
+    bool snapshot{false};
+    mutable std::unique_ptr<StatementCache> stmtCache;   // destroyed before the connection is closed
+    mutable std::unique_ptr<BracketStateCache> bracketCache;
   };
 
   /** \brief Creates a new, empty tournament database with a given file name
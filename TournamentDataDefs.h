@@ -28,7 +28,7 @@
 namespace QTournament
 {
   constexpr int DbVersionMajor = 3;
-  constexpr int DbVersionMinor = 0;
+  constexpr int DbVersionMinor = 3;
   constexpr int MinRequiredDbVersion = 3;
 
 //----------------------------------------------------------------------------
@@ -186,12 +186,19 @@ namespace QTournament
 #define MA_RefereeMode  "RefereeMode"
 #define MA_RefereeRef  "RefereeRefId"
 #define MA_BracketMatchNum  "BracketMatchNum"
+#define MA_PackedResult  "PackedResult"
 //#define MA_  ""
 //#define MA_  ""
 //#define MA_  ""
   
 //----------------------------------------------------------------------------
 
+#define TabMatchDependency "MatchDependency"
+#define MD_MatchRef  "MatchRefId"
+#define MD_PredecessorRef  "PredecessorRefId"
+
+//----------------------------------------------------------------------------
+
 #define TabMatchGroup "MatchGroup"
 #define MG_CatRef  "CategoryRefId"
 #define MG_Round  "Round"
@@ -22,6 +22,8 @@
 #include "TournamentDatabaseObjectManager.h"
 #include "TournamentDB.h"
 
+#include <Sloppy/String.h>
+
 namespace QTournament
 {
 
@@ -61,26 +63,78 @@ namespace QTournament
 
   void TournamentDatabaseObjectManager::fixSeqNumberAfterDelete(const SqliteOverlay::DbTab& otherTab, int deletedSeqNum) const
   {
-    SqliteOverlay::WhereClause wc;
-    wc.addCol(GenericSeqnumFieldName, ">", deletedSeqNum);
-    wc.setOrderColumn_Asc(GenericSeqnumFieldName);
+    // shift all items behind the deleted item by one with two
+    // set-based updates instead of updating row by row.
+    //
+    // the sequence numbers are unique, so we first move the affected rows
+    // to negative values to avoid conflicts during the update
+    Sloppy::estring sql{"UPDATE %1 SET %2 = -1 - %2 WHERE %2 > %3"};
+    sql.arg(otherTab.name());
+    sql.arg(GenericSeqnumFieldName);
+    sql.arg(deletedSeqNum);
+
+    Sloppy::estring sql2{"UPDATE %1 SET %2 = -2 - %2 WHERE %2 < -1"};
+    sql2.arg(otherTab.name());
+    sql2.arg(GenericSeqnumFieldName);
 
     // make sure we update all rows in a single transaction
     auto trans = db.startTransaction(DefaultTransactionType);
+    execStatement(sql);
+    execStatement(sql2);
+    trans.commit();
+  }
 
-    auto rows = otherTab.getRowsByWhereClause(wc);
-    
-    // re-number all items behind the deleted item
-    int nextSeqNum = deletedSeqNum;
-    for (const auto& row : rows)
-    {
-      row.update(GenericSeqnumFieldName, nextSeqNum);
-      ++nextSeqNum;
-    }
+//----------------------------------------------------------------------------
+
+  void TournamentDatabaseObjectManager::deleteRowsAndFixSeqNumbers(const std::string& tabName, const std::string& whereCond) const
+  {
+    auto trans = db.startTransaction(DefaultTransactionType);
+
+    // rows before the first deleted row keep their sequence numbers
+    Sloppy::estring sql{"SELECT MIN(%1) FROM %2 WHERE %3"};
+    sql.arg(GenericSeqnumFieldName);
+    sql.arg(tabName);
+    sql.arg(whereCond);
+    auto firstSeqNum = db.execScalarQueryIntOrNull(sql);
+    if (!firstSeqNum) return;   // nothing to delete
+
+    Sloppy::estring sqlDel{"DELETE FROM %1 WHERE %2"};
+    sqlDel.arg(tabName);
+    sqlDel.arg(whereCond);
+    execStatement(sqlDel);
+
+    // determine the new, gap-free sequence numbers for all remaining rows
+    execStatement("CREATE TEMP TABLE IF NOT EXISTS SeqNumCompaction (id INTEGER PRIMARY KEY, NewSeqNum INTEGER)");
+    execStatement("DELETE FROM temp.SeqNumCompaction");
+    Sloppy::estring sqlMap{"INSERT INTO temp.SeqNumCompaction SELECT id, %1 + ROW_NUMBER() OVER (ORDER BY %2) - 1 FROM %3 WHERE %2 > %1"};
+    sqlMap.arg(*firstSeqNum);
+    sqlMap.arg(GenericSeqnumFieldName);
+    sqlMap.arg(tabName);
+    execStatement(sqlMap);
+
+    // move the rows out of the way and apply the new sequence
+    // numbers; see fixSeqNumberAfterDelete()
+    Sloppy::estring sqlMove{"UPDATE %1 SET %2 = -1 - %2 WHERE %2 > %3"};
+    sqlMove.arg(tabName);
+    sqlMove.arg(GenericSeqnumFieldName);
+    sqlMove.arg(*firstSeqNum);
+    execStatement(sqlMove);
+    Sloppy::estring sqlRenum{"UPDATE %1 SET %2 = (SELECT NewSeqNum FROM temp.SeqNumCompaction AS c WHERE c.id = %1.id) WHERE %2 < -1"};
+    sqlRenum.arg(tabName);
+    sqlRenum.arg(GenericSeqnumFieldName);
+    execStatement(sqlRenum);
 
     trans.commit();
   }
 
+//----------------------------------------------------------------------------
+
+  void TournamentDatabaseObjectManager::execStatement(const std::string& sql) const
+  {
+    auto stmt = db.prepStatement(sql);
+    stmt.step();
+  }
+
 //----------------------------------------------------------------------------
 
   std::string TournamentDatabaseObjectManager::getSyncString(int rowId) const
@@ -53,6 +53,20 @@ namespace QTournament
     void fixSeqNumberAfterDelete(int deletedSeqNum) const;
     void fixSeqNumberAfterInsert(const SqliteOverlay::DbTab& otherTab) const;
     void fixSeqNumberAfterDelete(const SqliteOverlay::DbTab& otherTab, int deletedSeqNum) const;
+
+    /** \brief Deletes all rows of a table that match a condition and closes
+     * the resulting gaps in the sequence numbers
+     *
+     * The number of SQL statements is constant and does not depend on the
+     * number of deleted or renumbered rows. Emits no signals.
+     */
+    void deleteRowsAndFixSeqNumbers(
+        const std::string& tabName,   ///< the table to delete from; must have a sequence number column
+        const std::string& whereCond   ///< an SQL condition without "WHERE" that selects the rows for deletion
+        ) const;
+
+  private:
+    void execStatement(const std::string& sql) const;
   };
 
 }
@@ -103,6 +103,7 @@ namespace QTournament
         RefereeNotIdle,
         CourtNotDisabled,
         CourtAlreadyUsed,
+        NoRefereeCandidate,
     };
 
     //----------------------------------------------------------------------------
@@ -38,6 +38,8 @@ CourtTableModel::CourtTableModel(const TournamentDB& _db)
   connect(cse, SIGNAL(courtStatusChanged(int,int,ObjState,ObjState)), this, SLOT(onCourtStatusChanged(int,int)), Qt::DirectConnection);
   connect(cse, SIGNAL(beginDeleteCourt(int)), this, SLOT(onBeginDeleteCourt(int)), Qt::DirectConnection);
   connect(cse, SIGNAL(endDeleteCourt()), this, SLOT(onEndDeleteCourt()), Qt::DirectConnection);
+  connect(cse, SIGNAL(beginResetAllModels()), this, SLOT(onBeginResetModel()), Qt::DirectConnection);
+  connect(cse, SIGNAL(endResetAllModels()), this, SLOT(onEndResetModel()), Qt::DirectConnection);
 
   // a timer for updatng the match duration
   durationUpdateTimer = std::make_unique<QTimer>(this);
@@ -196,6 +198,20 @@ void CourtTableModel::onEndDeleteCourt()
 
 //----------------------------------------------------------------------------
 
+void CourtTableModel::onBeginResetModel()
+{
+  beginResetModel();
+}
+
+//----------------------------------------------------------------------------
+
+void CourtTableModel::onEndResetModel()
+{
+  endResetModel();
+}
+
+//----------------------------------------------------------------------------
+
 
 //----------------------------------------------------------------------------
 
@@ -60,6 +60,8 @@ namespace QTournament
     void onDurationUpdateTimerElapsed();
     void onBeginDeleteCourt(int courtSeqNum);
     void onEndDeleteCourt();
+    void onBeginResetModel();
+    void onEndResetModel();
   };
 
 }
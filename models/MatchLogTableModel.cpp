@@ -0,0 +1,285 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2019  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QDateTime>
+
+#include <Sloppy/String.h>
+
+#include "MatchLogTableModel.h"
+
+#include "MatchMngr.h"
+#include "CentralSignalEmitter.h"
+
+using namespace QTournament;
+
+MatchLogTableModel::MatchLogTableModel(const TournamentDB& _db)
+  :QAbstractTableModel{nullptr}, db{_db}
+{
+  CentralSignalEmitter* cse = CentralSignalEmitter::getInstance();
+  connect(cse, SIGNAL(matchStatusChanged(int,int,ObjState,ObjState)), this, SLOT(onMatchStatusChanged(int,int,ObjState,ObjState)), Qt::DirectConnection);
+  connect(cse, SIGNAL(categoryRemovedFromTournament(int,int)), this, SLOT(onCategoryRemoved()), Qt::DirectConnection);
+  connect(cse, SIGNAL(beginResetAllModels()), this, SLOT(onBeginResetModel()), Qt::DirectConnection);
+  connect(cse, SIGNAL(endResetAllModels()), this, SLOT(onEndResetModel()), Qt::DirectConnection);
+
+  // prepare the first screen; everything
+  // else is loaded on demand
+  reloadMatchIds();
+  fetchMore(QModelIndex{});
+}
+
+//----------------------------------------------------------------------------
+
+int MatchLogTableModel::rowCount(const QModelIndex& parent) const
+{
+  if (parent.isValid()) return 0;
+  return static_cast<int>(rowCache.size());
+}
+
+//----------------------------------------------------------------------------
+
+int MatchLogTableModel::columnCount(const QModelIndex& parent) const
+{
+  if (parent.isValid()) return 0;
+  return ColumnCount;
+}
+
+//----------------------------------------------------------------------------
+
+QVariant MatchLogTableModel::data(const QModelIndex& index, int role) const
+{
+  if (!index.isValid()) return QVariant();
+  if ((index.row() < 0) || (index.row() >= static_cast<int>(rowCache.size()))) return QVariant();
+  if ((index.column() < 0) || (index.column() >= ColumnCount)) return QVariant();
+
+  // the delegate identifies the match by its ID
+  if (role == Qt::UserRole) return matchIds[index.row()];
+
+  if (role != Qt::DisplayRole) return QVariant();
+
+  return rowCache[index.row()].at(index.column());
+}
+
+//----------------------------------------------------------------------------
+
+QVariant MatchLogTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+  if (role != Qt::DisplayRole) return QVariant();
+  if (orientation != Qt::Horizontal) return (section + 1);
+
+  switch (section)
+  {
+  case IdxMatchNumCol: return tr("Number");
+  case IdxConfigCol: return tr("Category");
+  case IdxRoundCol: return tr("Round");
+  case IdxGrpCol: return tr("Group");
+  case IdxMatchInfoCol: return tr("Match Info");
+  case IdxStartTimeCol: return tr("Start");
+  case IdxFinishTimeCol: return tr("Finish");
+  case IdxDurationCol: return tr("Duration");
+  case IdxCourtCol: return tr("Court");
+  case IdxUmpireCol: return tr("Umpire");
+  }
+
+  return QVariant();
+}
+
+//----------------------------------------------------------------------------
+
+bool MatchLogTableModel::canFetchMore(const QModelIndex& parent) const
+{
+  if (parent.isValid()) return false;
+  return (rowCache.size() < matchIds.size());
+}
+
+//----------------------------------------------------------------------------
+
+void MatchLogTableModel::fetchMore(const QModelIndex& parent)
+{
+  if (parent.isValid()) return;
+
+  const int first = static_cast<int>(rowCache.size());
+  const int last = std::min(first + FetchBatchSize, static_cast<int>(matchIds.size())) - 1;
+  if (last < first) return;
+
+  MatchMngr mm{db};
+  beginInsertRows(QModelIndex{}, first, last);
+  for (int row = first; row <= last; ++row)
+  {
+    auto ma = mm.getMatch(matchIds[row]);
+    rowCache.push_back(ma ? getCellTexts(*ma) : getEmptyCellTexts());
+  }
+  endInsertRows();
+}
+
+//----------------------------------------------------------------------------
+
+int MatchLogTableModel::getMatchId(int row) const
+{
+  if ((row < 0) || (row >= static_cast<int>(rowCache.size()))) return -1;
+  return matchIds[row];
+}
+
+//----------------------------------------------------------------------------
+
+QStringList MatchLogTableModel::getEmptyCellTexts()
+{
+  QStringList result;
+  for (int i = 0; i < ColumnCount; ++i) result.push_back("--");
+  return result;
+}
+
+//----------------------------------------------------------------------------
+
+QStringList MatchLogTableModel::getCellTexts(const Match& ma)
+{
+  QStringList result = getEmptyCellTexts();
+
+  int roundOffset = ma.getCategory().getParameter_int(CatParameter::FirstRoundOffset);
+
+  // the match number
+  int maNum = ma.getMatchNumber();
+  if (maNum != MatchNumNotAssigned)
+  {
+    result[IdxMatchNumCol] = QString::number(maNum);
+  }
+
+  // category and round
+  result[IdxConfigCol] = ma.getCategory().getName();
+  auto grp = ma.getMatchGroup();
+  result[IdxRoundCol] = QString::number(grp.getRound() + roundOffset);
+
+  // the group number, if any
+  int grpNum = grp.getGroupNumber();
+  if (grpNum > 0)
+  {
+    result[IdxGrpCol] = QString::number(grpNum);
+  }
+
+  // only empty text for the match info. the content will be displayed
+  // by the delegate
+  result[IdxMatchInfoCol] = "";
+
+  // start and finish time; walkovers don't have any
+  QDateTime startTime = ma.getStartTime();
+  if (startTime.isValid())
+  {
+    result[IdxStartTimeCol] = startTime.toString("HH:mm");
+    result[IdxFinishTimeCol] = ma.getFinishTime().toString("HH:mm");
+  }
+
+  // the duration
+  int duration = ma.getMatchDuration();
+  if (duration >= 0)
+  {
+    int hours = duration / 3600;
+    int minutes = (duration % 3600) / 60;
+    QString sDuration = "%1:%2";
+    result[IdxDurationCol] = sDuration.arg(hours).arg(minutes, 2, 10, QLatin1Char('0'));
+  } else if (ma.isWonByWalkover()) {
+    result[IdxDurationCol] = tr("walkover");
+  }
+
+  // the court
+  auto co = ma.getCourt(nullptr);
+  if (co)
+  {
+    result[IdxCourtCol] = QString::number(co->getNumber());
+  }
+
+  // the umpire
+  auto ump = ma.getAssignedReferee();
+  if (ump)
+  {
+    result[IdxUmpireCol] = ump->getDisplayName_FirstNameFirst();
+  }
+
+  return result;
+}
+
+//----------------------------------------------------------------------------
+
+void MatchLogTableModel::onMatchStatusChanged(int matchId, int, ObjState fromState, ObjState toState)
+{
+  if ((toState != ObjState::MA_Finished) || (fromState == ObjState::MA_Finished)) return;
+  if (isInReset) return;   // the match will be included when the reset is complete
+  if (!matchIds.empty() && (matchIds.front() == matchId)) return;
+
+  MatchMngr mm{db};
+  auto ma = mm.getMatch(matchId);
+  if (!ma) return;
+
+  // the most recent match goes on top
+  beginInsertRows(QModelIndex{}, 0, 0);
+  matchIds.push_front(matchId);
+  rowCache.push_front(getCellTexts(*ma));
+  endInsertRows();
+}
+
+//----------------------------------------------------------------------------
+
+void MatchLogTableModel::onCategoryRemoved()
+{
+  if (isInReset) return;
+
+  // the matches of the deleted category have to disappear
+  beginResetModel();
+  reloadMatchIds();
+  endResetModel();
+  fetchMore(QModelIndex{});
+}
+
+//----------------------------------------------------------------------------
+
+void MatchLogTableModel::onBeginResetModel()
+{
+  isInReset = true;
+  beginResetModel();
+}
+
+//----------------------------------------------------------------------------
+
+void MatchLogTableModel::onEndResetModel()
+{
+  reloadMatchIds();
+  endResetModel();
+  isInReset = false;
+  fetchMore(QModelIndex{});
+}
+
+//----------------------------------------------------------------------------
+
+void MatchLogTableModel::reloadMatchIds()
+{
+  matchIds.clear();
+  rowCache.clear();
+
+  Sloppy::estring sql{"SELECT id FROM %1 WHERE %2 = %3 ORDER BY %4 DESC, id DESC"};
+  sql.arg(TabMatch);
+  sql.arg(GenericStateFieldName);
+  sql.arg(static_cast<int>(ObjState::MA_Finished));
+  sql.arg(MA_FinishTime);
+
+  auto stmt = db.get().prepStatement(sql);
+  for (stmt.step(); stmt.hasData(); stmt.step())
+  {
+    matchIds.push_back(stmt.getInt(0));
+  }
+}
+
+//----------------------------------------------------------------------------
+
@@ -0,0 +1,101 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2019  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MATCHLOGTABLEMODEL_H
+#define MATCHLOGTABLEMODEL_H
+
+#include <deque>
+#include <functional>
+
+#include <QAbstractTableModel>
+#include <QStringList>
+
+#include "TournamentDB.h"
+#include "Match.h"
+
+namespace QTournament
+{
+  /** \brief A model with all finished matches, most recent match first
+   *
+   * The IDs of all finished matches are read with a single query. The cell
+   * contents are only created for the rows that have actually been requested
+   * by the view via fetchMore(), so opening a tournament with thousands of
+   * finished matches is as fast as opening an empty one. Rows that have
+   * been created once are kept in a cache; newly finished matches are
+   * added at the top.
+   */
+  class MatchLogTableModel : public QAbstractTableModel
+  {
+    Q_OBJECT
+
+  public:
+    static constexpr int IdxMatchNumCol = 0;
+    static constexpr int IdxConfigCol = 1;
+    static constexpr int IdxRoundCol = 2;
+    static constexpr int IdxGrpCol = 3;
+    static constexpr int IdxMatchInfoCol = 4;
+    static constexpr int IdxStartTimeCol = 5;
+    static constexpr int IdxFinishTimeCol = 6;
+    static constexpr int IdxDurationCol = 7;
+    static constexpr int IdxCourtCol = 8;
+    static constexpr int IdxUmpireCol = 9;
+    static constexpr int ColumnCount = 10;
+
+    static constexpr int FetchBatchSize = 50;   ///< number of rows that are created per fetchMore() call
+
+    MatchLogTableModel(const QTournament::TournamentDB& _db);
+    int rowCount(const QModelIndex & parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex & parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex & index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
+
+    /** \returns the ID of the match in a given row or -1 for invalid rows
+     */
+    int getMatchId(int row) const;
+
+    /** \returns the texts for all columns of a match; the text for
+     * the match info column is empty because it's painted by the delegate
+     */
+    static QStringList getCellTexts(const QTournament::Match& ma);
+
+    /** \returns placeholder texts for all columns, e.g. for a match
+     * that could not be resolved anymore
+     */
+    static QStringList getEmptyCellTexts();
+
+  public slots:
+    void onMatchStatusChanged(int matchId, int matchSeqNum, ObjState fromState, ObjState toState);
+    void onCategoryRemoved();
+    void onBeginResetModel();
+    void onEndResetModel();
+
+  protected:
+    void reloadMatchIds();
+
+  private:
+    std::reference_wrapper<const QTournament::TournamentDB> db;
+    std::deque<int> matchIds;   ///< all finished matches, most recent first
+    std::deque<QStringList> rowCache;   ///< cell texts for the first rowCache.size() entries of matchIds
+    bool isInReset{false};
+  };
+
+}
+
+#endif // MATCHLOGTABLEMODEL_H
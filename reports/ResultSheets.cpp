@@ -52,12 +52,25 @@ ResultSheets::ResultSheets(const TournamentDB& _db, const Match& firstMatchForPr
 
 //----------------------------------------------------------------------------
 
+ResultSheets::ResultSheets(const TournamentDB& _db, const MatchList& matchesForPrinting)
+  :AbstractReport(_db, "Dummy"), numMatches(static_cast<int>(matchesForPrinting.size()))
+{
+  // same as above: only transient for immediate printing,
+  // e.g. after calling several matches at once
+  for (const Match& ma : matchesForPrinting)
+  {
+    explicitMatchIds.push_back(ma.getId());
+  }
+}
+
+//----------------------------------------------------------------------------
+
 upSimpleReport ResultSheets::regenerateReport()
 {
   upSimpleReport result = createEmptyReport_Portrait();
 
   // return an error message if we have no valid match number range selected
-  if ((firstMatchNum < 0) || (numMatches < 1))
+  if (explicitMatchIds.empty() && ((firstMatchNum < 0) || (numMatches < 1)))
   {
     setHeaderAndHeadline(result.get(), "ResultSheets");
     result->writeLine(tr("No match selected."));
@@ -67,25 +80,34 @@ upSimpleReport ResultSheets::regenerateReport()
   // collect the matches to be printed
   MatchMngr mm{db};
   QList<Match> matchList;
-  int lastMatch = mm.getMaxMatchNum();
-  int i = firstMatchNum;
-  while (matchList.size() < numMatches)
+  if (!explicitMatchIds.empty())
   {
-    auto ma = mm.getMatchByMatchNum(i);
-    if (ma)
+    for (int maId : explicitMatchIds)
+    {
+      auto ma = mm.getMatch(maId);
+      if (ma) matchList.append(*ma);
+    }
+  } else {
+    int lastMatch = mm.getMaxMatchNum();
+    int i = firstMatchNum;
+    while (matchList.size() < numMatches)
     {
-      // we can only print result sheet for unfinished
-      // matches. For now, let's also acceppt FUZZY and POSTPONED matches...
-      ObjState stat = ma->getState();
-      if ((stat == ObjState::MA_Busy) || (stat == ObjState::MA_Fuzzy) || (stat == ObjState::MA_Running) ||
-          (stat == ObjState::MA_Ready) || (stat == ObjState::MA_Waiting) || (stat == ObjState::MA_Postponed))
+      auto ma = mm.getMatchByMatchNum(i);
+      if (ma)
       {
-        matchList.append(*ma);
+        // we can only print result sheet for unfinished
+        // matches. For now, let's also acceppt FUZZY and POSTPONED matches...
+        ObjState stat = ma->getState();
+        if ((stat == ObjState::MA_Busy) || (stat == ObjState::MA_Fuzzy) || (stat == ObjState::MA_Running) ||
+            (stat == ObjState::MA_Ready) || (stat == ObjState::MA_Waiting) || (stat == ObjState::MA_Postponed))
+        {
+          matchList.append(*ma);
+        }
       }
-    }
 
-    ++i;
-    if (i > lastMatch) break;
+      ++i;
+      if (i > lastMatch) break;
+    }
   }
 
   // return an empty report if we have no matches
@@ -20,12 +20,14 @@
 #define RESULTSHEETS_H
 
 #include <functional>
+#include <vector>
 
 #include <QObject>
 
 #include "reports/AbstractReport.h"
 #include "TournamentDB.h"
 #include "TournamentDataDefs.h"
+#include "Match.h"
 
 namespace QTournament
 {
@@ -36,6 +38,7 @@ namespace QTournament
   public:
     ResultSheets(const QTournament::TournamentDB& _db, const QString& _name, int _numMatches);
     ResultSheets(const QTournament::TournamentDB& _db, const Match& firstMatchForPrinting, int _numMatches=1);
+    ResultSheets(const QTournament::TournamentDB& _db, const MatchList& matchesForPrinting);
 
     virtual upSimpleReport regenerateReport() override;
     virtual QStringList getReportLocators() const override;
@@ -51,6 +54,7 @@ namespace QTournament
 
     int numMatches;
     int firstMatchNum{-1};
+    std::vector<int> explicitMatchIds;   ///< if not empty, we print exactly these matches instead of a range
     void printMatchData(upSimpleReport& rep, const Match& ma);
   };
 
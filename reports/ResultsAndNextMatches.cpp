@@ -133,12 +133,18 @@ void ResultsAndNextMatches::printResultPart(upSimpleReport& rep) const
   MatchMngr mm{db};
   MatchGroupList mgl = mm.getMatchGroupsForCat(cat, round);
   MatchList allMatches;
+  std::unordered_map<int, int> maId2GrpNum;
   for (MatchGroup mg : mgl)
   {
-    for (Match& m : mg.getMatches()) allMatches.push_back(m);
+    const int grpNum = mg.getGroupNumber();
+    for (Match& m : mg.getMatches())
+    {
+      maId2GrpNum[m.getId()] = grpNum;
+      allMatches.push_back(m);
+    }
   }
 
-  std::sort(allMatches.begin(), allMatches.end(), getSortFunction_MatchByGroupAndNumber());
+  sortMatchesByGroupAndNumber(allMatches, maId2GrpNum);
 
   printIntermediateHeader(rep, tr("Results of Round ") + QString::number(round + roundOffset));
   printMatchList(rep, allMatches, PlayerPairList(), tr("Results of Round ") + QString::number(round + roundOffset) + tr(" (cont.)"), true, true);
@@ -165,6 +171,7 @@ void ResultsAndNextMatches::printNextMatchPart(upSimpleReport& rep) const
   MatchMngr mm{db};
   MatchGroupList mgl = mm.getMatchGroupsForCat(cat, round+1);
   MatchList allMatches;
+  std::unordered_map<int, int> maId2GrpNum;
   bool isAllScheduled = true;
   for (MatchGroup mg : mgl)
   {
@@ -174,7 +181,12 @@ void ResultsAndNextMatches::printNextMatchPart(upSimpleReport& rep) const
       isAllScheduled = false;
       break;
     }
-    for (Match& m : mg.getMatches()) allMatches.push_back(m);
+    const int grpNum = mg.getGroupNumber();
+    for (Match& m : mg.getMatches())
+    {
+      maId2GrpNum[m.getId()] = grpNum;
+      allMatches.push_back(m);
+    }
   }
 
   // if there are unscheduled match groups, print nothing at all
@@ -198,7 +210,7 @@ void ResultsAndNextMatches::printNextMatchPart(upSimpleReport& rep) const
   }
 
   // sort matches by group and number
-  std::sort(allMatches.begin(), allMatches.end(), getSortFunction_MatchByGroupAndNumber());
+  sortMatchesByGroupAndNumber(allMatches, maId2GrpNum);
 
   // determine a list of all players having a bye
   PlayerPairList byeList;
@@ -225,23 +237,20 @@ void ResultsAndNextMatches::printNextMatchPart(upSimpleReport& rep) const
 
 //----------------------------------------------------------------------------
 
-std::function<bool (Match& ma1, Match& ma2)> ResultsAndNextMatches::getSortFunction_MatchByGroupAndNumber() const
+void ResultsAndNextMatches::sortMatchesByGroupAndNumber(MatchList& ml, const std::unordered_map<int, int>& maId2GrpNum) const
 {
-  return [](Match& ma1, Match& ma2){
-    int mg1Num = ma1.getMatchGroup().getGroupNumber();
-    int mg2Num = ma2.getMatchGroup().getGroupNumber();
-    if (mg1Num < mg2Num)
-    {
-      return true;
-    }
-    if (mg1Num > mg2Num)
-    {
-      return false;
-    }
+  // read the match numbers only once per match and
+  // not twice per comparison
+  std::unordered_map<int, std::pair<int, int>> sortKeys;
+  for (const Match& ma : ml)
+  {
+    sortKeys[ma.getId()] = std::pair{maId2GrpNum.at(ma.getId()), ma.getMatchNumber()};
+  }
 
-    // group numbers are equal. so we sort by match numbers
-    return (ma1.getMatchNumber() < ma2.getMatchNumber());
-  };
+  // sort by group numbers first and then by match numbers
+  std::sort(ml.begin(), ml.end(), [&sortKeys](const Match& ma1, const Match& ma2){
+    return (sortKeys.at(ma1.getId()) < sortKeys.at(ma2.getId()));
+  });
 }
 
 //----------------------------------------------------------------------------
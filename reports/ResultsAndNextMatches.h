@@ -20,6 +20,7 @@
 #define RESULTSANDNEXTMATCHES_H
 
 #include <functional>
+#include <unordered_map>
 
 #include <QObject>
 
@@ -46,7 +47,7 @@ namespace QTournament
     void printResultPart(upSimpleReport& rep) const;
     void printNextMatchPart(upSimpleReport& rep) const;
 
-    std::function<bool (Match& ma1, Match& ma2)> getSortFunction_MatchByGroupAndNumber() const;
+    void sortMatchesByGroupAndNumber(MatchList& ml, const std::unordered_map<int, int>& maId2GrpNum) const;
   };
 
 }
@@ -138,7 +138,7 @@ QStringList Standings::getReportLocators() const
 
 //----------------------------------------------------------------------------
 
-int Standings::determineBestPossibleRankForPlayerAfterRound(const PlayerPair& pp, int round) const
+int Standings::determineBestPossibleRankForPlayerAfterRound(const PlayerPair& pp, int round, const PairRoundMatchMap& matchMap) const
 {
   // we can only determine the best possible final rank if we
   // are in the MatchSystem::Ranking match system
@@ -174,7 +174,7 @@ int Standings::determineBestPossibleRankForPlayerAfterRound(const PlayerPair& pp
   MatchMngr mm{db};
   while (!lastMatch  && (_r > 0))
   {
-    lastMatch = mm.getMatchForPlayerPairAndRound(pp, _r);
+    lastMatch = matchMap.getMatch(pp, _r);
     if (lastMatch && (lastMatch->is_NOT_InState(ObjState::MA_Finished)))
     {
       lastMatch.reset();   // skip all matches that are not finished
@@ -211,7 +211,7 @@ int Standings::determineBestPossibleRankForPlayerAfterRound(const PlayerPair& pp
 
   // a little helper function to get the next match for a match winner
   int finalRound = crs.getTotalRoundsCount();
-  auto getNextWinnerMatch = [this, &finalRound, &mm](const Match& ma) -> std::optional<Match> {
+  auto getNextWinnerMatch = [this, &finalRound, &mm, &matchMap](const Match& ma) -> std::optional<Match> {
     if (ma.getWinnerRank() > 0)
     {
       return {};  // no next match
@@ -225,15 +225,8 @@ int Standings::determineBestPossibleRankForPlayerAfterRound(const PlayerPair& pp
       assert(w);
       int r = ma.getMatchGroup().getRound();
 
-      ++r;
-      std::optional<Match> nextMatch{};
-      while (!nextMatch && (r <= finalRound))
-      {
-        nextMatch = mm.getMatchForPlayerPairAndRound(*w, r);
-        ++r;
-      }
-
-      return nextMatch;   // it's either the match or nullptr to indicate an error
+      // it's either the match or nullptr to indicate an error
+      return matchMap.getFirstMatchInRounds(*w, r + 1, finalRound);
     }
 
     // the match is not yet finished, so we need to search for symbolic
@@ -257,13 +250,7 @@ int Standings::determineBestPossibleRankForPlayerAfterRound(const PlayerPair& pp
   // final rank for the player (see check above) there must be a future match for this player
   // and the match must be identifiable by the pair ID, not by a symbolic name (the symbolic
   // name should be resolved by now).
-  _r = round + 1;
-  std::optional<Match> nextMatch{};
-  while (!nextMatch && (_r <= finalRound))
-  {
-    nextMatch = mm.getMatchForPlayerPairAndRound(pp, _r);
-    ++_r;
-  }
+  auto nextMatch = matchMap.getFirstMatchInRounds(pp, round + 1, finalRound);
 
   if (!nextMatch)
   {
@@ -312,11 +299,16 @@ void Standings::printBestCaseList(upSimpleReport& rep) const
   tw.setHeader(0, tr("Player"));
   tw.setHeader(1, tr("Best case final place"));
 
+  // retrieve all matches of all pairs at once instead
+  // of searching them pair by pair and round by round
+  MatchMngr mm{db};
+  const PairRoundMatchMap matchMap = mm.getMatchesByPairAndRound(cat);
+
   for (PlayerPair pp : ppList)
   {
     QStringList rowContent;
     rowContent << pp.getDisplayName();
-    int bestCaseRank = determineBestPossibleRankForPlayerAfterRound(pp, round);
+    int bestCaseRank = determineBestPossibleRankForPlayerAfterRound(pp, round, matchMap);
     if (bestCaseRank > 0)
     {
       rowContent << QString::number(bestCaseRank);
@@ -29,6 +29,8 @@
 
 namespace QTournament
 {
+  class PairRoundMatchMap;
+
   class Standings : public QObject, public AbstractReport
   {
     Q_OBJECT
@@ -43,7 +45,7 @@ namespace QTournament
     const Category cat;  // DO NOT USE REFERENCES HERE, because this report might out-live the caller and its local objects
     int round;
 
-    int determineBestPossibleRankForPlayerAfterRound(const PlayerPair& pp, int round) const;
+    int determineBestPossibleRankForPlayerAfterRound(const PlayerPair& pp, int round, const PairRoundMatchMap& matchMap) const;
     void printBestCaseList(upSimpleReport& rep) const;
   };
 
@@ -0,0 +1,99 @@
+#include "ScenarioTestHelpers.h"
+#include "../TournamentDataDefs.h"
+#include "../MatchMngr.h"
+#include "../CourtMngr.h"
+#include "../Score.h"
+#include "../CatRoundStatus.h"
+
+#include "bench/BenchScenario.h"
+#include "bench/PhaseStats.h"
+
+using namespace std;
+
+namespace QTournament::Test
+{
+
+  unique_ptr<TournamentDB> createStartedTournament(int nPlayersPerCat, int nCourts)
+  {
+    TournamentSettings tCfg{"Test", "Test", RefereeMode::None, false};
+    auto db = make_unique<TournamentDB>(":memory:", tCfg);
+
+    Bench::ScenarioConfig cfg;
+    cfg.nPlayers = 4 * nPlayersPerCat;
+    cfg.nCatsPerSystem = 1;
+    cfg.nPlayersPerCat = nPlayersPerCat;
+    cfg.nCourts = nCourts;
+
+    Bench::QueryCounter qc{*db};
+    Bench::PhaseStats stats{qc};
+    if (Bench::setupTournament(*db, cfg, stats) != Error::OK) return nullptr;
+
+    return db;
+  }
+
+  //----------------------------------------------------------------------------
+
+  Error stageAllMatchGroups(const TournamentDB& db)
+  {
+    MatchMngr mm{db};
+    bool hasStaged = true;
+    while (hasStaged)
+    {
+      hasStaged = false;
+      for (const MatchGroup& mg : mm.getAllMatchGroups())
+      {
+        if (mm.canStageMatchGroup(mg) != Error::OK) continue;
+
+        Error e = mm.stageMatchGroup(mg);
+        if (e != Error::OK) return e;
+        hasStaged = true;
+      }
+    }
+
+    return Error::OK;
+  }
+
+  //----------------------------------------------------------------------------
+
+  Error callMatch(const TournamentDB& db, const Match& ma)
+  {
+    CourtMngr cm{db};
+    auto court = cm.getNextUnusedCourt();
+    if (!court) return Error::NoCourtAvail;
+
+    MatchMngr mm{db};
+    return mm.assignMatchToCourt(ma, *court);
+  }
+
+  //----------------------------------------------------------------------------
+
+  Error playMatch(const TournamentDB& db, const Match& ma)
+  {
+    Error e = callMatch(db, ma);
+    if (e != Error::OK) return e;
+
+    MatchMngr mm{db};
+    auto score = MatchScore::genRandomScore();
+    return mm.setMatchScoreAndFinalizeMatch(ma, *score).err;
+  }
+
+  //----------------------------------------------------------------------------
+
+  Error playRound(const TournamentDB& db, const Category& cat, int round)
+  {
+    MatchMngr mm{db};
+    for (const MatchGroup& mg : mm.getMatchGroupsForCat(cat, round))
+    {
+      for (const Match& ma : mm.getMatchesForMatchGroup(mg))
+      {
+        if (ma.getState() == ObjState::MA_Finished) continue;
+
+        Error e = playMatch(db, ma);
+        if (e != Error::OK) return e;
+      }
+    }
+
+    return (cat.getRoundStatus().getFinishedRoundsCount() >= round) ? Error::OK : Error::RoundNotFinished;
+  }
+
+}
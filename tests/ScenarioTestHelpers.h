@@ -0,0 +1,40 @@
+#ifndef SCENARIOTESTHELPERS_H
+#define SCENARIOTESTHELPERS_H
+
+#include <memory>
+
+#include "../TournamentDB.h"
+#include "../TournamentErrorCodes.h"
+#include "../Match.h"
+#include "../Category.h"
+
+namespace QTournament::Test
+{
+  /** \brief Creates an in-memory tournament without teams and umpires and
+   * a started category for each match system of the benchmark
+   *
+   * \returns `nullptr` if the setup failed
+   */
+  std::unique_ptr<TournamentDB> createStartedTournament(int nPlayersPerCat = 8, int nCourts = 4);
+
+  /** \brief Stages all match groups that can be staged, including groups
+   * that become stageable by staging others
+   */
+  Error stageAllMatchGroups(const TournamentDB& db);
+
+  /** \brief Calls a match on the next free court
+   */
+  Error callMatch(const TournamentDB& db, const Match& ma);
+
+  /** \brief Calls a match and finishes it with a random result
+   */
+  Error playMatch(const TournamentDB& db, const Match& ma);
+
+  /** \brief Plays all unfinished matches of a category's round
+   *
+   * \returns Error::RoundNotFinished if the round isn't finished afterwards
+   */
+  Error playRound(const TournamentDB& db, const Category& cat, int round);
+}
+
+#endif // SCENARIOTESTHELPERS_H
@@ -0,0 +1,364 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2019  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <deque>
+#include <stdexcept>
+
+#include <QString>
+
+#include "BenchScenario.h"
+#include "PlayerMngr.h"
+#include "CatMngr.h"
+#include "CourtMngr.h"
+#include "MatchMngr.h"
+#include "KO_Config.h"
+#include "BackendAPI.h"
+
+using namespace std;
+
+namespace QTournament::Bench
+{
+  namespace
+  {
+    // a short tag for each match system; used for category names
+    QString msysTag(MatchSystem msys)
+    {
+      switch (msys)
+      {
+      case MatchSystem::SwissLadder:
+        return "SL";
+      case MatchSystem::GroupsWithKO:
+        return "GKO";
+      case MatchSystem::RoundRobin:
+        return "RR";
+      case MatchSystem::Bracket:
+        return "BR";
+      default:
+        return "XX";
+      }
+    }
+
+    //----------------------------------------------------------------------------
+
+    // the number of players that we can actually use
+    // in a category of a given match system
+    int effectivePlayerCount(MatchSystem msys, int nRequested)
+    {
+      switch (msys)
+      {
+      case MatchSystem::Bracket:
+        return min(nRequested, 16);   // largest available single elimination bracket
+
+      case MatchSystem::GroupsWithKO:
+      {
+        // groups of four, between 2 and 16 groups
+        int nGroups = clamp(nRequested / 4, 2, 16);
+        return nGroups * 4;
+      }
+
+      default:
+        return nRequested;
+      }
+    }
+
+    //----------------------------------------------------------------------------
+
+    // the KO start level for a given number of groups;
+    // only the group winners survive
+    KO_Start koStartForGroupCount(int nGroups)
+    {
+      if (nGroups <= 2) return KO_Start::Final;
+      if (nGroups <= 4) return KO_Start::Semi;
+      if (nGroups <= 8) return KO_Start::Quarter;
+      return KO_Start::L16;
+    }
+
+    //----------------------------------------------------------------------------
+
+    Error startCategory(const TournamentDB& db, const Category& cat)
+    {
+      CatMngr cmngr{db};
+
+      Error e = cmngr.freezeConfig(cat);
+      if (e != Error::OK) return e;
+
+      auto specialCat = cat.convertToSpecializedObject();
+      PlayerPairList allPairs = cat.getPlayerPairs();
+
+      std::vector<PlayerPairList> grpCfg;
+      if (specialCat->needsGroupInitialization())
+      {
+        for (size_t idx = 0; idx < allPairs.size(); idx += 4)
+        {
+          grpCfg.push_back(PlayerPairList(begin(allPairs) + idx, begin(allPairs) + idx + 4));
+        }
+      }
+
+      PlayerPairList seed;
+      if (specialCat->needsInitialRanking())
+      {
+        seed = allPairs;
+      }
+
+      return cmngr.startCategory(cat, grpCfg, seed);
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  const std::vector<MatchSystem>& benchMatchSystems()
+  {
+    // "Randomize" is not implemented and thus skipped
+    static const std::vector<MatchSystem> allSys{
+      MatchSystem::SwissLadder,
+      MatchSystem::GroupsWithKO,
+      MatchSystem::RoundRobin,
+      MatchSystem::Bracket,
+    };
+
+    return allSys;
+  }
+
+  //----------------------------------------------------------------------------
+
+  Error setupTournament(const TournamentDB& db, const ScenarioConfig& cfg, PhaseStats& stats)
+  {
+    PlayerMngr pmngr{db};
+    CatMngr cmngr{db};
+    CourtMngr courtm{db};
+
+    mt19937 rng{cfg.seed};
+
+    // players; all male so that they fit into all categories
+    for (int i = 1; i <= cfg.nPlayers; ++i)
+    {
+      Error e = stats.measure(Phase::Setup, [&]()
+      {
+        return pmngr.createNewPlayer("First" + QString::number(i), "Bench" + QString::number(i), Sex::M, "");
+      });
+      if (e != Error::OK) return e;
+    }
+
+    // courts
+    for (int i = 1; i <= cfg.nCourts; ++i)
+    {
+      auto co = stats.measure(Phase::Setup, [&]()
+      {
+        return courtm.createNewCourt(i, "Bench");
+      });
+      if (!co) return co.err();
+    }
+
+    // categories with randomly selected players
+    std::vector<int> playerIds(cfg.nPlayers);
+    iota(begin(playerIds), end(playerIds), 1);
+    std::vector<Category> allCats;
+    for (MatchSystem msys : benchMatchSystems())
+    {
+      const int nCatPlayers = effectivePlayerCount(msys, cfg.nPlayersPerCat);
+      if (nCatPlayers > cfg.nPlayers) return Error::InvalidPlayerCount;
+
+      for (int catIdx = 0; catIdx < cfg.nCatsPerSystem; ++catIdx)
+      {
+        const QString catName = msysTag(msys) + "-" + QString::number(catIdx + 1);
+
+        Error e = stats.measure(Phase::Setup, [&]()
+        {
+          Error err = cmngr.createNewCategory(catName);
+          if (err != Error::OK) return err;
+
+          Category cat = cmngr.getCategory(catName);
+          cat.setMatchType(MatchType::Singles);
+          cat.setSex(Sex::M);
+          err = cmngr.setMatchSystem(cat, msys);
+          if (err != Error::OK) return err;
+
+          if (msys == MatchSystem::GroupsWithKO)
+          {
+            const int nGroups = nCatPlayers / 4;
+            GroupDefList gdl;
+            gdl.append(GroupDef{4, nGroups});
+            KO_Config koCfg{koStartForGroupCount(nGroups), false, gdl};
+            cat.setParameter(CatParameter::GroupConfig, koCfg.toString());
+          }
+
+          return Error::OK;
+        });
+        if (e != Error::OK) return e;
+
+        Category cat = cmngr.getCategory(catName);
+        shuffle(begin(playerIds), end(playerIds), rng);
+        for (int i = 0; i < nCatPlayers; ++i)
+        {
+          Player p = pmngr.getPlayer(playerIds[i]);
+          e = stats.measure(Phase::Setup, [&]()
+          {
+            return cmngr.addPlayerToCategory(p, cat);
+          });
+          if (e != Error::OK) return e;
+        }
+
+        allCats.push_back(cat);
+      }
+    }
+
+    // start all categories
+    for (const Category& cat : allCats)
+    {
+      Error e = stats.measure(Phase::StartCategory, [&]()
+      {
+        return startCategory(db, cat);
+      });
+      if (e != Error::OK) return e;
+    }
+
+    return Error::OK;
+  }
+
+  //----------------------------------------------------------------------------
+
+  RunSummary playTournament(const TournamentDB& db, PhaseStats& stats, const std::function<void()>& afterMatchResult)
+  {
+    MatchMngr mm{db};
+    CatMngr cmngr{db};
+    CourtMngr courtm{db};
+
+    RunSummary summary;
+    std::deque<Match> runningMatches;
+
+    bool hasProgress = true;
+    while (hasProgress)
+    {
+      hasProgress = false;
+
+      // stage everything that can be staged; staging a
+      // match group may enable staging of other match groups
+      int nStaged = 0;
+      bool hasStaged = true;
+      while (hasStaged)
+      {
+        hasStaged = false;
+        for (const MatchGroup& mg : mm.getAllMatchGroups())
+        {
+          if (mg.is_NOT_InState(ObjState::MG_Idle)) continue;
+
+          Error e = stats.measure(Phase::Staging, [&]()
+          {
+            Error err = mm.canStageMatchGroup(mg);
+            return (err == Error::OK) ? mm.stageMatchGroup(mg) : err;
+          });
+          if (e == Error::OK)
+          {
+            hasStaged = true;
+            ++nStaged;
+          }
+        }
+      }
+      if (nStaged > 0)
+      {
+        stats.measure(Phase::Scheduling, [&]()
+        {
+          mm.scheduleAllStagedMatchGroups();
+        });
+        hasProgress = true;
+      }
+
+      // call matches until we run out of courts or matches
+      while (true)
+      {
+        auto nextMatch = API::Qry::nextCallableMatch(db);
+        if (!nextMatch) break;
+        auto nextCourt = courtm.getNextUnusedCourt();
+        if (!nextCourt) break;
+
+        Error e = stats.measure(Phase::MatchCall, [&]()
+        {
+          return mm.assignMatchToCourt(*nextMatch, *nextCourt);
+        });
+        if (e != Error::OK)
+        {
+          throw std::runtime_error{"playTournament(): could not call match " + to_string(nextMatch->getId())};
+        }
+
+        runningMatches.push_back(*nextMatch);
+        hasProgress = true;
+      }
+
+      // finish the longest running match
+      if (!runningMatches.empty())
+      {
+        Match ma = runningMatches.front();
+        runningMatches.pop_front();
+
+        auto score = MatchScore::genRandomScore();
+        auto result = stats.measureClassified([&]()
+        {
+          return mm.setMatchScoreAndFinalizeMatch(ma, *score);
+        },
+        [](const MatchFinalizationResult& r)
+        {
+          return (r.completedRound ? Phase::RoundCompletion : Phase::MatchResult);
+        });
+        if (result.err != Error::OK)
+        {
+          throw std::runtime_error{"playTournament(): could not finalize match " + to_string(ma.getId())};
+        }
+
+        ++summary.nFinishedMatches;
+        hasProgress = true;
+
+        if (result.completedRound)
+        {
+          ++summary.nCompletedRounds;
+
+          // a completed round might have sent a category
+          // to the intermediate seeding state
+          for (const Category& cat : cmngr.getAllCategories())
+          {
+            if (cat.is_NOT_InState(ObjState::CAT_WaitForIntermediateSeeding)) continue;
+
+            auto specialCat = cat.convertToSpecializedObject();
+            const PlayerPairList seed = specialCat->getPlayerPairsForIntermediateSeeding();
+            Error e = stats.measure(Phase::Seeding, [&]()
+            {
+              return cmngr.continueWithIntermediateSeeding(cat, seed);
+            });
+            if (e != Error::OK)
+            {
+              throw std::runtime_error{"playTournament(): intermediate seeding failed for category " + to_string(cat.getId())};
+            }
+          }
+        }
+
+        if (afterMatchResult) afterMatchResult();
+      }
+    }
+
+    for (const Category& cat : cmngr.getAllCategories())
+    {
+      ++summary.nCategories;
+      if (cat.isInState(ObjState::CAT_Finalized)) ++summary.nFinishedCategories;
+    }
+
+    return summary;
+  }
+
+}
@@ -0,0 +1,93 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2019  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BENCHSCENARIO_H
+#define BENCHSCENARIO_H
+
+#include <vector>
+#include <functional>
+
+#include "TournamentDB.h"
+#include "TournamentDataDefs.h"
+#include "PhaseStats.h"
+
+namespace QTournament::Bench
+{
+  /** \brief Parameters for a synthetic tournament
+   */
+  struct ScenarioConfig
+  {
+    int nPlayers{200};   ///< total number of players in the tournament
+    int nCatsPerSystem{2};   ///< number of categories that are created for each supported match system
+    int nPlayersPerCat{16};   ///< number of players in each category
+    int nCourts{10};   ///< number of courts
+    unsigned int seed{42};   ///< seed for the random number generator; identical seeds yield identical tournaments
+  };
+
+  /** \brief Summary of a completed benchmark run
+   */
+  struct RunSummary
+  {
+    int nCategories{0};
+    int nFinishedCategories{0};
+    int nFinishedMatches{0};
+    int nCompletedRounds{0};
+  };
+
+  /** \brief The match systems that are covered by the benchmark
+   */
+  const std::vector<MatchSystem>& benchMatchSystems();
+
+  /** \brief Creates players, categories and courts according to a
+   * given configuration and starts all categories
+   *
+   * All operations are accounted for in the provided statistics.
+   *
+   * \returns Error::OK if all categories could be started
+   */
+  Error setupTournament(const TournamentDB& db, const ScenarioConfig& cfg, PhaseStats& stats);
+
+  /** \brief Plays all categories until there are no more matches to play
+   *
+   * The loop repeatedly stages and schedules all available match groups,
+   * calls matches on all free courts, finishes the longest running match
+   * with a random result and resolves intermediate seedings.
+   *
+   * \returns a summary of the played tournament
+   */
+  RunSummary playTournament(
+      const TournamentDB& db,
+      PhaseStats& stats,
+      const std::function<void()>& afterMatchResult = nullptr   ///< optional hook that is called after each finished match
+      );
+
+  // the names of all phases that are reported by the benchmark
+  namespace Phase
+  {
+    static constexpr char Setup[] = "Setup";
+    static constexpr char StartCategory[] = "Start category";
+    static constexpr char Staging[] = "Staging";
+    static constexpr char Scheduling[] = "Scheduling";
+    static constexpr char MatchCall[] = "Match call";
+    static constexpr char MatchResult[] = "Match result";
+    static constexpr char RoundCompletion[] = "Round completion";
+    static constexpr char Seeding[] = "Intermediate seeding";
+  }
+}
+
+#endif // BENCHSCENARIO_H
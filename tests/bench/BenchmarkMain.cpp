@@ -0,0 +1,168 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2019  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <exception>
+
+#include <QFile>
+#include <QtGlobal>
+
+#include "TournamentDB.h"
+#include "BenchScenario.h"
+#include "PhaseStats.h"
+
+using namespace std;
+using namespace QTournament;
+
+namespace
+{
+  void printUsage(const char* progName)
+  {
+    cerr << "Usage: " << progName << " [options]" << endl;
+    cerr << endl;
+    cerr << "  -p <n>     number of players (default: 200)" << endl;
+    cerr << "  -c <n>     number of categories per match system (default: 2)" << endl;
+    cerr << "  -g <n>     number of players per category (default: 16)" << endl;
+    cerr << "  -k <n>     number of courts (default: 10)" << endl;
+    cerr << "  -s <n>     random seed (default: 42)" << endl;
+    cerr << "  -f <file>  database file; will be overwritten (default: bench.tdb)" << endl;
+    cerr << "  -m <mode>  storage mode: \"journal\" (file with rollback journal, default)," << endl;
+    cerr << "             \"wal\" (file in WAL mode) or \"memory\" (in-memory database)" << endl;
+    cerr << "  --csv      print the results as CSV" << endl;
+  }
+}
+
+int main(int argc, char** argv)
+{
+  Bench::ScenarioConfig cfg;
+  string dbFileName{"bench.tdb"};
+  string storageMode{"journal"};
+  bool asCSV{false};
+
+  for (int i = 1; i < argc; ++i)
+  {
+    const string arg{argv[i]};
+    if (arg == "--csv")
+    {
+      asCSV = true;
+      continue;
+    }
+
+    if ((arg.size() != 2) || (arg[0] != '-') || (i == (argc - 1)))
+    {
+      printUsage(argv[0]);
+      return 1;
+    }
+
+    const string val{argv[++i]};
+    switch (arg[1])
+    {
+    case 'p':
+      cfg.nPlayers = stoi(val);
+      break;
+    case 'c':
+      cfg.nCatsPerSystem = stoi(val);
+      break;
+    case 'g':
+      cfg.nPlayersPerCat = stoi(val);
+      break;
+    case 'k':
+      cfg.nCourts = stoi(val);
+      break;
+    case 's':
+      cfg.seed = static_cast<unsigned int>(stoul(val));
+      break;
+    case 'f':
+      dbFileName = val;
+      break;
+    case 'm':
+      storageMode = val;
+      break;
+    default:
+      printUsage(argv[0]);
+      return 1;
+    }
+  }
+
+  // genRandomScore() uses qrand()
+  qsrand(cfg.seed);
+
+  if ((storageMode != "journal") && (storageMode != "wal") && (storageMode != "memory"))
+  {
+    printUsage(argv[0]);
+    return 1;
+  }
+  if (storageMode == "memory")
+  {
+    dbFileName = ":memory:";
+  } else {
+    // stale WAL files from a previous run must not be replayed into the new file
+    for (const string& suffix : {"", "-wal", "-shm"})
+    {
+      QFile::remove(QString::fromStdString(dbFileName + suffix));
+    }
+  }
+
+  TournamentSettings tCfg{"Benchmark", "Benchmark", RefereeMode::None, false};
+  TournamentDB db{dbFileName, tCfg};
+  if ((storageMode == "wal") && !db.enableWalMode())
+  {
+    cerr << "Could not switch " << dbFileName << " to WAL mode" << endl;
+    return 1;
+  }
+
+  Bench::QueryCounter qc{db};
+  Bench::PhaseStats stats{qc};
+
+  Bench::RunSummary summary;
+  try
+  {
+    Error e = Bench::setupTournament(db, cfg, stats);
+    if (e != Error::OK)
+    {
+      cerr << "Setup failed with error code " << static_cast<int>(e) << endl;
+      return 1;
+    }
+
+    summary = Bench::playTournament(db, stats);
+  }
+  catch (std::exception& ex)
+  {
+    cerr << "Benchmark aborted: " << ex.what() << endl;
+    return 1;
+  }
+
+  if (asCSV)
+  {
+    stats.printCSV(cout);
+  } else {
+    cout << "Storage: " << storageMode << endl;
+    cout << "Players: " << cfg.nPlayers << ", categories: " << summary.nCategories
+         << " (" << summary.nFinishedCategories << " finished), courts: " << cfg.nCourts
+         << ", matches: " << summary.nFinishedMatches << ", rounds: " << summary.nCompletedRounds << endl;
+    const StatementCache& sc = db.getStatementCache();
+    cout << "Statement cache: " << sc.getHitCount() << " hits, " << sc.getPrepareCount() << " prepares, "
+         << sc.getReprepareCount() << " re-prepares" << endl;
+    cout << endl;
+    stats.printTable(cout);
+  }
+
+  return (summary.nFinishedCategories == summary.nCategories) ? 0 : 2;
+}
@@ -0,0 +1,233 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2019  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <atomic>
+#include <memory>
+#include <new>
+#include <exception>
+
+#include <QFile>
+#include <QtGlobal>
+
+#include "TournamentDB.h"
+#include "MatchMngr.h"
+#include "PlayerMngr.h"
+#include "ObjectHandle.h"
+#include "BenchScenario.h"
+#include "PhaseStats.h"
+
+using namespace std;
+using namespace QTournament;
+
+namespace
+{
+  // the number of heap allocations since program start
+  std::atomic<size_t> allocCount{0};
+}
+
+// count all heap allocations of the process; that's crude
+// but sufficient for comparing two code paths that run
+// directly after each other
+void* operator new(size_t sz)
+{
+  ++allocCount;
+  void* p = malloc((sz == 0) ? 1 : sz);
+  if (p == nullptr) throw std::bad_alloc{};
+  return p;
+}
+
+void operator delete(void* p) noexcept
+{
+  free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+  free(p);
+}
+
+namespace
+{
+  struct Sample
+  {
+    size_t nObjects{0};
+    size_t nAllocs{0};
+    double time_us{0.0};
+  };
+
+  // runs "f" "nRounds" times and returns the average number
+  // of allocations and the average time per round
+  template<class F>
+  Sample measure(int nRounds, F f)
+  {
+    Sample result;
+    const size_t allocsBefore = allocCount;
+    auto start = chrono::steady_clock::now();
+    for (int r = 0; r < nRounds; ++r)
+    {
+      result.nObjects = f();
+    }
+    auto elapsed = chrono::steady_clock::now() - start;
+    result.nAllocs = (allocCount - allocsBefore) / nRounds;
+    result.time_us = chrono::duration<double, micro>(elapsed).count() / nRounds;
+
+    return result;
+  }
+
+  void printSample(const string& label, const Sample& s)
+  {
+    cout << left << setw(40) << label << right
+         << setw(8) << s.nObjects << " objects, "
+         << setw(8) << s.nAllocs << " allocations, "
+         << fixed << setprecision(1) << setw(10) << s.time_us << " us" << endl;
+  }
+
+  void printUsage(const char* progName)
+  {
+    cerr << "Usage: " << progName << " [options]" << endl;
+    cerr << endl;
+    cerr << "  -f <file>  use an existing tournament file instead of a synthetic tournament" << endl;
+    cerr << "  -p <n>     number of players in the synthetic tournament (default: 2000)" << endl;
+    cerr << "  -c <n>     number of categories per match system (default: 16)" << endl;
+    cerr << "  -g <n>     number of players per category (default: 32)" << endl;
+    cerr << "  -r <n>     number of repetitions per measurement (default: 20)" << endl;
+  }
+}
+
+/*
+ * Compares full domain objects with lightweight ID handles for
+ * the two biggest lists in a tournament: finished matches and players.
+ *
+ * The synthetic default tournament has well over 5000 finished matches.
+ */
+int main(int argc, char** argv)
+{
+  Bench::ScenarioConfig cfg;
+  cfg.nPlayers = 2000;
+  cfg.nCatsPerSystem = 16;
+  cfg.nPlayersPerCat = 32;
+  cfg.nCourts = 40;
+  string dbFileName;
+  int nRounds{20};
+
+  for (int i = 1; i < argc; ++i)
+  {
+    const string arg{argv[i]};
+    if ((arg.size() != 2) || (arg[0] != '-') || (i == (argc - 1)))
+    {
+      printUsage(argv[0]);
+      return 1;
+    }
+
+    const string val{argv[++i]};
+    switch (arg[1])
+    {
+    case 'f':
+      dbFileName = val;
+      break;
+    case 'p':
+      cfg.nPlayers = stoi(val);
+      break;
+    case 'c':
+      cfg.nCatsPerSystem = stoi(val);
+      break;
+    case 'g':
+      cfg.nPlayersPerCat = stoi(val);
+      break;
+    case 'r':
+      nRounds = max(1, stoi(val));
+      break;
+    default:
+      printUsage(argv[0]);
+      return 1;
+    }
+  }
+
+  // genRandomScore() uses qrand()
+  qsrand(cfg.seed);
+
+  try
+  {
+    unique_ptr<TournamentDB> db;
+    if (!dbFileName.empty())
+    {
+      if (!QFile::exists(QString::fromStdString(dbFileName)))
+      {
+        cerr << "File not found: " << dbFileName << endl;
+        return 1;
+      }
+      db = make_unique<TournamentDB>(dbFileName);
+    } else {
+      TournamentSettings tCfg{"Benchmark", "Benchmark", RefereeMode::None, false};
+      db = make_unique<TournamentDB>(":memory:", tCfg);
+
+      Bench::QueryCounter qc{*db};
+      Bench::PhaseStats stats{qc};
+      Error e = Bench::setupTournament(*db, cfg, stats);
+      if (e != Error::OK)
+      {
+        cerr << "Setup failed with error code " << static_cast<int>(e) << endl;
+        return 1;
+      }
+      Bench::playTournament(*db, stats);
+    }
+
+    MatchMngr mm{*db};
+    PlayerMngr pm{*db};
+
+    // the legacy path: full objects plus the copy that
+    // happens whenever such a list is passed on by value
+    printSample("getFinishedMatches() + copy", measure(nRounds, [&]()
+    {
+      const MatchList maList = mm.getFinishedMatches();
+      const MatchList maCopy{maList};
+      return maCopy.size();
+    }));
+    printSample("getFinishedMatchHandles() + span", measure(nRounds, [&]()
+    {
+      const MatchHandleList maList = mm.getFinishedMatchHandles();
+      const HandleSpan<Match> maSpan = maList.span();
+      return maSpan.size();
+    }));
+
+    printSample("getAllPlayers() + copy", measure(nRounds, [&]()
+    {
+      const vector<Player> plList = pm.getAllPlayers();
+      const vector<Player> plCopy{plList};
+      return plCopy.size();
+    }));
+    printSample("getAllPlayerHandles() + span", measure(nRounds, [&]()
+    {
+      const PlayerHandleList plList = pm.getAllPlayerHandles();
+      const HandleSpan<Player> plSpan = plList.span();
+      return plSpan.size();
+    }));
+  }
+  catch (std::exception& ex)
+  {
+    cerr << "Benchmark aborted: " << ex.what() << endl;
+    return 1;
+  }
+
+  return 0;
+}
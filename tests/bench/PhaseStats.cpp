@@ -0,0 +1,138 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2019  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <iomanip>
+
+#include <sqlite3.h>
+
+#include "PhaseStats.h"
+
+using namespace std;
+
+namespace QTournament::Bench
+{
+
+  QueryCounter::QueryCounter(const TournamentDB& db)
+    :hdl{db.rawHandle()}
+  {
+    sqlite3_trace_v2(hdl, SQLITE_TRACE_STMT, &QueryCounter::traceCallback, this);
+  }
+
+  //----------------------------------------------------------------------------
+
+  QueryCounter::~QueryCounter()
+  {
+    sqlite3_trace_v2(hdl, 0, nullptr, nullptr);
+  }
+
+  //----------------------------------------------------------------------------
+
+  int QueryCounter::traceCallback(unsigned int evtType, void* ctx, void* stmt, void* sql)
+  {
+    if (evtType != SQLITE_TRACE_STMT) return 0;
+
+    // statements that are executed from within a trigger
+    // are reported with a leading "--"; they are part of the
+    // statement that fired the trigger and thus not counted
+    const char* txt = static_cast<const char*>(sql);
+    if ((txt != nullptr) && (txt[0] == '-') && (txt[1] == '-')) return 0;
+
+    auto self = static_cast<QueryCounter*>(ctx);
+    ++(self->cnt);
+
+    (void) stmt;
+    return 0;
+  }
+
+  //----------------------------------------------------------------------------
+
+  PhaseStats::PhaseStats(const QueryCounter& qc)
+    :qCnt{qc}
+  {
+  }
+
+  //----------------------------------------------------------------------------
+
+  void PhaseStats::printTable(ostream& out) const
+  {
+    out << left << setw(24) << "Phase"
+        << right << setw(10) << "Ops"
+        << setw(14) << "Total [ms]"
+        << setw(14) << "Per op [us]"
+        << setw(12) << "Queries"
+        << setw(14) << "Queries/op" << endl;
+    out << string(88, '-') << endl;
+
+    for (const auto& rec : allRecords)
+    {
+      const double totalMs = chrono::duration<double, milli>(rec.wallTime).count();
+      const double perOpUs = (rec.ops > 0) ? (chrono::duration<double, micro>(rec.wallTime).count() / rec.ops) : 0.0;
+      const double qPerOp = (rec.ops > 0) ? (static_cast<double>(rec.queries) / rec.ops) : 0.0;
+
+      out << left << setw(24) << rec.name
+          << right << setw(10) << rec.ops
+          << setw(14) << fixed << setprecision(1) << totalMs
+          << setw(14) << fixed << setprecision(1) << perOpUs
+          << setw(12) << rec.queries
+          << setw(14) << fixed << setprecision(2) << qPerOp << endl;
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  void PhaseStats::printCSV(ostream& out) const
+  {
+    out << "phase,ops,total_ns,queries" << endl;
+    for (const auto& rec : allRecords)
+    {
+      out << rec.name << "," << rec.ops << "," << rec.wallTime.count() << "," << rec.queries << endl;
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  PhaseRecord& PhaseStats::getRecord(const string& phaseName)
+  {
+    auto it = find_if(begin(allRecords), end(allRecords), [&phaseName](const PhaseRecord& r)
+    {
+      return (r.name == phaseName);
+    });
+    if (it != end(allRecords)) return *it;
+
+    allRecords.push_back(PhaseRecord{phaseName});
+    return allRecords.back();
+  }
+
+  //----------------------------------------------------------------------------
+
+  PhaseStats::Sample::Sample(const QueryCounter& qc)
+    :qCnt{qc}, q0{qc.count()}, t0{chrono::steady_clock::now()}
+  {
+  }
+
+  //----------------------------------------------------------------------------
+
+  void PhaseStats::Sample::addTo(PhaseRecord& rec) const
+  {
+    rec.wallTime += chrono::steady_clock::now() - t0;
+    rec.queries += qCnt.count() - q0;
+    ++rec.ops;
+  }
+
+}
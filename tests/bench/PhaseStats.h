@@ -0,0 +1,139 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2019  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PHASESTATS_H
+#define PHASESTATS_H
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <ostream>
+#include <type_traits>
+
+#include "TournamentDB.h"
+
+namespace QTournament::Bench
+{
+  /** \brief Counts all SQL statements that are executed on a database
+   * connection while an instance of this class is alive
+   *
+   * Statements executed from within triggers are not counted separately.
+   */
+  class QueryCounter
+  {
+  public:
+    explicit QueryCounter(const TournamentDB& db);
+    ~QueryCounter();
+
+    QueryCounter(const QueryCounter&) = delete;
+    QueryCounter& operator=(const QueryCounter&) = delete;
+
+    /** \returns the number of statements that have been executed since construction
+     */
+    long long count() const { return cnt; }
+
+  private:
+    static int traceCallback(unsigned int evtType, void* ctx, void* stmt, void* sql);
+    sqlite3* hdl;
+    long long cnt{0};
+  };
+
+  //----------------------------------------------------------------------------
+
+  /** \brief Accumulated cost of one phase of the tournament workflow
+   */
+  struct PhaseRecord
+  {
+    std::string name;
+    long long ops{0};   ///< number of high-level operations (e.g., "stage one match group")
+    std::chrono::nanoseconds wallTime{0};
+    long long queries{0};
+  };
+
+  //----------------------------------------------------------------------------
+
+  /** \brief Collects wall time and query counts for named phases
+   * and prints them as a table or as CSV
+   */
+  class PhaseStats
+  {
+  public:
+    explicit PhaseStats(const QueryCounter& qc);
+
+    /** \brief Executes a function and adds its wall time and its
+     * query count to the given phase
+     *
+     * \returns whatever the function returns
+     */
+    template<typename Func>
+    auto measure(const std::string& phaseName, Func f)
+    {
+      Sample smp{qCnt};
+      if constexpr (std::is_void_v<decltype(f())>)
+      {
+        f();
+        smp.addTo(getRecord(phaseName));
+      } else {
+        auto result = f();
+        smp.addTo(getRecord(phaseName));
+        return result;
+      }
+    }
+
+    /** \brief Executes a function and adds its wall time and its
+     * query count to a phase that is determined from the function's result
+     *
+     * Used for operations that can only be attributed after they
+     * have been executed (e.g., a match result that completes a round).
+     *
+     * \returns whatever the function returns
+     */
+    template<typename Func, typename Classifier>
+    auto measureClassified(Func f, Classifier phaseOf)
+    {
+      Sample smp{qCnt};
+      auto result = f();
+      smp.addTo(getRecord(phaseOf(result)));
+      return result;
+    }
+
+    const std::vector<PhaseRecord>& records() const { return allRecords; }
+
+    void printTable(std::ostream& out) const;
+    void printCSV(std::ostream& out) const;
+
+  protected:
+    struct Sample
+    {
+      explicit Sample(const QueryCounter& qc);
+      void addTo(PhaseRecord& rec) const;
+
+      const QueryCounter& qCnt;
+      long long q0;
+      std::chrono::steady_clock::time_point t0;
+    };
+
+    PhaseRecord& getRecord(const std::string& phaseName);
+
+  private:
+    const QueryCounter& qCnt;
+    std::vector<PhaseRecord> allRecords;
+  };
+}
+
+#endif // PHASESTATS_H
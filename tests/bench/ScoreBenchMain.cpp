@@ -0,0 +1,132 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2019  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+
+#include <QtGlobal>
+
+#include "Score.h"
+
+using namespace std;
+using namespace QTournament;
+
+namespace
+{
+  // runs a conversion function "nRounds" times on all
+  // samples and returns the average time per sample
+  double measure_ns(size_t nSamples, int nRounds, const function<long(size_t)>& f, long& checksum)
+  {
+    auto start = chrono::steady_clock::now();
+    for (int r = 0; r < nRounds; ++r)
+    {
+      for (size_t i = 0; i < nSamples; ++i)
+      {
+        checksum += f(i);
+      }
+    }
+    auto elapsed = chrono::steady_clock::now() - start;
+
+    return chrono::duration<double, nano>(elapsed).count() / (nSamples * static_cast<double>(nRounds));
+  }
+}
+
+/*
+ * Micro-benchmark for the different representations of match scores.
+ *
+ * Compares the legacy string handling (via QString and GameScoreList)
+ * with the allocation-free string functions and the packed integer form.
+ */
+int main(int argc, char** argv)
+{
+  int nRounds = 20;
+  if (argc > 1) nRounds = atoi(argv[1]);
+  if (nRounds <= 0)
+  {
+    cerr << "Usage: " << argv[0] << " [number of rounds]" << endl;
+    return 1;
+  }
+
+  // a mix of two- and three-game matches, with and without draws
+  qsrand(42);
+  constexpr size_t nSamples = 10000;
+  vector<string> asString;
+  vector<int> asPacked;
+  for (size_t i = 0; i < nSamples; ++i)
+  {
+    auto sc = MatchScore::genRandomScore(2, (i % 4) == 0);
+    asString.push_back(sc->toString().toUtf8().constData());
+    asPacked.push_back(sc->toPackedInt());
+  }
+
+  long checksum{0};
+
+  const double legacyParse = measure_ns(nSamples, nRounds, [&](size_t i)
+  {
+    auto sc = MatchScore::fromStringWithoutValidation(QString::fromStdString(asString[i]));
+    return sc->getPointsSum();
+  }, checksum);
+
+  const double charsParse = measure_ns(nSamples, nRounds, [&](size_t i)
+  {
+    auto sc = MatchScore::fromCharsWithoutValidation(asString[i]);
+    return sc->getPointsSum();
+  }, checksum);
+
+  const double packedParse = measure_ns(nSamples, nRounds, [&](size_t i)
+  {
+    auto sc = MatchScore::fromPackedInt(asPacked[i]);
+    return sc->getPointsSum();
+  }, checksum);
+
+  // for formatting, we decode the packed scores once in advance
+  vector<MatchScore> scores;
+  for (int p : asPacked) scores.push_back(*MatchScore::fromPackedInt(p));
+
+  const double legacyFormat = measure_ns(nSamples, nRounds, [&](size_t i)
+  {
+    string s = scores[i].toString().toUtf8().constData();
+    return static_cast<long>(s.size());
+  }, checksum);
+
+  const double charsFormat = measure_ns(nSamples, nRounds, [&](size_t i)
+  {
+    MatchScore::StringBuffer buf;
+    return static_cast<long>(scores[i].toChars(buf).size());
+  }, checksum);
+
+  const double packedFormat = measure_ns(nSamples, nRounds, [&](size_t i)
+  {
+    return static_cast<long>(scores[i].toPackedInt());
+  }, checksum);
+
+  cout << "Samples: " << nSamples << ", rounds: " << nRounds << " (checksum " << checksum << ")" << endl;
+  cout << endl;
+  cout << "                       parse (ns)   format (ns)" << endl;
+  cout << fixed << setprecision(1);
+  cout << "QString (legacy)     " << setw(12) << legacyParse << setw(14) << legacyFormat << endl;
+  cout << "Char buffer          " << setw(12) << charsParse << setw(14) << charsFormat << endl;
+  cout << "Packed integer       " << setw(12) << packedParse << setw(14) << packedFormat << endl;
+
+  return 0;
+}
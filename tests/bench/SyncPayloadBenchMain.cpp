@@ -0,0 +1,180 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2019  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <cstdlib>
+#include <exception>
+
+#include <QtGlobal>
+
+#include "TournamentDB.h"
+#include "ChangeLogStore.h"
+#include "SyncShadow.h"
+#include "SyncString.h"
+#include "BenchScenario.h"
+#include "PhaseStats.h"
+
+using namespace std;
+using namespace QTournament;
+
+namespace
+{
+  struct PayloadStats
+  {
+    int nSyncs{0};
+    size_t nEdits{0};
+    size_t nRows{0};
+    size_t fullRowBytes{0};
+    size_t deltaBytes{0};
+  };
+
+  void printUsage(const char* progName)
+  {
+    cerr << "Usage: " << progName << " [options]" << endl;
+    cerr << endl;
+    cerr << "  -p <n>     number of players (default: 200)" << endl;
+    cerr << "  -c <n>     number of categories per match system (default: 2)" << endl;
+    cerr << "  -g <n>     number of players per category (default: 16)" << endl;
+    cerr << "  -k <n>     number of courts (default: 10)" << endl;
+    cerr << "  -s <n>     random seed (default: 42)" << endl;
+    cerr << "  -n <n>     number of match results between two partial syncs (default: 1)" << endl;
+  }
+}
+
+/*
+ * Compares the payload of partial syncs with complete rows and
+ * with column-level delta encoding.
+ *
+ * A synthetic tournament day is played with a fixed seed and after
+ * every n-th match result the changelog is turned into a partial sync,
+ * exactly like OnlineMngr does it.
+ */
+int main(int argc, char** argv)
+{
+  Bench::ScenarioConfig cfg;
+  int resultsPerSync{1};
+
+  for (int i = 1; i < argc; ++i)
+  {
+    const string arg{argv[i]};
+    if ((arg.size() != 2) || (arg[0] != '-') || (i == (argc - 1)))
+    {
+      printUsage(argv[0]);
+      return 1;
+    }
+
+    const string val{argv[++i]};
+    switch (arg[1])
+    {
+    case 'p':
+      cfg.nPlayers = stoi(val);
+      break;
+    case 'c':
+      cfg.nCatsPerSystem = stoi(val);
+      break;
+    case 'g':
+      cfg.nPlayersPerCat = stoi(val);
+      break;
+    case 'k':
+      cfg.nCourts = stoi(val);
+      break;
+    case 's':
+      cfg.seed = static_cast<unsigned int>(stoul(val));
+      break;
+    case 'n':
+      resultsPerSync = max(1, stoi(val));
+      break;
+    default:
+      printUsage(argv[0]);
+      return 1;
+    }
+  }
+
+  // genRandomScore() uses qrand()
+  qsrand(cfg.seed);
+
+  TournamentSettings tCfg{"Benchmark", "Benchmark", RefereeMode::None, false};
+  TournamentDB db{":memory:", tCfg};
+
+  Bench::QueryCounter qc{db};
+  Bench::PhaseStats stats{qc};
+
+  PayloadStats ps;
+  size_t fullSyncBytes{0};
+  try
+  {
+    Error e = Bench::setupTournament(db, cfg, stats);
+    if (e != Error::OK)
+    {
+      cerr << "Setup failed with error code " << static_cast<int>(e) << endl;
+      return 1;
+    }
+
+    // the session starts with a full sync
+    SyncShadow shadow;
+    const string fullSync = getFullSyncString(db);
+    fullSyncBytes = fullSync.size();
+    shadow.apply(fullSync);
+    db.enableChangeLog(true);
+
+    ChangeLogStore pendingChanges;
+    auto doPartialSync = [&]()
+    {
+      pendingChanges.add(db.getAllChangesAndClearQueue());
+      if (pendingChanges.empty()) return;
+
+      const auto log = pendingChanges.getCompactedLog();
+      const string csv = getSyncStringForChanges(db, log);
+      const string delta = shadow.encodeDelta(csv);
+      shadow.apply(csv);
+
+      ++ps.nSyncs;
+      ps.nEdits += pendingChanges.getEditCount();
+      ps.nRows += log.size();
+      ps.fullRowBytes += csv.size();
+      ps.deltaBytes += delta.size();
+      pendingChanges.clear();
+    };
+
+    int nResults{0};
+    Bench::playTournament(db, stats, [&]()
+    {
+      if ((++nResults % resultsPerSync) == 0) doPartialSync();
+    });
+    doPartialSync();
+  }
+  catch (std::exception& ex)
+  {
+    cerr << "Benchmark aborted: " << ex.what() << endl;
+    return 1;
+  }
+
+  const double ratio = (ps.fullRowBytes > 0) ? (100.0 * ps.deltaBytes / ps.fullRowBytes) : 0.0;
+  cout << "Full sync:          " << fullSyncBytes << " bytes" << endl;
+  cout << "Partial syncs:      " << ps.nSyncs << " (" << ps.nEdits << " edits, " << ps.nRows << " changed rows)" << endl;
+  cout << "Complete rows:      " << ps.fullRowBytes << " bytes" << endl;
+  cout << "Delta encoded:      " << ps.deltaBytes << " bytes (" << fixed << setprecision(1) << ratio << " %)" << endl;
+  if (ps.nSyncs > 0)
+  {
+    cout << "Average per sync:   " << (ps.fullRowBytes / ps.nSyncs) << " vs. " << (ps.deltaBytes / ps.nSyncs) << " bytes" << endl;
+  }
+
+  return 0;
+}
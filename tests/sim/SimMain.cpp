@@ -0,0 +1,234 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2019  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <memory>
+#include <exception>
+
+#include <QFile>
+#include <QDateTime>
+#include <QtGlobal>
+
+#include "TournamentDB.h"
+#include "CourtMngr.h"
+#include "HelperFunc.h"
+#include "PhaseStats.h"
+#include "SimSetup.h"
+#include "TournamentSimulator.h"
+
+using namespace std;
+using namespace QTournament;
+
+namespace
+{
+  void printUsage(const char* progName)
+  {
+    cerr << "Usage: " << progName << " -f <output file> [options]" << endl;
+    cerr << endl;
+    cerr << "  -f <file>   the database file for the simulation; will be overwritten" << endl;
+    cerr << "  -o <file>   copy an existing tournament file and simulate it" << endl;
+    cerr << "  -C <file>   category definition (name, match system, match type, sex)" << endl;
+    cerr << "  -P <file>   player definition (CSV import format)" << endl;
+    cerr << "  -k <n>      number of courts if the tournament has none yet (default: 8)" << endl;
+    cerr << "  -m <mins>   average match duration (default: 20)" << endl;
+    cerr << "  -d <mins>   standard deviation of the match duration (default: 5)" << endl;
+    cerr << "  -w <secs>   delay between two matches on a court (default: 60)" << endl;
+    cerr << "  -t <time>   start time as \"yyyy-MM-dd hh:mm\" (default: today, 09:00)" << endl;
+    cerr << "  -s <n>      random seed (default: 42)" << endl;
+  }
+
+  //----------------------------------------------------------------------------
+
+  bool readFile(const string& fName, string& content)
+  {
+    ifstream in{fName};
+    if (!in) return false;
+
+    stringstream ss;
+    ss << in.rdbuf();
+    content = ss.str();
+
+    return true;
+  }
+}
+
+int main(int argc, char** argv)
+{
+  Sim::SimConfig cfg;
+  string dbFileName;
+  string srcFileName;
+  string catDefFileName;
+  string playerDefFileName;
+  int nCourts{8};
+  QDateTime startTime{QDate::currentDate(), QTime{9, 0}};
+
+  for (int i = 1; i < argc; ++i)
+  {
+    const string arg{argv[i]};
+    if ((arg.size() != 2) || (arg[0] != '-') || (i == (argc - 1)))
+    {
+      printUsage(argv[0]);
+      return 1;
+    }
+
+    const string val{argv[++i]};
+    switch (arg[1])
+    {
+    case 'f':
+      dbFileName = val;
+      break;
+    case 'o':
+      srcFileName = val;
+      break;
+    case 'C':
+      catDefFileName = val;
+      break;
+    case 'P':
+      playerDefFileName = val;
+      break;
+    case 'k':
+      nCourts = stoi(val);
+      break;
+    case 'm':
+      cfg.avgMatchDuration_mins = stod(val);
+      break;
+    case 'd':
+      cfg.stdDevMatchDuration_mins = stod(val);
+      break;
+    case 'w':
+      cfg.callDelay_secs = stoi(val);
+      break;
+    case 't':
+      startTime = QDateTime::fromString(stdString2QString(val), "yyyy-MM-dd hh:mm");
+      break;
+    case 's':
+      cfg.seed = static_cast<unsigned int>(stoul(val));
+      break;
+    default:
+      printUsage(argv[0]);
+      return 1;
+    }
+  }
+
+  if (dbFileName.empty() || !startTime.isValid() || (srcFileName.empty() && playerDefFileName.empty()))
+  {
+    printUsage(argv[0]);
+    return 1;
+  }
+  if (srcFileName == dbFileName)
+  {
+    cerr << "The simulation needs a copy of the tournament file" << endl;
+    return 1;
+  }
+
+  // genRandomScore() uses qrand()
+  qsrand(cfg.seed);
+
+  // open an existing tournament or create a new one
+  const QString dstFile = stdString2QString(dbFileName);
+  QFile::remove(dstFile);
+  unique_ptr<TournamentDB> db;
+  try
+  {
+    if (!srcFileName.empty())
+    {
+      if (!QFile::copy(stdString2QString(srcFileName), dstFile))
+      {
+        cerr << "Could not copy " << srcFileName << " to " << dbFileName << endl;
+        return 1;
+      }
+      db = make_unique<TournamentDB>(dbFileName);
+    } else {
+      TournamentSettings tCfg{"Simulation", "Simulation", RefereeMode::None, true};
+      db = make_unique<TournamentDB>(dbFileName, tCfg);
+    }
+  }
+  catch (std::exception& ex)
+  {
+    cerr << "Could not open the tournament: " << ex.what() << endl;
+    return 1;
+  }
+
+  // load the definitions, if any
+  QString errMsg;
+  string defText;
+  if (!catDefFileName.empty())
+  {
+    if (!readFile(catDefFileName, defText))
+    {
+      cerr << "Could not read " << catDefFileName << endl;
+      return 1;
+    }
+    if (Sim::loadCategories(*db, defText, &errMsg) != Error::OK)
+    {
+      cerr << QString2StdString(errMsg) << endl;
+      return 1;
+    }
+  }
+  if (!playerDefFileName.empty())
+  {
+    if (!readFile(playerDefFileName, defText))
+    {
+      cerr << "Could not read " << playerDefFileName << endl;
+      return 1;
+    }
+    if (Sim::loadPlayers(*db, defText, &errMsg) != Error::OK)
+    {
+      cerr << QString2StdString(errMsg) << endl;
+      return 1;
+    }
+  }
+
+  // make sure we have courts
+  CourtMngr cm{*db};
+  if (cm.getAllCourts().empty())
+  {
+    for (int i = 1; i <= nCourts; ++i)
+    {
+      cm.createNewCourt(i, "Sim");
+    }
+  }
+
+  for (const QString& catName : Sim::startAllCategories(*db))
+  {
+    cerr << "Warning: could not start category " << QString2StdString(catName) << endl;
+  }
+
+  Bench::QueryCounter qc{*db};
+  Bench::PhaseStats stats{qc};
+  Sim::SimResult result;
+  try
+  {
+    Sim::TournamentSimulator sim{*db, cfg, stats};
+    result = sim.run(startTime.toTime_t());
+  }
+  catch (std::exception& ex)
+  {
+    cerr << "Simulation aborted: " << ex.what() << endl;
+    return 1;
+  }
+
+  result.print(cout);
+  cout << endl;
+  stats.printTable(cout);
+
+  return result.stuckCategories.empty() ? 0 : 2;
+}
@@ -0,0 +1,299 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2019  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include <Sloppy/String.h>
+
+#include "SimSetup.h"
+#include "HelperFunc.h"
+#include "CSVImporter.h"
+#include "CatMngr.h"
+#include "PlayerMngr.h"
+#include "TeamMngr.h"
+#include "KO_Config.h"
+
+using namespace std;
+
+namespace QTournament::Sim
+{
+  namespace
+  {
+    constexpr char DefaultTeamName[] = "Unassigned";
+
+    //----------------------------------------------------------------------------
+
+    optional<MatchSystem> strToMatchSystem(const string& s)
+    {
+      if (s == "SwissLadder") return MatchSystem::SwissLadder;
+      if (s == "GroupsWithKO") return MatchSystem::GroupsWithKO;
+      if (s == "RoundRobin") return MatchSystem::RoundRobin;
+      if (s == "Bracket") return MatchSystem::Bracket;
+
+      return {};
+    }
+
+    //----------------------------------------------------------------------------
+
+    optional<MatchType> strToMatchType(const string& s)
+    {
+      if (s.empty() || (s == "Singles")) return MatchType::Singles;
+      if (s == "Doubles") return MatchType::Doubles;
+      if (s == "Mixed") return MatchType::Mixed;
+
+      return {};
+    }
+
+    //----------------------------------------------------------------------------
+
+    // pairs all unpaired players in order of their registration;
+    // in mixed categories, the n-th man is paired with the n-th woman
+    void pairRemainingPlayers(const TournamentDB& db, const Category& cat)
+    {
+      if (cat.getMatchType() == MatchType::Singles) return;
+
+      PlayerList unpairedMen;
+      PlayerList unpairedWomen;
+      for (const PlayerPair& pp : cat.getPlayerPairs())
+      {
+        if (pp.hasPlayer2()) continue;
+
+        Player p = pp.getPlayer1();
+        if (p.getSex() == Sex::M) unpairedMen.push_back(p);
+        else unpairedWomen.push_back(p);
+      }
+
+      CatMngr cm{db};
+      if (cat.getMatchType() == MatchType::Mixed)
+      {
+        const size_t n = min(unpairedMen.size(), unpairedWomen.size());
+        for (size_t idx = 0; idx < n; ++idx)
+        {
+          cm.pairPlayers(cat, unpairedMen[idx], unpairedWomen[idx]);
+        }
+        return;
+      }
+
+      for (const PlayerList& pl : {unpairedMen, unpairedWomen})
+      {
+        for (size_t idx = 0; (idx + 1) < pl.size(); idx += 2)
+        {
+          cm.pairPlayers(cat, pl[idx], pl[idx + 1]);
+        }
+      }
+    }
+
+    //----------------------------------------------------------------------------
+
+    // derives a group configuration with groups of (roughly) four
+    // player pairs from the number of player pairs in the category
+    KO_Config deriveGroupConfig(int nPairs)
+    {
+      const int nGroups = clamp(nPairs / 4, 2, 16);
+      const int baseSize = nPairs / nGroups;
+      const int nLargerGroups = nPairs % nGroups;
+
+      GroupDefList gdl;
+      if (nLargerGroups > 0) gdl.append(GroupDef{baseSize + 1, nLargerGroups});
+      gdl.append(GroupDef{baseSize, nGroups - nLargerGroups});
+
+      KO_Start startLvl = KO_Start::L16;
+      if (nGroups <= 2) startLvl = KO_Start::Final;
+      else if (nGroups <= 4) startLvl = KO_Start::Semi;
+      else if (nGroups <= 8) startLvl = KO_Start::Quarter;
+
+      return KO_Config{startLvl, false, gdl};
+    }
+
+    //----------------------------------------------------------------------------
+
+    Error startCategory(const TournamentDB& db, Category& cat)
+    {
+      CatMngr cm{db};
+
+      pairRemainingPlayers(db, cat);
+
+      if (cat.getMatchSystem() == MatchSystem::GroupsWithKO)
+      {
+        const int nPairs = cat.getPlayerPairs().size();
+        KO_Config koCfg{cat.getParameter_string(CatParameter::GroupConfig)};
+        if (!koCfg.isValid(nPairs))
+        {
+          cat.setParameter(CatParameter::GroupConfig, deriveGroupConfig(nPairs).toString());
+        }
+      }
+
+      Error e = cm.freezeConfig(cat);
+      if (e != Error::OK) return e;
+
+      auto specialCat = cat.convertToSpecializedObject();
+      PlayerPairList allPairs = cat.getPlayerPairs();
+
+      std::vector<PlayerPairList> grpCfg;
+      if (specialCat->needsGroupInitialization())
+      {
+        KO_Config koCfg{cat.getParameter_string(CatParameter::GroupConfig)};
+        auto it = begin(allPairs);
+        for (const GroupDef& gd : koCfg.getGroupDefList())
+        {
+          for (int i = 0; i < gd.getNumGroups(); ++i)
+          {
+            grpCfg.push_back(PlayerPairList(it, it + gd.getGroupSize()));
+            it += gd.getGroupSize();
+          }
+        }
+      }
+
+      PlayerPairList seed;
+      if (specialCat->needsInitialRanking())
+      {
+        seed = allPairs;
+      }
+
+      e = cm.startCategory(cat, grpCfg, seed);
+      if (e != Error::OK)
+      {
+        // leave the category in a consistent state
+        cm.unfreezeConfig(cat);
+      }
+
+      return e;
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  Error loadCategories(const TournamentDB& db, const string& defText, QString* errMsg)
+  {
+    CatMngr cm{db};
+
+    Sloppy::estring allText{defText};
+    int lineNum = 0;
+    for (const Sloppy::estring& line : allText.split("\n", false, true))
+    {
+      ++lineNum;
+      if (line.empty() || (line[0] == '#')) continue;
+
+      auto fields = line.split(",", true, true);
+      while (fields.size() < 4) fields.push_back("");
+
+      const QString catName = stdString2QString(fields[0]);
+      auto msys = strToMatchSystem(fields[1]);
+      auto mType = strToMatchType(fields[2]);
+      Sex sex = fields[3].empty() ? Sex::M : strToSex(fields[3]);
+      if (catName.isEmpty() || !msys || !mType || (sex == Sex::DontCare))
+      {
+        if (errMsg != nullptr) *errMsg = QString{"Invalid category definition in line %1"}.arg(lineNum);
+        return Error::InvalidName;
+      }
+
+      Error e = cm.createNewCategory(catName);
+      if (e != Error::OK)
+      {
+        if (errMsg != nullptr) *errMsg = QString{"Could not create category %1"}.arg(catName);
+        return e;
+      }
+
+      Category cat = cm.getCategory(catName);
+      cat.setMatchType(*mType);
+      if (*mType != MatchType::Mixed) cat.setSex(sex);
+      e = cm.setMatchSystem(cat, *msys);
+      if (e != Error::OK)
+      {
+        if (errMsg != nullptr) *errMsg = QString{"Could not set the match system for category %1"}.arg(catName);
+        return e;
+      }
+    }
+
+    return Error::OK;
+  }
+
+  //----------------------------------------------------------------------------
+
+  Error loadPlayers(const TournamentDB& db, const string& defText, QString* errMsg)
+  {
+    auto records = convertCSVfromPlainText(db, splitCSV(defText));
+    for (CSVImportRecord& rec : records)
+    {
+      if (!rec.hasTeamName()) rec.updateTeamName(DefaultTeamName);
+    }
+
+    for (const CSVError& err : analyseCSV(db, records))
+    {
+      if (err.isFatal)
+      {
+        if (errMsg != nullptr) *errMsg = QString{"Invalid player definition in line %1, column %2"}.arg(err.row + 1).arg(err.column + 1);
+        return Error::InvalidName;
+      }
+    }
+
+    // the same import procedure as in the GUI
+    TeamMngr tm{db};
+    PlayerMngr pm{db};
+    CatMngr cm{db};
+    for (const CSVImportRecord& rec : records)
+    {
+      if (!(tm.hasTeam(rec.getTeamName())))
+      {
+        Error e = tm.createNewTeam(rec.getTeamName());
+        if (e != Error::OK) return e;
+      }
+
+      if (!(rec.hasExistingName()))
+      {
+        Error e = pm.createNewPlayer(rec.getFirstName(), rec.getLastName(), rec.getSex(), rec.getTeamName());
+        if (e != Error::OK)
+        {
+          if (errMsg != nullptr) *errMsg = QString{"Could not create player %1 %2"}.arg(rec.getFirstName()).arg(rec.getLastName());
+          return e;
+        }
+      }
+
+      Player p = *(rec.getExistingPlayer());
+      for (const QString& cName : rec.getCatNames())
+      {
+        if (!(cm.hasCategory(cName))) continue;
+
+        cm.addPlayerToCategory(p, cm.getCategory(cName));
+      }
+    }
+
+    return Error::OK;
+  }
+
+  //----------------------------------------------------------------------------
+
+  std::vector<QString> startAllCategories(const TournamentDB& db)
+  {
+    CatMngr cm{db};
+
+    std::vector<QString> result;
+    for (Category& cat : cm.getAllCategories())
+    {
+      if (cat.is_NOT_InState(ObjState::CAT_Config)) continue;
+
+      if (startCategory(db, cat) != Error::OK)
+      {
+        result.push_back(cat.getName());
+      }
+    }
+
+    return result;
+  }
+
+}
@@ -0,0 +1,67 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2019  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SIMSETUP_H
+#define SIMSETUP_H
+
+#include <string>
+#include <vector>
+
+#include <QString>
+
+#include "TournamentDB.h"
+#include "TournamentErrorCodes.h"
+
+namespace QTournament::Sim
+{
+  /** \brief Creates categories from a plain text definition
+   *
+   * Each line contains a comma separated list of
+   * `name, match system[, match type[, sex]]` with the match system being
+   * one of `SwissLadder`, `GroupsWithKO`, `RoundRobin` or `Bracket` and
+   * the match type being one of `Singles` (default), `Doubles` or `Mixed`.
+   * Empty lines and lines starting with `#` are ignored.
+   *
+   * \returns Error::OK if all categories have been created
+   */
+  Error loadCategories(const TournamentDB& db, const std::string& defText, QString* errMsg);
+
+  /** \brief Creates players from a plain text definition and adds
+   * them to existing categories
+   *
+   * The format is identical to the CSV player import of the GUI
+   * (`last name, first name, sex, team, category, category, ...`).
+   * Players without a team are assigned to a default team.
+   *
+   * \returns Error::OK if all players have been created
+   */
+  Error loadPlayers(const TournamentDB& db, const std::string& defText, QString* errMsg);
+
+  /** \brief Starts all categories that are still in the configuration phase
+   *
+   * Unpaired players in doubles and mixed categories are paired in order of
+   * their registration, groups for "groups with KO" are derived from the number
+   * of player pairs if the category has no valid group configuration and the
+   * initial seeding follows the order of registration.
+   *
+   * \returns the names of all categories that could not be started
+   */
+  std::vector<QString> startAllCategories(const TournamentDB& db);
+}
+
+#endif // SIMSETUP_H
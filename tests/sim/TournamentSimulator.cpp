@@ -0,0 +1,343 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2019  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <stdexcept>
+
+#include <QDateTime>
+
+#include "TournamentSimulator.h"
+#include "HelperFunc.h"
+#include "TournamentDataDefs.h"
+#include "MatchMngr.h"
+#include "CatMngr.h"
+#include "CourtMngr.h"
+#include "BackendAPI.h"
+
+using namespace std;
+
+namespace QTournament::Sim
+{
+  namespace
+  {
+    // the names of all phases that are reported by the simulator
+    constexpr char PhaseStaging[] = "Staging";
+    constexpr char PhaseScheduling[] = "Scheduling";
+    constexpr char PhasePrediction[] = "Time prediction";
+    constexpr char PhaseMatchCall[] = "Match call";
+    constexpr char PhaseMatchResult[] = "Match result";
+    constexpr char PhaseRoundCompletion[] = "Round completion";
+    constexpr char PhaseSeeding[] = "Intermediate seeding";
+
+    //----------------------------------------------------------------------------
+
+    // converts mean and standard deviation of a log-normal
+    // distribution into the parameters of the underlying normal distribution
+    std::lognormal_distribution<double> makeDurationDist(double mean, double stdDev)
+    {
+      const double sigmaSq = log(1.0 + (stdDev * stdDev) / (mean * mean));
+      return std::lognormal_distribution<double>{log(mean) - sigmaSq / 2.0, sqrt(sigmaSq)};
+    }
+
+    //----------------------------------------------------------------------------
+
+    QString timeToString(time_t t)
+    {
+      return QDateTime::fromTime_t(t).toString("yyyy-MM-dd hh:mm");
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  double SimResult::matchesPerCourtHour() const
+  {
+    const double courtHours = nCourts * (endTime - startTime) / 3600.0;
+    return (courtHours > 0) ? (nFinishedMatches / courtHours) : 0.0;
+  }
+
+  //----------------------------------------------------------------------------
+
+  double SimResult::courtUtilization() const
+  {
+    const double courtSecs = nCourts * static_cast<double>(endTime - startTime);
+    return (courtSecs > 0) ? (totalPlayTime_secs / courtSecs) : 0.0;
+  }
+
+  //----------------------------------------------------------------------------
+
+  void SimResult::print(ostream& out) const
+  {
+    const long makeSpan_mins = (endTime - startTime) / 60;
+
+    out << "Start:                     " << QString2StdString(timeToString(startTime)) << endl;
+    out << "End:                       " << QString2StdString(timeToString(endTime))
+        << " (" << makeSpan_mins / 60 << "h " << setw(2) << setfill('0') << makeSpan_mins % 60 << setfill(' ') << "m)" << endl;
+    out << "Finished matches:          " << nFinishedMatches << endl;
+    out << "Courts:                    " << nCourts << endl;
+    out << "Matches per court and hour: " << fixed << setprecision(2) << matchesPerCourtHour() << endl;
+    out << "Court utilization:         " << fixed << setprecision(1) << (courtUtilization() * 100.0) << " %" << endl;
+    out << "Idle court time:           " << fixed << setprecision(1) << (totalIdleCourtTime_secs / 3600.0) << " h" << endl;
+    out << endl;
+    out << "Predicted matches:         " << nPredictedMatches << endl;
+    out << "Start time error (first):  " << fixed << setprecision(1) << avgAbsStartError_first_mins << " min (avg. abs.), "
+        << avgStartError_first_mins << " min (avg.)" << endl;
+    out << "Start time error (last):   " << fixed << setprecision(1) << avgAbsStartError_last_mins << " min (avg. abs.)" << endl;
+    if (firstPredictedEnd > 0)
+    {
+      out << "Initially predicted end:   " << QString2StdString(timeToString(firstPredictedEnd)) << endl;
+    }
+
+    if (!stuckCategories.empty())
+    {
+      out << endl << "Unfinished categories:    ";
+      for (const QString& catName : stuckCategories)
+      {
+        out << " " << QString2StdString(catName);
+      }
+      out << endl;
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  TournamentSimulator::TournamentSimulator(const TournamentDB& _db, const SimConfig& _cfg, Bench::PhaseStats& _stats)
+    :db{_db}, cfg{_cfg}, stats{_stats}, rng{_cfg.seed},
+      durationDist{makeDurationDist(_cfg.avgMatchDuration_mins, _cfg.stdDevMatchDuration_mins)},
+      predictor{_db}
+  {
+  }
+
+  //----------------------------------------------------------------------------
+
+  SimResult TournamentSimulator::run(time_t startTime)
+  {
+    simTime = startTime;
+    runningMatches.clear();
+    firstPredictedStart.clear();
+    lastPredictedStart.clear();
+    result = SimResult{};
+    result.startTime = startTime;
+    result.endTime = startTime;
+
+    CourtMngr cm{db};
+    for (const Court& co : cm.getAllCourts())
+    {
+      if (co.is_NOT_InState(ObjState::CO_Disabled)) ++result.nCourts;
+    }
+
+    MatchMngr mm{db};
+    while (true)
+    {
+      // stage and schedule everything that's possible
+      int nStaged = 0;
+      bool hasStaged = true;
+      while (hasStaged)
+      {
+        hasStaged = false;
+        for (const MatchGroup& mg : mm.getAllMatchGroups())
+        {
+          if (mg.is_NOT_InState(ObjState::MG_Idle)) continue;
+
+          Error e = stats.measure(PhaseStaging, [&]()
+          {
+            Error err = mm.canStageMatchGroup(mg);
+            return (err == Error::OK) ? mm.stageMatchGroup(mg) : err;
+          });
+          if (e == Error::OK)
+          {
+            hasStaged = true;
+            ++nStaged;
+          }
+        }
+      }
+      if (nStaged > 0)
+      {
+        stats.measure(PhaseScheduling, [&]()
+        {
+          mm.scheduleAllStagedMatchGroups();
+        });
+      }
+
+      updatePrediction();
+      callMatches();
+
+      if (runningMatches.empty()) break;
+
+      finishNextMatch();
+    }
+
+    // the errors have been summed up in callMatches()
+    if (result.nPredictedMatches > 0)
+    {
+      result.avgAbsStartError_first_mins /= result.nPredictedMatches;
+      result.avgAbsStartError_last_mins /= result.nPredictedMatches;
+      result.avgStartError_first_mins /= result.nPredictedMatches;
+    }
+
+    CatMngr catm{db};
+    for (const Category& cat : catm.getAllCategories())
+    {
+      if (cat.is_NOT_InState(ObjState::CAT_Finalized)) result.stuckCategories.push_back(cat.getName());
+    }
+
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+  int TournamentSimulator::drawMatchDuration()
+  {
+    const double mins = max(durationDist(rng), static_cast<double>(cfg.minMatchDuration_mins));
+    return static_cast<int>(mins * 60.0);
+  }
+
+  //----------------------------------------------------------------------------
+
+  void TournamentSimulator::callMatches()
+  {
+    // matches are called with a short delay after the court became free
+    MatchMngr mm{db};
+    mm.setTimeSource([this]() { return simTime + cfg.callDelay_secs; });
+
+    while (static_cast<int>(runningMatches.size()) < result.nCourts)
+    {
+      auto ma = API::Qry::nextCallableMatch(db);
+      if (!ma) break;
+
+      Error err{Error::OK};
+      auto court = stats.measure(PhaseMatchCall, [&]()
+      {
+        return mm.autoAssignMatchToNextAvailCourt(*ma, &err);
+      });
+      if (!court) break;
+
+      const int maId = ma->getId();
+      const time_t start = simTime + cfg.callDelay_secs;
+
+      const int duration = drawMatchDuration();
+      runningMatches.push_back(RunningMatch{maId, start + duration});
+      result.totalPlayTime_secs += duration;
+
+      // compare the actual start time with the predictions
+      auto itFirst = firstPredictedStart.find(maId);
+      auto itLast = lastPredictedStart.find(maId);
+      if ((itFirst != firstPredictedStart.end()) && (itLast != lastPredictedStart.end()))
+      {
+        const double errFirst = (start - itFirst->second) / 60.0;
+        const double errLast = (start - itLast->second) / 60.0;
+        result.avgAbsStartError_first_mins += fabs(errFirst);
+        result.avgAbsStartError_last_mins += fabs(errLast);
+        result.avgStartError_first_mins += errFirst;
+        ++result.nPredictedMatches;
+      }
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  void TournamentSimulator::finishNextMatch()
+  {
+    auto it = min_element(begin(runningMatches), end(runningMatches), [](const RunningMatch& m1, const RunningMatch& m2)
+    {
+      return (m1.finishTime < m2.finishTime);
+    });
+    const RunningMatch rm = *it;
+    runningMatches.erase(it);
+
+    // advance the simulated time and account for
+    // courts that had no match assigned in the meantime
+    if (rm.finishTime > simTime)
+    {
+      const int nIdleCourts = result.nCourts - static_cast<int>(runningMatches.size()) - 1;
+      result.totalIdleCourtTime_secs += nIdleCourts * (rm.finishTime - simTime);
+      simTime = rm.finishTime;
+    }
+
+    MatchMngr mm{db};
+    mm.setTimeSource([this]() { return simTime; });
+    auto ma = mm.getMatch(rm.matchId);
+    auto score = MatchScore::genRandomScore();
+    auto finResult = stats.measureClassified([&]()
+    {
+      return mm.setMatchScoreAndFinalizeMatch(*ma, *score);
+    },
+    [](const MatchFinalizationResult& r)
+    {
+      return (r.completedRound ? PhaseRoundCompletion : PhaseMatchResult);
+    });
+    if (finResult.err != Error::OK)
+    {
+      throw std::runtime_error{"TournamentSimulator: could not finalize match " + to_string(rm.matchId)};
+    }
+
+    ++result.nFinishedMatches;
+    result.endTime = max(result.endTime, rm.finishTime);
+
+    if (finResult.completedRound)
+    {
+      resolveIntermediateSeedings();
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  void TournamentSimulator::resolveIntermediateSeedings()
+  {
+    CatMngr catm{db};
+    for (const Category& cat : catm.getAllCategories())
+    {
+      if (cat.is_NOT_InState(ObjState::CAT_WaitForIntermediateSeeding)) continue;
+
+      // use the default seeding as suggested by the category
+      auto specialCat = cat.convertToSpecializedObject();
+      const PlayerPairList seed = specialCat->getPlayerPairsForIntermediateSeeding();
+      Error e = stats.measure(PhaseSeeding, [&]()
+      {
+        return catm.continueWithIntermediateSeeding(cat, seed);
+      });
+      if (e != Error::OK)
+      {
+        throw std::runtime_error{"TournamentSimulator: intermediate seeding failed for category " + QString2StdString(cat.getName())};
+      }
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  void TournamentSimulator::updatePrediction()
+  {
+    auto prediction = stats.measure(PhasePrediction, [&]()
+    {
+      return predictor.getMatchTimePrediction(simTime);
+    });
+
+    for (const MatchTimePrediction& mtp : prediction)
+    {
+      firstPredictedStart.emplace(mtp.matchId, mtp.estStartTime__UTC);
+      lastPredictedStart[mtp.matchId] = mtp.estStartTime__UTC;
+    }
+
+    if ((result.firstPredictedEnd == 0) && !prediction.empty())
+    {
+      result.firstPredictedEnd = prediction.back().estFinishTime__UTC;
+    }
+  }
+
+}
@@ -0,0 +1,124 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2019  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TOURNAMENTSIMULATOR_H
+#define TOURNAMENTSIMULATOR_H
+
+#include <ctime>
+#include <random>
+#include <unordered_map>
+#include <vector>
+#include <ostream>
+
+#include <QString>
+
+#include "TournamentDB.h"
+#include "MatchTimePredictor.h"
+#include "PhaseStats.h"
+
+namespace QTournament::Sim
+{
+  /** \brief Parameters for the simulated match play
+   */
+  struct SimConfig
+  {
+    double avgMatchDuration_mins{20.0};   ///< mean of the (log-normal) match duration distribution
+    double stdDevMatchDuration_mins{5.0};   ///< standard deviation of the match duration distribution
+    int minMatchDuration_mins{8};   ///< lower bound for match durations
+    int callDelay_secs{60};   ///< time between a court becoming free and the next match being called
+    unsigned int seed{42};   ///< seed for all random numbers
+  };
+
+  /** \brief Results of a simulated tournament
+   */
+  struct SimResult
+  {
+    int nFinishedMatches{0};
+    int nCourts{0};
+    time_t startTime{0};
+    time_t endTime{0};   ///< finish time of the last match
+    long totalPlayTime_secs{0};   ///< sum of all match durations
+    long totalIdleCourtTime_secs{0};   ///< court time without a match while matches were still pending
+
+    // predictor accuracy; all errors are "actual minus predicted" start times
+    int nPredictedMatches{0};
+    double avgAbsStartError_first_mins{0.0};   ///< first prediction after the match got its match number
+    double avgAbsStartError_last_mins{0.0};   ///< last prediction before the match was called
+    double avgStartError_first_mins{0.0};   ///< signed; a positive value means that matches start later than predicted
+    time_t firstPredictedEnd{0};   ///< predicted end of the tournament before the first match was called
+    std::vector<QString> stuckCategories;   ///< categories that could not be completed
+
+    /** \returns the average number of matches per court and hour
+     */
+    double matchesPerCourtHour() const;
+
+    /** \returns the share of the court time that was used for matches
+     */
+    double courtUtilization() const;
+
+    void print(std::ostream& out) const;
+  };
+
+  /** \brief Plays all categories of a tournament in accelerated, simulated time
+   *
+   * Matches are assigned to courts via MatchMngr::autoAssignMatchToNextAvailCourt(),
+   * match durations are drawn from a log-normal distribution and results are
+   * random. MatchMngr uses the simulated time for start and finish times
+   * so that MatchTimePredictor and all reports see a realistic timeline.
+   */
+  class TournamentSimulator
+  {
+  public:
+    TournamentSimulator(const TournamentDB& _db, const SimConfig& _cfg, Bench::PhaseStats& _stats);
+
+    /** \brief Runs the simulation until no more matches can be played
+     *
+     * \param startTime the simulated time at which the first match is called
+     */
+    SimResult run(time_t startTime);
+
+  protected:
+    int drawMatchDuration();
+    void callMatches();
+    void finishNextMatch();
+    void resolveIntermediateSeedings();
+    void updatePrediction();
+
+  private:
+    struct RunningMatch
+    {
+      int matchId;
+      time_t finishTime;
+    };
+
+    std::reference_wrapper<const TournamentDB> db;
+    SimConfig cfg;
+    Bench::PhaseStats& stats;
+    std::mt19937 rng;
+    std::lognormal_distribution<double> durationDist;
+    MatchTimePredictor predictor;
+
+    time_t simTime{0};
+    std::vector<RunningMatch> runningMatches;
+    std::unordered_map<int, time_t> firstPredictedStart;
+    std::unordered_map<int, time_t> lastPredictedStart;
+    SimResult result;
+  };
+}
+
+#endif // TOURNAMENTSIMULATOR_H
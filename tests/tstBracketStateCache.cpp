@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../TournamentDB.h"
+#include "../TournamentDataDefs.h"
+#include "../MatchMngr.h"
+#include "../CatMngr.h"
+#include "../BackendAPI.h"
+#include "../BracketStateCache.h"
+#include "../Score.h"
+
+#include "ScenarioTestHelpers.h"
+
+using namespace QTournament;
+
+namespace
+{
+  std::vector<std::pair<int, int>> toPairs(const std::vector<SimplifiedRankingEntry>& srel)
+  {
+    std::vector<std::pair<int, int>> result;
+    for (const SimplifiedRankingEntry& sre : srel) result.push_back({sre.ppId.get(), sre.rank.get()});
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+  // the memoized states have to be identical to
+  // the states that are calculated from scratch
+  void assertSameAsFreshCache(const TournamentDB& db, const Category& cat, int lastRound)
+  {
+    BracketStateCache fresh{db};
+    const auto& expected = fresh.getRoundStates(cat, Round{1}, Round{lastRound});
+    const auto& cached = db.getBracketStateCache().getRoundStates(cat, Round{1}, Round{lastRound});
+
+    ASSERT_EQ(expected.size(), cached.size());
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+      ASSERT_EQ(expected[i].round.get(), cached[i].round.get());
+      ASSERT_EQ(toPairs(expected[i].matchRanks), toPairs(cached[i].matchRanks)) << "round " << expected[i].round.get();
+      ASSERT_EQ(toPairs(expected[i].bracketRanks), toPairs(cached[i].bracketRanks)) << "round " << expected[i].round.get();
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  int getNumRounds(const TournamentDB& db, const Category& cat)
+  {
+    MatchMngr mm{db};
+    int result{0};
+    for (const MatchGroup& mg : mm.getMatchGroupsForCat(cat)) result = std::max(result, mg.getRound());
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+  int getRankOfPair(const std::vector<SimplifiedRankingEntry>& srel, int ppId)
+  {
+    for (const SimplifiedRankingEntry& sre : srel)
+    {
+      if (sre.ppId.get() == ppId) return sre.rank.get();
+    }
+    return -1;
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST(BracketStateCache, InvalidatedByWinnerChange)
+{
+  auto dbPtr = Test::createStartedTournament();
+  ASSERT_TRUE(dbPtr != nullptr);
+  const TournamentDB& db = *dbPtr;
+  ASSERT_EQ(Error::OK, Test::stageAllMatchGroups(db));
+  MatchMngr mm{db};
+  mm.scheduleAllStagedMatchGroups();
+
+  CatMngr cm{db};
+  const Category br = cm.getCategory("BR-1");
+  const int nRounds = getNumRounds(db, br);
+  ASSERT_GT(nRounds, 1);
+
+  // play the complete bracket and fill the cache round by round
+  for (int round = 1; round <= nRounds; ++round)
+  {
+    ASSERT_EQ(Error::OK, Test::playRound(db, br, round));
+    ASSERT_EQ(static_cast<size_t>(round), API::Qry::getBracketRanks(br, Round{1}, Round{round}).size());
+    assertSameAsFreshCache(db, br, round);
+  }
+
+  // find the final; its winner/loser can be swapped at any time
+  std::optional<Match> finalMatch;
+  for (const MatchGroup& mg : mm.getMatchGroupsForCat(br, nRounds))
+  {
+    for (const Match& ma : mm.getMatchesForMatchGroup(mg))
+    {
+      if (ma.getWinnerRank() == 1) finalMatch = ma;
+    }
+  }
+  ASSERT_TRUE(finalMatch.has_value());
+  const int oldWinnerId = finalMatch->getWinner()->getPairId();
+  const int oldLoserId = finalMatch->getLoser()->getPairId();
+
+  auto ranks = API::Qry::getBracketRanks(br, Round{nRounds});
+  ASSERT_EQ(1, getRankOfPair(ranks.at(0).ranks, oldWinnerId));
+
+  const auto oldScore = *finalMatch->getScore();
+  auto newScore = MatchScore::fromString((oldScore.getWinner() == 1) ? "18:21,21:19,15:21" : "21:18,19:21,21:15");
+  ASSERT_TRUE(newScore.has_value());
+  ASSERT_EQ(ModMatchResult::ModDone, br.convertToSpecializedObject()->modifyMatchResult(*finalMatch, *newScore));
+
+  // the cached ranks reflect the new winner
+  ranks = API::Qry::getBracketRanks(br, Round{nRounds});
+  ASSERT_EQ(1, getRankOfPair(ranks.at(0).ranks, oldLoserId));
+  ASSERT_NE(1, getRankOfPair(ranks.at(0).ranks, oldWinnerId));
+  assertSameAsFreshCache(db, br, nRounds);
+
+  // a score-only change keeps the cache valid
+  newScore = MatchScore::fromString((oldScore.getWinner() == 1) ? "3:21,4:21" : "21:3,21:4");
+  ASSERT_TRUE(newScore.has_value());
+  ASSERT_EQ(ModMatchResult::ModDone, br.convertToSpecializedObject()->modifyMatchResult(*finalMatch, *newScore));
+  assertSameAsFreshCache(db, br, nRounds);
+}
+
+//----------------------------------------------------------------------------
+
+TEST(BracketStateCache, ClearedAfterCategoryDeletion)
+{
+  auto dbPtr = Test::createStartedTournament();
+  ASSERT_TRUE(dbPtr != nullptr);
+  const TournamentDB& db = *dbPtr;
+  ASSERT_EQ(Error::OK, Test::stageAllMatchGroups(db));
+  MatchMngr mm{db};
+  mm.scheduleAllStagedMatchGroups();
+
+  CatMngr cm{db};
+  const Category br = cm.getCategory("BR-1");
+  const int oldCatId = br.getId();
+  const int nRounds = getNumRounds(db, br);
+  ASSERT_GT(nRounds, 1);
+
+  // fill the cache with all rounds of the bracket
+  for (int round = 1; round <= nRounds; ++round)
+  {
+    ASSERT_EQ(Error::OK, Test::playRound(db, br, round));
+  }
+  ASSERT_EQ(static_cast<size_t>(nRounds), db.getBracketStateCache().getRoundStates(br, Round{1}, Round{nRounds}).size());
+
+  // delete the category along with its match groups and
+  // re-create it with the same players
+  PlayerList players = br.getAllPlayersInCategory();
+  ASSERT_EQ(Error::OK, cm.deleteRunningCategory(br));
+
+  ASSERT_EQ(Error::OK, cm.createNewCategory("BR-2"));
+  Category newBr = cm.getCategory("BR-2");
+  newBr.setMatchType(MatchType::Singles);
+  newBr.setSex(Sex::M);
+  ASSERT_EQ(Error::OK, cm.setMatchSystem(newBr, MatchSystem::Bracket));
+  for (const Player& p : players) ASSERT_EQ(Error::OK, cm.addPlayerToCategory(p, newBr));
+  ASSERT_EQ(Error::OK, cm.freezeConfig(newBr));
+  ASSERT_EQ(Error::OK, cm.startCategory(newBr, {}, newBr.getPlayerPairs()));
+
+  // SQLite re-uses the highest row ID, so the new category
+  // would hit the memoized bracket of the deleted one
+  ASSERT_EQ(oldCatId, newBr.getId());
+
+  ASSERT_EQ(Error::OK, Test::stageAllMatchGroups(db));
+  mm.scheduleAllStagedMatchGroups();
+  ASSERT_EQ(Error::OK, Test::playRound(db, newBr, 1));
+
+  // only the finished round may show up in the cache
+  for (const auto& rs : db.getBracketStateCache().getRoundStates(newBr, Round{1}, Round{1}))
+  {
+    ASSERT_EQ(1, rs.round.get());
+  }
+  assertSameAsFreshCache(db, newBr, 1);
+}
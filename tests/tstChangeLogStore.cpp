@@ -0,0 +1,98 @@
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include "../ChangeLogStore.h"
+#include "../TournamentDataDefs.h"
+
+using namespace QTournament;
+using Action = SqliteOverlay::RowChangeAction;
+
+namespace
+{
+  using RowMap = std::map<std::pair<std::string, int>, Action>;
+
+  RowMap toRowMap(const SqliteOverlay::ChangeLogList& log)
+  {
+    RowMap result;
+    for (const auto& cle : log)
+    {
+      auto [it, isNew] = result.emplace(std::make_pair(cle.tabName, cle.rowId), cle.action);
+      EXPECT_TRUE(isNew) << cle.tabName << " " << cle.rowId;
+    }
+    return result;
+  }
+
+  // feeds a random but consistent sequence of inserts, updates
+  // and deletions into the store and checks the result against
+  // a compaction in a plain map
+  void checkRandomEdits(size_t maxInMemoryRows)
+  {
+    ChangeLogStore store{maxInMemoryRows};
+    RowMap expected;
+    std::map<std::pair<std::string, int>, bool> rowExists;
+    std::mt19937 rng{42};
+    for (int i = 0; i < 5000; ++i)
+    {
+      const std::string tab = (rng() % 2) ? TabMatch : TabPlayer;
+      const auto key = std::make_pair(tab, static_cast<int>(rng() % 50));
+
+      bool& exists = rowExists[key];
+      Action a = Action::Insert;
+      if (exists) a = ((rng() % 4) == 0) ? Action::Delete : Action::Update;
+      exists = (a != Action::Delete);
+
+      store.add(SqliteOverlay::ChangeLogEntry{a, "main", tab, key.second});
+
+      auto it = expected.find(key);
+      if (it == expected.end())
+      {
+        expected.emplace(key, a);
+      } else {
+        if (!ChangeLogStore::merge(it->second, a, it->second)) expected.erase(it);
+      }
+    }
+
+    ASSERT_EQ(5000, store.getEditCount());
+    ASSERT_LE(expected.size(), store.size());
+    ASSERT_EQ(expected, toRowMap(store.getCompactedLog()));
+
+    store.clear();
+    ASSERT_TRUE(store.empty());
+    ASSERT_TRUE(store.getCompactedLog().empty());
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST(ChangeLogStore, Merge)
+{
+  Action result;
+  ASSERT_TRUE(ChangeLogStore::merge(Action::Insert, Action::Update, result));
+  ASSERT_EQ(Action::Insert, result);
+  ASSERT_FALSE(ChangeLogStore::merge(Action::Insert, Action::Delete, result));
+  ASSERT_TRUE(ChangeLogStore::merge(Action::Update, Action::Update, result));
+  ASSERT_EQ(Action::Update, result);
+  ASSERT_TRUE(ChangeLogStore::merge(Action::Update, Action::Delete, result));
+  ASSERT_EQ(Action::Delete, result);
+  ASSERT_TRUE(ChangeLogStore::merge(Action::Delete, Action::Insert, result));
+  ASSERT_EQ(Action::Update, result);
+}
+
+//----------------------------------------------------------------------------
+
+TEST(ChangeLogStore, InMemory)
+{
+  checkRandomEdits(ChangeLogStore::DefaultMaxInMemoryRows);
+}
+
+//----------------------------------------------------------------------------
+
+TEST(ChangeLogStore, Spilled)
+{
+  // spill after every few rows
+  checkRandomEdits(3);
+}
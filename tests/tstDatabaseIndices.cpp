@@ -0,0 +1,111 @@
+#include <iostream>
+
+#include <Sloppy/libSloppy.h>
+
+#include <gtest/gtest.h>
+
+#include <SqliteOverlay/KeyValueTab.h>
+
+#include "../TournamentDB.h"
+#include "../TournamentDataDefs.h"
+
+using namespace QTournament;
+using namespace Sloppy;
+
+// a helper function that returns the concatenated
+// query plan of a SQL statement
+string getQueryPlan(const TournamentDB& db, const string& sql)
+{
+  string result;
+  auto stmt = db.prepStatement("EXPLAIN QUERY PLAN " + sql);
+  for (stmt.step(); stmt.hasData(); stmt.step())
+  {
+    result += stmt.getString(3) + "\n";
+  }
+
+  return result;
+}
+
+//----------------------------------------------------------------------------
+
+// a helper function that checks that a query
+// uses a given index
+void assertIndexUsed(const TournamentDB& db, const string& sql, const string& idxName)
+{
+  const string plan = getQueryPlan(db, sql);
+  ASSERT_NE(string::npos, plan.find("USING INDEX " + idxName)) << sql << endl << plan;
+}
+
+//----------------------------------------------------------------------------
+
+// a helper function that checks all hot queries
+void assertQueryIndicesUsed(const TournamentDB& db)
+{
+  // PlayerMngr::getRecentFinishers()
+  assertIndexUsed(db, "SELECT id FROM " TabMatch " WHERE " GenericStateFieldName " = 5 ORDER BY " MA_FinishTime " DESC LIMIT 10",
+                  "Idx_Match_State_FinishTime");
+
+  // PlayerMngr::getLastFinishedMatchForPlayer()
+  const string lastMatchSql = "SELECT id FROM " TabMatch " WHERE " MA_ActualPlayer1aRef "=3 OR " MA_ActualPlayer1bRef "=3"
+                              " OR " MA_ActualPlayer2aRef "=3 OR " MA_ActualPlayer2bRef "=3 ORDER BY " MA_FinishTime " DESC LIMIT 1";
+  assertIndexUsed(db, lastMatchSql, "Idx_Match_ActualPlayer1aRef");
+  assertIndexUsed(db, lastMatchSql, "Idx_Match_ActualPlayer1bRef");
+  assertIndexUsed(db, lastMatchSql, "Idx_Match_ActualPlayer2aRef");
+  assertIndexUsed(db, lastMatchSql, "Idx_Match_ActualPlayer2bRef");
+
+  // PlayerProfile, PlayerMngr::getAllScheduledMatchesForPlayer()
+  assertIndexUsed(db, "SELECT id FROM " TabPairs " WHERE " Pairs_Player1Ref " = 3 OR " Pairs_Player2Ref " = 3",
+                  "Idx_Pairs_Player2Ref");
+
+  // MatchMngr::getMatchGroupsForCat()
+  assertIndexUsed(db, "SELECT id FROM " TabMatchGroup " WHERE " MG_CatRef " = 2 AND " MG_Round " = 4",
+                  "Idx_MatchGroup_CatRef_Round");
+
+  // MatchMngr::resolveSymbolicNamesAfterFinishedMatch()
+  assertIndexUsed(db, "SELECT id FROM " TabMatch " WHERE " MA_Pair1SymbolicVal " = -7 AND " MA_Pair1SymbolicVal " <> 0",
+                  "Idx_Match_Pair1SymbolicVal");
+  assertIndexUsed(db, "SELECT id FROM " TabMatch " WHERE " MA_Pair2SymbolicVal " = 7 AND " MA_Pair2SymbolicVal " <> 0",
+                  "Idx_Match_Pair2SymbolicVal");
+}
+
+//----------------------------------------------------------------------------
+
+TEST(DatabaseIndices, NewDatabase)
+{
+  TournamentDB db;
+  assertQueryIndicesUsed(db);
+}
+
+//----------------------------------------------------------------------------
+
+TEST(DatabaseIndices, Upgrade)
+{
+  // fake a database in the previous format
+  TournamentDB db;
+  for (const string& idxName : {"Idx_Pairs_Player2Ref", "Idx_MatchGroup_CatRef_Round", "Idx_Match_State_FinishTime",
+                                "Idx_Match_ActualPlayer1aRef", "Idx_Match_ActualPlayer1bRef", "Idx_Match_ActualPlayer2aRef",
+                                "Idx_Match_ActualPlayer2bRef", "Idx_Match_Pair1SymbolicVal", "Idx_Match_Pair2SymbolicVal"})
+  {
+    auto stmt = db.prepStatement("DROP INDEX " + idxName);
+    stmt.step();
+  }
+  SqliteOverlay::KeyValueTab cfg{db, TabCfg};
+  cfg.set(CfgKey_DbVersion, "3.0");
+
+  const string plan = getQueryPlan(db, "SELECT id FROM " TabMatchGroup " WHERE " MG_CatRef " = 2 AND " MG_Round " = 4");
+  ASSERT_EQ(string::npos, plan.find("Idx_MatchGroup_CatRef_Round"));
+
+  ASSERT_TRUE(db.isCompatibleDatabaseVersion());
+  ASSERT_TRUE(db.needsConversion());
+  ASSERT_TRUE(db.convertToLatestDatabaseVersion());
+  ASSERT_FALSE(db.needsConversion());
+
+  auto version = db.getVersion();
+  ASSERT_EQ(DbVersionMajor, get<0>(version));
+  ASSERT_EQ(DbVersionMinor, get<1>(version));
+
+  assertQueryIndicesUsed(db);
+
+  // a second conversion is a no-op
+  ASSERT_TRUE(db.convertToLatestDatabaseVersion());
+}
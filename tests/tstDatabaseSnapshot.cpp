@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+
+#include <SqliteOverlay/KeyValueTab.h>
+
+#include "BasicTestClass.h"
+#include "../TournamentDB.h"
+#include "../TournamentDataDefs.h"
+#include "../MatchDurationStats.h"
+
+using namespace QTournament;
+
+namespace
+{
+  constexpr char TestKey[] = "SnapshotTestKey";
+
+  // a helper function that checks that a snapshot sees
+  // the old state while the original database continues to write
+  void assertSnapshotIsolation(const TournamentDB& db)
+  {
+    SqliteOverlay::KeyValueTab cfg{db, TabCfg};
+    cfg.set(TestKey, 1);
+
+    auto snap = db.createSnapshot();
+    ASSERT_TRUE(snap != nullptr);
+    ASSERT_TRUE(snap->isSnapshot());
+    ASSERT_FALSE(db.isSnapshot());
+    ASSERT_TRUE(snap->getOnlineManager() == nullptr);
+
+    // writes to the original database are not visible in the snapshot
+    cfg.set(TestKey, 2);
+    SqliteOverlay::KeyValueTab snapCfg{*snap, TabCfg};
+    ASSERT_EQ(1, snapCfg.getInt(TestKey));
+    ASSERT_EQ(2, cfg.getInt(TestKey));
+
+    // the snapshot is read-only
+    ASSERT_ANY_THROW(snapCfg.set(TestKey, 3));
+    ASSERT_EQ(2, cfg.getInt(TestKey));
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST(DatabaseSnapshot, InMemory)
+{
+  TournamentDB db;
+  assertSnapshotIsolation(db);
+}
+
+//----------------------------------------------------------------------------
+
+TEST(DatabaseSnapshot, MatchDurationStatsAreReadOnly)
+{
+  TournamentDB db;
+  db.resetDirtyFlag();
+
+  // loading the statistics doesn't write, neither
+  // to the snapshot nor to the original database
+  auto snap = db.createSnapshot();
+  MatchDurationStats snapStats{*snap};
+  ASSERT_NO_THROW(snapStats.reload());
+  ASSERT_EQ(0, snapStats.getTotalCount());
+
+  MatchDurationStats stats{db};
+  stats.reload();
+  ASSERT_FALSE(db.isDirty());
+
+  SqliteOverlay::KeyValueTab cfg{db, TabCfg};
+  ASSERT_FALSE(cfg.hasKey(MatchDurationStats::CfgKey_StatsInitialized));
+}
+
+//----------------------------------------------------------------------------
+
+TEST_F(BasicTestFixture, DatabaseSnapshot_Wal)
+{
+  TournamentSettings ts{"-----", "-----", RefereeMode::None, true};
+  TournamentDB db{genTestFilePath("snapshot.tdb"), ts};
+  ASSERT_TRUE(db.enableWalMode());
+  assertSnapshotIsolation(db);
+}
+
+//----------------------------------------------------------------------------
+
+TEST_F(BasicTestFixture, DatabaseSnapshot_IncrementalBackup)
+{
+  TournamentDB db;
+  SqliteOverlay::KeyValueTab cfg{db, TabCfg};
+  cfg.set(TestKey, 1);
+
+  // an existing destination is replaced
+  const string dstName = genTestFilePath("backup.tdb");
+  {
+    TournamentSettings ts{"-----", "-----", RefereeMode::None, true};
+    TournamentDB oldDb{dstName, ts};
+  }
+  ASSERT_TRUE(boostfs::exists(dstName));
+
+  // write in tiny batches and modify the source in between;
+  // the modification must be part of the copy
+  int nCalls{0};
+  int lastDone{0};
+  int changeCount{-1};
+  int rc = db.backupToFileIncremental(dstName, [&](int done, int total)
+  {
+    ASSERT_LE(done, total);
+    lastDone = done;
+    if (nCalls++ == 0) cfg.set(TestKey, 2);
+  }, 1, &changeCount);
+  ASSERT_EQ(0, rc);
+
+  // the change count includes the modification during the copy
+  // but not the ones after the copy was complete
+  ASSERT_EQ(db.getTotalChangeCount(), changeCount);
+  cfg.set(TestKey, 3);
+  ASSERT_LT(changeCount, db.getTotalChangeCount());
+  ASSERT_GT(nCalls, 1);
+  ASSERT_GT(lastDone, 0);
+  ASSERT_FALSE(boostfs::exists(dstName + ".tmp"));
+
+  TournamentDB copy{dstName};
+  SqliteOverlay::KeyValueTab copyCfg{copy, TabCfg};
+  ASSERT_EQ(2, copyCfg.getInt(TestKey));
+  ASSERT_EQ(3, cfg.getInt(TestKey));
+  ASSERT_EQ(cfg.getString(CfgKey_DbVersion), copyCfg.getString(CfgKey_DbVersion));
+}
@@ -0,0 +1,233 @@
+#include <set>
+#include <vector>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include <SqliteOverlay/KeyValueTab.h>
+
+#include "../TournamentDB.h"
+#include "../TournamentDataDefs.h"
+#include "../MatchMngr.h"
+#include "../CatMngr.h"
+#include "../MatchDependencyGraph.h"
+
+#include "ScenarioTestHelpers.h"
+
+using namespace QTournament;
+
+namespace
+{
+  struct MatchInfo
+  {
+    int id;
+    int round;
+    int pairId[2];
+    ObjState state;
+  };
+
+  //----------------------------------------------------------------------------
+
+  std::vector<MatchInfo> getMatchesForCat(const TournamentDB& db, const Category& cat)
+  {
+    std::vector<MatchInfo> result;
+
+    auto stmt = db.prepStatement("SELECT m.id, g." MG_Round ", m." MA_Pair1Ref ", m." MA_Pair2Ref ", m." GenericStateFieldName
+                                 " FROM " TabMatch " m JOIN " TabMatchGroup " g ON m." MA_GrpRef " = g.id"
+                                 " WHERE g." MG_CatRef " = ?1 ORDER BY m." MA_Num ", m.id");
+    stmt.bind(1, cat.getId());
+    for (stmt.step(); stmt.hasData(); stmt.step())
+    {
+      result.push_back(MatchInfo{stmt.getInt(0), stmt.getInt(1), {stmt.getInt(2), stmt.getInt(3)}, static_cast<ObjState>(stmt.getInt(4))});
+    }
+
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+  // a match with known player pairs has to wait if and only if
+  // one of its pairs has an unfinished match in an earlier round;
+  // the check is independent of the persisted graph
+  void assertWaitingMatchesAreBlocked(const TournamentDB& db, const Category& cat)
+  {
+    const auto allMatches = getMatchesForCat(db, cat);
+    for (const MatchInfo& mi : allMatches)
+    {
+      if ((mi.state != ObjState::MA_Waiting) && (mi.state != ObjState::MA_Ready) && (mi.state != ObjState::MA_Busy)) continue;
+
+      bool isBlocked = false;
+      for (const MatchInfo& other : allMatches)
+      {
+        if ((other.round >= mi.round) || (other.state == ObjState::MA_Finished)) continue;
+        for (int pairId : mi.pairId)
+        {
+          if ((pairId > 0) && ((other.pairId[0] == pairId) || (other.pairId[1] == pairId))) isBlocked = true;
+        }
+      }
+
+      ASSERT_EQ(isBlocked, mi.state == ObjState::MA_Waiting) << "match " << mi.id << " in round " << mi.round;
+      ASSERT_EQ(isBlocked, MatchDependencyGraph::hasUnfinishedPredecessor(db, mi.id)) << "match " << mi.id;
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  int countMatchesInState(const TournamentDB& db, const Category& cat, int round, ObjState stat)
+  {
+    int cnt{0};
+    for (const MatchInfo& mi : getMatchesForCat(db, cat))
+    {
+      if ((mi.round == round) && (mi.state == stat)) ++cnt;
+    }
+
+    return cnt;
+  }
+
+  //----------------------------------------------------------------------------
+
+  // calls the match, undoes the call and plays it; checks
+  // the states of all other matches after each step
+  void playWithUndo(const TournamentDB& db, const Category& cat, int maId)
+  {
+    MatchMngr mm{db};
+    auto ma = mm.getMatch(maId);
+    ASSERT_TRUE(ma.has_value());
+
+    ASSERT_EQ(Error::OK, Test::callMatch(db, *ma));
+    assertWaitingMatchesAreBlocked(db, cat);
+
+    ASSERT_EQ(Error::OK, mm.undoMatchCall(*ma));
+    ASSERT_EQ(ObjState::MA_Ready, ma->getState());
+    assertWaitingMatchesAreBlocked(db, cat);
+
+    ASSERT_EQ(Error::OK, Test::playMatch(db, *ma));
+    assertWaitingMatchesAreBlocked(db, cat);
+  }
+
+  //----------------------------------------------------------------------------
+
+  std::set<std::pair<int, int>> getAllEdges(const TournamentDB& db)
+  {
+    std::set<std::pair<int, int>> result;
+
+    auto stmt = db.prepStatement("SELECT " MD_MatchRef ", " MD_PredecessorRef " FROM " TabMatchDependency);
+    for (stmt.step(); stmt.hasData(); stmt.step())
+    {
+      result.insert({stmt.getInt(0), stmt.getInt(1)});
+    }
+
+    return result;
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST(MatchDependencyGraph, RoundRobinTransitions)
+{
+  auto dbPtr = Test::createStartedTournament();
+  ASSERT_TRUE(dbPtr != nullptr);
+  const TournamentDB& db = *dbPtr;
+  ASSERT_EQ(Error::OK, Test::stageAllMatchGroups(db));
+  MatchMngr mm{db};
+  mm.scheduleAllStagedMatchGroups();
+
+  CatMngr cm{db};
+  const Category rr = cm.getCategory("RR-1");
+  assertWaitingMatchesAreBlocked(db, rr);
+
+  // all matches of the second round wait for the first round
+  const int nMatchesPerRound = countMatchesInState(db, rr, 1, ObjState::MA_Ready);
+  ASSERT_GT(nMatchesPerRound, 1);
+  ASSERT_EQ(nMatchesPerRound, countMatchesInState(db, rr, 2, ObjState::MA_Waiting));
+
+  // play the first two rounds; a match of round two becomes
+  // READY as soon as the round-one matches of both pairs are finished
+  for (int round = 1; round <= 2; ++round)
+  {
+    for (const MatchInfo& mi : getMatchesForCat(db, rr))
+    {
+      if (mi.round != round) continue;
+      playWithUndo(db, rr, mi.id);
+    }
+  }
+  ASSERT_EQ(0, countMatchesInState(db, rr, 3, ObjState::MA_Waiting));
+  ASSERT_EQ(nMatchesPerRound, countMatchesInState(db, rr, 3, ObjState::MA_Ready));
+  ASSERT_EQ(nMatchesPerRound, countMatchesInState(db, rr, 4, ObjState::MA_Waiting));
+}
+
+//----------------------------------------------------------------------------
+
+TEST(MatchDependencyGraph, KnockoutTransitions)
+{
+  auto dbPtr = Test::createStartedTournament();
+  ASSERT_TRUE(dbPtr != nullptr);
+  const TournamentDB& db = *dbPtr;
+  ASSERT_EQ(Error::OK, Test::stageAllMatchGroups(db));
+  MatchMngr mm{db};
+  mm.scheduleAllStagedMatchGroups();
+
+  CatMngr cm{db};
+  const Category br = cm.getCategory("BR-1");
+  assertWaitingMatchesAreBlocked(db, br);
+
+  // play the bracket match by match; later rounds become
+  // READY once their symbolic predecessors are resolved
+  int nPlayed{0};
+  bool hasReadyMatch = true;
+  while (hasReadyMatch)
+  {
+    hasReadyMatch = false;
+    for (const MatchInfo& mi : getMatchesForCat(db, br))
+    {
+      if (mi.state != ObjState::MA_Ready) continue;
+
+      // the match's predecessors have to be finished
+      MatchDependencyGraph graph{db};
+      ASSERT_FALSE(graph.hasUnfinishedPredecessor(mi.id));
+
+      playWithUndo(db, br, mi.id);
+      ++nPlayed;
+      hasReadyMatch = true;
+      break;
+    }
+  }
+
+  // all playable matches have been played in dependency order
+  ASSERT_GT(nPlayed, 4);
+  for (ObjState stat : {ObjState::MA_Waiting, ObjState::MA_Ready, ObjState::MA_Busy})
+  {
+    for (const MatchInfo& mi : getMatchesForCat(db, br))
+    {
+      ASSERT_NE(stat, mi.state) << "match " << mi.id;
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST(MatchDependencyGraph, Upgrade)
+{
+  auto dbPtr = Test::createStartedTournament();
+  ASSERT_TRUE(dbPtr != nullptr);
+  const TournamentDB& db = *dbPtr;
+  ASSERT_EQ(Error::OK, Test::stageAllMatchGroups(db));
+  MatchMngr mm{db};
+  mm.scheduleAllStagedMatchGroups();
+
+  const auto edges = getAllEdges(db);
+  ASSERT_FALSE(edges.empty());
+
+  // fake a database in the previous format
+  auto stmt = db.prepStatement("DROP TABLE " TabMatchDependency);
+  stmt.step();
+  SqliteOverlay::KeyValueTab cfg{db, TabCfg};
+  cfg.set(CfgKey_DbVersion, "3.2");
+
+  ASSERT_TRUE(dbPtr->needsConversion());
+  ASSERT_TRUE(dbPtr->convertToLatestDatabaseVersion());
+  ASSERT_FALSE(dbPtr->needsConversion());
+
+  // the conversion re-creates the same edges
+  ASSERT_EQ(edges, getAllEdges(db));
+}
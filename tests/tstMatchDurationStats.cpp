@@ -0,0 +1,128 @@
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <SqliteOverlay/KeyValueTab.h>
+
+#include "../TournamentDB.h"
+#include "../TournamentDataDefs.h"
+#include "../MatchDurationStats.h"
+
+using namespace QTournament;
+
+namespace
+{
+  CatMatchDurationStats createStats(const std::vector<int>& durations)
+  {
+    CatMatchDurationStats result;
+    for (int d : durations) result.addSample(d);
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+  void assertSameEstimates(const CatMatchDurationStats& expected, const CatMatchDurationStats& actual)
+  {
+    ASSERT_EQ(expected.getCount(), actual.getCount());
+    ASSERT_EQ(expected.getTotal_secs(), actual.getTotal_secs());
+    for (auto est : {MatchDurationEstimator::Mean, MatchDurationEstimator::ExpWeighted, MatchDurationEstimator::TrimmedMean})
+    {
+      ASSERT_EQ(expected.getEstimate(est), actual.getEstimate(est)) << "estimator " << static_cast<int>(est);
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST(MatchDurationStats, Estimators)
+{
+  // no matches, no estimate
+  CatMatchDurationStats stats;
+  ASSERT_EQ(-1, stats.getEstimate(MatchDurationEstimator::Mean));
+  ASSERT_EQ(-1, stats.getEstimate(MatchDurationEstimator::ExpWeighted));
+  ASSERT_EQ(-1, stats.getEstimate(MatchDurationEstimator::TrimmedMean));
+
+  // negative durations are ignored
+  stats.addSample(-5);
+  ASSERT_EQ(0, stats.getCount());
+
+  // the first sample initializes the EWMA, the second one
+  // is weighted with EwmaAlpha; two samples are too few for trimming
+  stats = createStats({600, 1200});
+  ASSERT_EQ(2, stats.getCount());
+  ASSERT_EQ(1800, stats.getTotal_secs());
+  ASSERT_EQ(900, stats.getEstimate(MatchDurationEstimator::Mean));
+  ASSERT_EQ(720, stats.getEstimate(MatchDurationEstimator::ExpWeighted));
+  ASSERT_EQ(900, stats.getEstimate(MatchDurationEstimator::TrimmedMean));
+
+  // the trimmed mean drops the extreme values
+  stats = createStats({10, 500, 5000, 510, 520, 530, 540});
+  ASSERT_EQ(7610 / 7, stats.getEstimate(MatchDurationEstimator::Mean));
+  ASSERT_EQ(520, stats.getEstimate(MatchDurationEstimator::TrimmedMean));
+
+  // the trimmed mean only uses the most recent matches
+  std::vector<int> durations(5, 9000);
+  durations.insert(end(durations), CatMatchDurationStats::TrimWindowSize, 600);
+  stats = createStats(durations);
+  ASSERT_EQ(static_cast<int>(durations.size()), stats.getCount());
+  ASSERT_EQ(600, stats.getEstimate(MatchDurationEstimator::TrimmedMean));
+  ASSERT_GT(stats.getEstimate(MatchDurationEstimator::Mean), 600);
+}
+
+//----------------------------------------------------------------------------
+
+TEST(MatchDurationStats, StringConversion)
+{
+  // the EWMA is stored in full seconds, so the samples
+  // are chosen to produce integer values
+  for (const auto& durations : {std::vector<int>{}, std::vector<int>{600, 1200}, std::vector<int>{10, 500, 5000, 510, 520, 530, 540}})
+  {
+    const auto stats = createStats(durations);
+    assertSameEstimates(stats, CatMatchDurationStats::fromString(stats.toString()));
+  }
+
+  // invalid strings result in empty statistics
+  for (const std::string& s : {"", "1;2;3", "a;b;c;d", "2;1800;720;600,x"})
+  {
+    ASSERT_EQ(0, CatMatchDurationStats::fromString(s).getCount()) << s;
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST(MatchDurationStats, RecordFinishedMatch)
+{
+  TournamentDB db;
+  SqliteOverlay::KeyValueTab cfg{db, TabCfg};
+  constexpr int CatId = 42;
+
+  // the first write initializes the statistics from the match
+  // table which already contains the finished match; here the
+  // table is empty, so the category has no statistics yet
+  MatchDurationStats::recordFinishedMatch(db, CatId, 1000);
+  ASSERT_TRUE(cfg.hasKey(MatchDurationStats::CfgKey_StatsInitialized));
+  MatchDurationStats stats{db};
+  stats.reload();
+  ASSERT_EQ(0, stats.getStatsForCat(CatId).getCount());
+
+  // all following matches are added one by one
+  MatchDurationStats::recordFinishedMatch(db, CatId, 600);
+  MatchDurationStats::recordFinishedMatch(db, CatId, 1200);
+  MatchDurationStats::recordFinishedMatch(db, CatId + 1, 300);
+  stats.reloadCategory(CatId);
+  assertSameEstimates(createStats({600, 1200}), stats.getStatsForCat(CatId));
+  ASSERT_EQ(0, stats.getStatsForCat(CatId + 1).getCount());
+  stats.reloadCategory(CatId + 1);
+  ASSERT_EQ(3, stats.getTotalCount());
+  ASSERT_EQ(2100, stats.getTotal_secs());
+
+  // a re-used category ID starts without statistics
+  MatchDurationStats::deleteStatsForCat(db, CatId);
+  stats.reloadCategory(CatId);
+  ASSERT_EQ(0, stats.getStatsForCat(CatId).getCount());
+  ASSERT_EQ(1, stats.getTotalCount());
+  MatchDurationStats::recordFinishedMatch(db, CatId, 900);
+  stats.reloadCategory(CatId);
+  assertSameEstimates(createStats({900}), stats.getStatsForCat(CatId));
+}
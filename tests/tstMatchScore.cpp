@@ -0,0 +1,84 @@
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <QtGlobal>
+
+#include <SqliteOverlay/KeyValueTab.h>
+
+#include "../Score.h"
+#include "../TournamentDB.h"
+#include "../TournamentDataDefs.h"
+
+using namespace QTournament;
+
+TEST(MatchScore, CharsAndPackedInt)
+{
+  // the allocation-free functions must behave like the QString-based ones
+  qsrand(42);
+  for (int i = 0; i < 1000; ++i)
+  {
+    auto sc = MatchScore::genRandomScore(2, (i % 2) == 0);
+    ASSERT_TRUE(sc.has_value());
+
+    const QString s = sc->toString();
+    MatchScore::StringBuffer buf;
+    ASSERT_EQ(s.toStdString(), std::string{sc->toChars(buf)});
+
+    auto fromChars = MatchScore::fromCharsWithoutValidation(s.toStdString());
+    ASSERT_TRUE(fromChars.has_value());
+    ASSERT_EQ(s, fromChars->toString());
+
+    const int packed = sc->toPackedInt();
+    ASSERT_TRUE(packed > 0);
+    auto fromPacked = MatchScore::fromPackedInt(packed);
+    ASSERT_TRUE(fromPacked.has_value());
+    ASSERT_EQ(s, fromPacked->toString());
+  }
+
+  // blanks are tolerated, invalid games are not
+  auto sc = MatchScore::fromCharsWithoutValidation(" 21 : 15 ,30:29");
+  ASSERT_TRUE(sc.has_value());
+  ASSERT_EQ("21:15,30:29", sc->toString());
+  for (const std::string& s : {"", "21", "21:", "21:15,", "21:20", "31:29", "21:15;21:10", "a:b",
+                               "21:1,21:2,21:3,21:4,21:5,21:6"})
+  {
+    ASSERT_FALSE(MatchScore::fromCharsWithoutValidation(s).has_value()) << s;
+  }
+
+  // invalid packed values: negative, loser score 30, empty slot before a game
+  ASSERT_FALSE(MatchScore::fromPackedInt(-1).has_value());
+  ASSERT_FALSE(MatchScore::fromPackedInt(31).has_value());
+  ASSERT_FALSE(MatchScore::fromPackedInt(1 << 6).has_value());
+}
+
+//----------------------------------------------------------------------------
+
+TEST(MatchScore, UpgradePackedResult)
+{
+  TournamentDB db;
+
+  // fake a finished match from a 3.1 file; the match table
+  // only has foreign keys that we don't need here
+  {
+    auto stmt = db.prepStatement("PRAGMA foreign_keys = OFF");
+    stmt.step();
+  }
+  {
+    auto stmt = db.prepStatement("INSERT INTO " TabMatch " (" GenericStateFieldName ", " GenericSeqnumFieldName ", " MA_GrpRef ", " MA_Result ")"
+                                 " VALUES (0, 0, 1, '21:15,19:21,30:29')");
+    stmt.step();
+  }
+  SqliteOverlay::KeyValueTab cfg{db, TabCfg};
+  cfg.set(CfgKey_DbVersion, "3.1");
+
+  ASSERT_TRUE(db.needsConversion());
+  ASSERT_TRUE(db.convertToLatestDatabaseVersion());
+  ASSERT_FALSE(db.needsConversion());
+
+  auto packed = db.execScalarQueryIntOrNull("SELECT " MA_PackedResult " FROM " TabMatch);
+  ASSERT_TRUE(packed.has_value());
+  auto sc = MatchScore::fromPackedInt(*packed);
+  ASSERT_TRUE(sc.has_value());
+  ASSERT_EQ("21:15,19:21,30:29", sc->toString());
+}
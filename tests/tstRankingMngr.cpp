@@ -0,0 +1,211 @@
+#include <array>
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include "../TournamentDB.h"
+#include "../TournamentDataDefs.h"
+#include "../MatchMngr.h"
+#include "../CatMngr.h"
+#include "../RankingMngr.h"
+#include "../Score.h"
+
+#include "ScenarioTestHelpers.h"
+
+using namespace QTournament;
+
+namespace
+{
+  // won, draw and lost matches, won and lost games, won and lost points
+  using PairStats = std::array<int, 7>;
+
+  //----------------------------------------------------------------------------
+
+  // the accumulated stats of a pair, derived match by match from
+  // the results of the pair's matches in the rounds 1...round
+  PairStats getExpectedStats(const TournamentDB& db, const PlayerPair& pp, int round)
+  {
+    PairStats result{};
+
+    MatchMngr mm{db};
+    for (int r = 1; r <= round; ++r)
+    {
+      auto ma = mm.getMatchForPlayerPairAndRound(pp, r);
+      if (!ma) continue;   // bye or already knocked out
+
+      auto score = ma->getScore();
+      EXPECT_TRUE(score.has_value()) << "match " << ma->getId();
+      if (!score) continue;
+
+      const int playerNum = (ma->getPlayerPair1().getPairId() == pp.getPairId()) ? 1 : 2;
+      const int winner = score->getWinner();
+      if (winner == playerNum) ++result[0];
+      else if (winner == 0) ++result[1];
+      else ++result[2];
+
+      for (int n = 0; n < score->getNumGames(); ++n)
+      {
+        auto [sc1, sc2] = score->getGame(n)->getScore();
+        const int own = (playerNum == 1) ? sc1 : sc2;
+        const int other = (playerNum == 1) ? sc2 : sc1;
+        ++result[(own > other) ? 3 : 4];
+        result[5] += own;
+        result[6] += other;
+      }
+    }
+
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+  PairStats getStats(const RankingEntry& re)
+  {
+    auto [mWon, mDraw, mLost, mTotal] = re.getMatchStats();
+    auto [gWon, gLost, gTotal] = re.getGameStats();
+    auto [pWon, pLost] = re.getPointStats();
+
+    EXPECT_EQ(mWon + mDraw + mLost, mTotal);
+    EXPECT_EQ(gWon + gLost, gTotal);
+
+    return PairStats{mWon, mDraw, mLost, gWon, gLost, pWon, pLost};
+  }
+
+  //----------------------------------------------------------------------------
+
+  // compares every ranking entry of a round with the pair's match
+  // results; optionally checks that the ranks are 1...n without gaps
+  // and that they follow the category's order
+  void assertRankingMatchesResults(const TournamentDB& db, const Category& cat, int round, bool checkOrder)
+  {
+    RankingMngr rm{db};
+    auto lessThan = cat.convertToSpecializedObject()->getLessThanFunction();
+
+    auto rll = rm.getSortedRanking(cat, round);
+    ASSERT_FALSE(rll.empty()) << "round " << round;
+    for (RankingEntryList& rl : rll)
+    {
+      for (size_t i = 0; i < rl.size(); ++i)
+      {
+        auto pp = rl[i].getPlayerPair();
+        if (!pp) continue;   // a placeholder for a rank in a bracket
+
+        ASSERT_EQ(getExpectedStats(db, *pp, round), getStats(rl[i])) << "pair " << pp->getPairId() << " in round " << round;
+
+        if (!checkOrder) continue;
+        ASSERT_EQ(static_cast<int>(i + 1), rl[i].getRank()) << "round " << round;
+        if (i > 0)
+        {
+          ASSERT_FALSE(lessThan(rl[i], rl[i - 1])) << "rank " << (i + 1) << " in round " << round;
+        }
+      }
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  // the first match of a round
+  Match getFirstMatchOfRound(const TournamentDB& db, const Category& cat, int round)
+  {
+    MatchMngr mm{db};
+    auto mgl = mm.getMatchGroupsForCat(cat, round);
+    EXPECT_FALSE(mgl.empty());
+    auto mal = mm.getMatchesForMatchGroup(mgl.at(0));
+    EXPECT_FALSE(mal.empty());
+
+    return mal.at(0);
+  }
+
+  //----------------------------------------------------------------------------
+
+  // a valid score with the same winner but with different game and point counts
+  MatchScore getCorrectedScore(const MatchScore& sc)
+  {
+    return *MatchScore::fromString((sc.getWinner() == 1) ? "21:3,14:21,21:4" : "3:21,21:14,4:21");
+  }
+
+  //----------------------------------------------------------------------------
+
+  // a valid score with the opposite winner
+  MatchScore getFlippedScore(const MatchScore& sc)
+  {
+    return *MatchScore::fromString((sc.getWinner() == 1) ? "18:21,21:19,15:21" : "21:18,19:21,21:15");
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST(RankingMngr, RoundRobin)
+{
+  auto dbPtr = Test::createStartedTournament();
+  ASSERT_TRUE(dbPtr != nullptr);
+  const TournamentDB& db = *dbPtr;
+  ASSERT_EQ(Error::OK, Test::stageAllMatchGroups(db));
+  MatchMngr mm{db};
+  mm.scheduleAllStagedMatchGroups();
+
+  CatMngr cm{db};
+  const Category rr = cm.getCategory("RR-1");
+  RankingMngr rm{db};
+
+  // every pair gets an entry per finished round
+  for (int round = 1; round <= 2; ++round)
+  {
+    ASSERT_EQ(Error::OK, Test::playRound(db, rr, round));
+    for (const PlayerPair& pp : rr.getPlayerPairs())
+    {
+      ASSERT_TRUE(rm.getRankingEntry(pp, round).has_value()) << "pair " << pp.getPairId() << " in round " << round;
+    }
+  }
+  for (int round = 1; round <= 2; ++round) assertRankingMatchesResults(db, rr, round, true);
+
+  // corrections in the first round are
+  // accumulated into the second round, too
+  auto spec = rr.convertToSpecializedObject();
+  Match ma = getFirstMatchOfRound(db, rr, 1);
+  ASSERT_EQ(ModMatchResult::ModDone, spec->modifyMatchResult(ma, getFlippedScore(*ma.getScore())));
+  for (int round = 1; round <= 2; ++round) assertRankingMatchesResults(db, rr, round, true);
+
+  ASSERT_EQ(ModMatchResult::ModDone, spec->modifyMatchResult(ma, getCorrectedScore(*ma.getScore())));
+  for (int round = 1; round <= 2; ++round) assertRankingMatchesResults(db, rr, round, true);
+
+  // the next round continues with the corrected values
+  ASSERT_EQ(Error::OK, Test::playRound(db, rr, 3));
+  for (int round = 1; round <= 3; ++round) assertRankingMatchesResults(db, rr, round, true);
+}
+
+//----------------------------------------------------------------------------
+
+TEST(RankingMngr, Knockout)
+{
+  auto dbPtr = Test::createStartedTournament();
+  ASSERT_TRUE(dbPtr != nullptr);
+  const TournamentDB& db = *dbPtr;
+  ASSERT_EQ(Error::OK, Test::stageAllMatchGroups(db));
+  MatchMngr mm{db};
+  mm.scheduleAllStagedMatchGroups();
+
+  CatMngr cm{db};
+  const Category br = cm.getCategory("BR-1");
+
+  // ranks in brackets follow the bracket logic, so
+  // only the accumulated values are checked
+  ASSERT_EQ(Error::OK, Test::playRound(db, br, 1));
+  assertRankingMatchesResults(db, br, 1, false);
+
+  // the winner can still be swapped as
+  // long as the follow-up matches haven't started
+  auto spec = br.convertToSpecializedObject();
+  Match ma = getFirstMatchOfRound(db, br, 1);
+  ASSERT_EQ(ModMatchResult::WinnerLoser, spec->canModifyMatchResult(ma));
+  ASSERT_EQ(ModMatchResult::ModDone, spec->modifyMatchResult(ma, getFlippedScore(*ma.getScore())));
+  assertRankingMatchesResults(db, br, 1, false);
+
+  // after the next round, only the score can be
+  // modified and the change has to show up in both rounds
+  ASSERT_EQ(Error::OK, Test::playRound(db, br, 2));
+  assertRankingMatchesResults(db, br, 2, false);
+  ASSERT_EQ(ModMatchResult::ScoreOnly, spec->canModifyMatchResult(ma));
+  ASSERT_EQ(ModMatchResult::ModDone, spec->modifyMatchResult(ma, getCorrectedScore(*ma.getScore())));
+  for (int round = 1; round <= 2; ++round) assertRankingMatchesResults(db, br, round, false);
+}
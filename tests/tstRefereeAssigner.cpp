@@ -0,0 +1,210 @@
+#include <map>
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../TournamentDB.h"
+#include "../TournamentDataDefs.h"
+#include "../MatchMngr.h"
+#include "../CatMngr.h"
+#include "../PlayerMngr.h"
+#include "../RefereeAssigner.h"
+#include "../Score.h"
+
+#include "ScenarioTestHelpers.h"
+
+using namespace QTournament;
+
+namespace
+{
+  std::set<int> getPlayerIds(const Match& ma)
+  {
+    std::set<int> result;
+    for (const PlayerPair& pp : {ma.getPlayerPair1(), ma.getPlayerPair2()})
+    {
+      result.insert(pp.getPlayer1().getId());
+      if (pp.hasPlayer2()) result.insert(pp.getPlayer2().getId());
+    }
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+  std::set<int> getPlayerIds(const std::vector<RefereeCandidate>& cands)
+  {
+    std::set<int> result;
+    for (const RefereeCandidate& c : cands) result.insert(c.playerId);
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+  // plays the first matches of the first round robin round; nobody
+  // finishes more than one match, so the latest result of each
+  // player is unambiguous
+  std::map<int, RefereeTag> playSomeMatches(const TournamentDB& db, int nMatches)
+  {
+    MatchMngr mm{db};
+    CatMngr cm{db};
+    const Category rr = cm.getCategory("RR-1");
+
+    std::map<int, RefereeTag> result;
+    for (const Match& ma : mm.getMatchesForMatchGroup(mm.getMatchGroupsForCat(rr, 1).at(0)))
+    {
+      if (static_cast<int>(result.size()) >= 2 * nMatches) break;
+
+      if (Test::playMatch(db, ma) != Error::OK)
+      {
+        ADD_FAILURE() << "match " << ma.getId() << " could not be played";
+        break;
+      }
+      const int winner = ma.getScore()->getWinner();
+      result[ma.getPlayerPair1().getPlayer1().getId()] = (winner == 1) ? RefereeTag::Winner : RefereeTag::Loser;
+      result[ma.getPlayerPair2().getPlayer1().getId()] = (winner == 2) ? RefereeTag::Winner : RefereeTag::Loser;
+    }
+
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+  // the matches of the first round of the groups-with-KO
+  // category; they can be called independently of the round robin
+  std::vector<Match> getUnplayedMatches(const TournamentDB& db)
+  {
+    MatchMngr mm{db};
+    CatMngr cm{db};
+    const Category gko = cm.getCategory("GKO-1");
+
+    std::vector<Match> result;
+    for (const MatchGroup& mg : mm.getMatchGroupsForCat(gko, 1))
+    {
+      for (const Match& ma : mm.getMatchesForMatchGroup(mg)) result.push_back(ma);
+    }
+
+    return result;
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST(RefereeAssigner, TagsAndAvailability)
+{
+  auto dbPtr = Test::createStartedTournament();
+  ASSERT_TRUE(dbPtr != nullptr);
+  const TournamentDB& db = *dbPtr;
+  ASSERT_EQ(Error::OK, Test::stageAllMatchGroups(db));
+  MatchMngr mm{db};
+  mm.scheduleAllStagedMatchGroups();
+
+  const auto expectedTags = playSomeMatches(db, 3);
+  ASSERT_EQ(6u, expectedTags.size());
+
+  const auto unplayed = getUnplayedMatches(db);
+  ASSERT_GE(unplayed.size(), 3u);
+  const Match& target = unplayed[0];
+  const Match& busy = unplayed[1];
+  const Match& next = unplayed[2];
+  ASSERT_EQ(Error::OK, Test::callMatch(db, busy));
+
+  PlayerMngr pm{db};
+  const size_t nPlayers = pm.getAllPlayers().size();
+  const auto targetIds = getPlayerIds(target);
+  const auto busyIds = getPlayerIds(busy);
+
+  // pre-assignments may use anybody except the match's own players
+  RefereeAssigner ra{db};
+  auto cands = ra.getCandidates(target, RefereeMode::AllPlayers, RefereeAction::PreAssign);
+  ASSERT_EQ(nPlayers - targetIds.size(), cands.size());
+  for (const RefereeCandidate& c : cands)
+  {
+    ASSERT_EQ(0u, targetIds.count(c.playerId));
+
+    auto it = expectedTags.find(c.playerId);
+    const bool isFinisher = (it != expectedTags.end());
+    ASSERT_EQ(isFinisher ? it->second : RefereeTag::Neutral, c.tag) << "player " << c.playerId;
+    ASSERT_EQ(isFinisher, c.lastFinishTime > 0) << "player " << c.playerId;
+    ASSERT_EQ(0, c.refereeCount);
+  }
+
+  // match calls only use idle players
+  cands = ra.getCandidates(target, RefereeMode::AllPlayers, RefereeAction::MatchCall);
+  ASSERT_EQ(nPlayers - targetIds.size() - busyIds.size(), cands.size());
+  for (const RefereeCandidate& c : cands)
+  {
+    ASSERT_EQ(0u, busyIds.count(c.playerId));
+    ASSERT_EQ(ObjState::PL_Idle, c.state);
+  }
+
+  // recent finishers only include players with a finished match
+  std::set<int> expectedFinishers;
+  for (const auto& [plId, tag] : expectedTags)
+  {
+    if ((targetIds.count(plId) == 0) && (busyIds.count(plId) == 0)) expectedFinishers.insert(plId);
+  }
+  ASSERT_EQ(expectedFinishers, getPlayerIds(ra.getCandidates(target, RefereeMode::RecentFinishers, RefereeAction::MatchCall)));
+
+  // a call is reflected in memory without reloading; the
+  // players and the referee of the called match are no longer idle
+  const int refereeId = ra.getRankedCandidates(target, RefereeMode::AllPlayers, RefereeAction::MatchCall).at(0).playerId;
+  ra.markMatchCalled(target, refereeId);
+  auto nextIds = getPlayerIds(ra.getCandidates(next, RefereeMode::AllPlayers, RefereeAction::MatchCall));
+  ASSERT_EQ(0u, nextIds.count(refereeId));
+  std::set<int> excluded = getPlayerIds(next);
+  excluded.insert(begin(targetIds), end(targetIds));
+  excluded.insert(begin(busyIds), end(busyIds));
+  excluded.insert(refereeId);
+  for (int plId : excluded) ASSERT_EQ(0u, nextIds.count(plId));
+  ASSERT_EQ(nPlayers - excluded.size(), nextIds.size());
+}
+
+//----------------------------------------------------------------------------
+
+TEST(RefereeAssigner, CandidateOrder)
+{
+  auto dbPtr = Test::createStartedTournament();
+  ASSERT_TRUE(dbPtr != nullptr);
+  const TournamentDB& db = *dbPtr;
+  ASSERT_EQ(Error::OK, Test::stageAllMatchGroups(db));
+  MatchMngr mm{db};
+  mm.scheduleAllStagedMatchGroups();
+
+  playSomeMatches(db, 3);
+  const Match target = getUnplayedMatches(db).at(0);
+
+  // fewest assignments first, then losers before neutral
+  // players before winners, then the longest break
+  RefereeAssigner ra{db};
+  auto ranked = ra.getRankedCandidates(target, RefereeMode::AllPlayers, RefereeAction::PreAssign);
+  ASSERT_FALSE(ranked.empty());
+  for (size_t i = 1; i < ranked.size(); ++i)
+  {
+    const RefereeCandidate& c1 = ranked[i - 1];
+    const RefereeCandidate& c2 = ranked[i];
+    const auto k1 = std::make_tuple(c1.refereeCount, static_cast<int>(c1.tag), c1.lastFinishTime, c1.displayName);
+    const auto k2 = std::make_tuple(c2.refereeCount, static_cast<int>(c2.tag), c2.lastFinishTime, c2.displayName);
+    ASSERT_LE(k1, k2) << "position " << i;
+  }
+
+  // three losers and three winners minus at most the two players of the match
+  ASSERT_EQ(RefereeTag::Loser, ranked.front().tag);
+  ASSERT_EQ(RefereeTag::Winner, ranked.back().tag);
+
+  // the referee count takes precedence over the last result
+  const int firstId = ranked.front().playerId;
+  PlayerMngr pm{db};
+  pm.increaseRefereeCountForPlayer(pm.getPlayer(firstId));
+  ra.reload();
+  ranked = ra.getRankedCandidates(target, RefereeMode::AllPlayers, RefereeAction::PreAssign);
+  ASSERT_EQ(firstId, ranked.back().playerId);
+  ASSERT_EQ(1, ranked.back().refereeCount);
+
+  // the suggestion uses the match's referee mode
+  ASSERT_FALSE(ra.suggestReferee(target, RefereeAction::PreAssign).has_value());
+  ASSERT_EQ(Error::OK, mm.setRefereeMode(target, RefereeMode::AllPlayers));
+  auto suggestion = ra.suggestReferee(target, RefereeAction::PreAssign);
+  ASSERT_TRUE(suggestion.has_value());
+  ASSERT_EQ(ranked.front().playerId, *suggestion);
+}
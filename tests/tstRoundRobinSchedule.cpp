@@ -0,0 +1,120 @@
+#include <set>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "../RoundRobinGenerator.h"
+
+using namespace QTournament;
+
+namespace
+{
+  // the range of group sizes covers tabulated and computed schedules
+  constexpr int MinPlayers = 2;
+  constexpr int MaxPlayers = 70;
+
+  //----------------------------------------------------------------------------
+
+  // checks that every player meets every other player exactly
+  // once and that nobody plays twice in the same round
+  void assertCompleteSchedule(const RoundRobinSchedule& s)
+  {
+    const int n = s.getNumPlayers();
+    ASSERT_EQ((n % 2) ? n : n - 1, s.getNumRounds());
+    ASSERT_EQ(n / 2, s.getMatchesPerRound());
+    ASSERT_EQ(static_cast<size_t>(n * (n - 1) / 2), s.getAllMatches().size());
+
+    std::set<std::pair<int, int>> allPairings;
+    for (int r = 0; r < s.getNumRounds(); ++r)
+    {
+      std::vector<bool> hasPlayed(n, false);
+      auto [first, last] = s.getRound(r);
+      ASSERT_EQ(s.getMatchesPerRound(), last - first);
+      for (auto it = first; it != last; ++it)
+      {
+        const int p1 = it->player1;
+        const int p2 = it->player2;
+        ASSERT_NE(p1, p2);
+        ASSERT_LT(p1, n);
+        ASSERT_LT(p2, n);
+        ASSERT_FALSE(hasPlayed[p1]) << "n = " << n << ", round " << r;
+        ASSERT_FALSE(hasPlayed[p2]) << "n = " << n << ", round " << r;
+        hasPlayed[p1] = true;
+        hasPlayed[p2] = true;
+
+        const bool isNew = allPairings.insert({std::min(p1, p2), std::max(p1, p2)}).second;
+        ASSERT_TRUE(isNew) << "n = " << n << ": " << p1 << " vs. " << p2 << " occurs twice";
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST(RoundRobinSchedule, SameAsGenerator)
+{
+  RoundRobinGenerator gen;
+  for (int n = MinPlayers; n <= MaxPlayers; ++n)
+  {
+    RoundRobinSchedule s{n};
+    for (int r = 0; r < s.getNumRounds(); ++r)
+    {
+      std::vector<std::tuple<int, int>> fromSchedule;
+      auto [first, last] = s.getRound(r);
+      for (auto it = first; it != last; ++it)
+      {
+        fromSchedule.push_back(std::tuple{static_cast<int>(it->player1), static_cast<int>(it->player2)});
+      }
+
+      ASSERT_EQ(gen(n, r), fromSchedule) << "n = " << n << ", round " << r;
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST(RoundRobinSchedule, AllPairingsOnce)
+{
+  for (int n = MinPlayers; n <= MaxPlayers; ++n)
+  {
+    for (bool balance : {false, true})
+    {
+      for (bool rest : {false, true})
+      {
+        RoundRobinOptions opt;
+        opt.balanceHomeAway = balance;
+        opt.restBetweenRounds = rest;
+
+        SCOPED_TRACE("n = " + std::to_string(n) + ", balance = " + std::to_string(balance) + ", rest = " + std::to_string(rest));
+        RoundRobinSchedule s{n, opt};
+        assertCompleteSchedule(s);
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST(RoundRobinSchedule, BalancedHomeAway)
+{
+  for (int n = MinPlayers; n <= MaxPlayers; ++n)
+  {
+    RoundRobinOptions opt;
+    opt.balanceHomeAway = true;
+    RoundRobinSchedule s{n, opt};
+
+    // every player is "player 1" in about half of their matches
+    std::vector<int> homeCount(n, 0);
+    for (const RoundRobinPairing& p : s.getAllMatches()) ++homeCount[p.player1];
+    for (int player = 0; player < n; ++player)
+    {
+      const int nMatches = n - 1;
+      ASSERT_LE(std::abs(2 * homeCount[player] - nMatches), 2) << "n = " << n << ", player " << player;
+    }
+  }
+}
@@ -0,0 +1,175 @@
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../TournamentDB.h"
+#include "../TournamentDataDefs.h"
+#include "../MatchMngr.h"
+#include "../SchedulePlanner.h"
+
+#include "ScenarioTestHelpers.h"
+
+using namespace QTournament;
+
+namespace
+{
+  // a fixed "now" so that the planner results don't depend on the wall clock
+  constexpr time_t RefTime = 1600000000;
+
+  struct QueuedMatch
+  {
+    int catId;
+    int round;
+    int pairId[2];
+    int srcMatchId[2];
+  };
+
+  //----------------------------------------------------------------------------
+
+  std::map<int, QueuedMatch> getMatchInfo(const TournamentDB& db)
+  {
+    std::map<int, QueuedMatch> result;
+
+    auto stmt = db.prepStatement("SELECT m.id, g." MG_CatRef ", g." MG_Round ", m." MA_Pair1Ref ", m." MA_Pair2Ref
+                                 ", m." MA_Pair1SymbolicVal ", m." MA_Pair2SymbolicVal
+                                 " FROM " TabMatch " m JOIN " TabMatchGroup " g ON m." MA_GrpRef " = g.id");
+    for (stmt.step(); stmt.hasData(); stmt.step())
+    {
+      result[stmt.getInt(0)] = QueuedMatch{stmt.getInt(1), stmt.getInt(2), {stmt.getInt(3), stmt.getInt(4)},
+                                           {std::abs(stmt.getInt(5)), std::abs(stmt.getInt(6))}};
+    }
+
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+  // checks that no match is queued in front of a match it depends on
+  void assertOrderRespectsDependencies(const TournamentDB& db, const std::vector<int>& order)
+  {
+    const auto info = getMatchInfo(db);
+
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+      const QueuedMatch& early = info.at(order[i]);
+      for (size_t j = i + 1; j < order.size(); ++j)
+      {
+        const QueuedMatch& late = info.at(order[j]);
+
+        // winner / loser links
+        ASSERT_NE(order[j], early.srcMatchId[0]);
+        ASSERT_NE(order[j], early.srcMatchId[1]);
+
+        // a player pair plays its rounds in ascending order
+        if (early.catId != late.catId) continue;
+        for (int pEarly : early.pairId)
+        {
+          if (pEarly <= 0) continue;
+          for (int pLate : late.pairId)
+          {
+            if (pEarly == pLate)
+            {
+              ASSERT_LE(early.round, late.round) << "match " << order[i] << " overtakes match " << order[j];
+            }
+          }
+        }
+      }
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  // the current queue, sorted by match number
+  std::vector<int> getScheduledOrder(const TournamentDB& db, const std::vector<int>& maIds)
+  {
+    std::vector<std::pair<int, int>> num2Id;
+    auto stmt = db.prepStatement("SELECT " MA_Num " FROM " TabMatch " WHERE id = ?1");
+    for (int maId : maIds)
+    {
+      stmt.bind(1, maId);
+      stmt.step();
+      num2Id.push_back({stmt.getInt(0), maId});
+      stmt.reset(true);
+    }
+    std::sort(begin(num2Id), end(num2Id));
+
+    std::vector<int> result;
+    for (const auto& [num, maId] : num2Id) result.push_back(maId);
+    return result;
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST(SchedulePlanner, RespectsDependencies)
+{
+  auto dbPtr = Test::createStartedTournament();
+  ASSERT_TRUE(dbPtr != nullptr);
+  const TournamentDB& db = *dbPtr;
+  ASSERT_EQ(Error::OK, Test::stageAllMatchGroups(db));
+
+  // plan everything, including the staged groups
+  SchedulePlanner planner{db};
+  SchedulePlan plan = planner.createPlan(true, RefTime);
+  ASSERT_FALSE(plan.currentOrder.empty());
+  assertOrderRespectsDependencies(db, plan.currentOrder);
+  assertOrderRespectsDependencies(db, plan.proposedOrder);
+
+  // the proposal is a permutation of the queue
+  std::vector<int> cur{plan.currentOrder};
+  std::vector<int> proposed{plan.proposedOrder};
+  std::sort(begin(cur), end(cur));
+  std::sort(begin(proposed), end(proposed));
+  ASSERT_EQ(cur, proposed);
+  ASSERT_LE(plan.proposed.cost, plan.current.cost);
+
+  // same after a few matches are running
+  MatchMngr mm{db};
+  mm.scheduleAllStagedMatchGroups();
+  ASSERT_FALSE(mm.callMatchesOnFreeCourts().empty());
+  plan = planner.createPlan(false, RefTime);
+  ASSERT_FALSE(plan.currentOrder.empty());
+  assertOrderRespectsDependencies(db, plan.proposedOrder);
+  ASSERT_LE(plan.proposed.cost, plan.current.cost);
+}
+
+//----------------------------------------------------------------------------
+
+TEST(SchedulePlanner, ApplyPlan)
+{
+  auto dbPtr = Test::createStartedTournament();
+  ASSERT_TRUE(dbPtr != nullptr);
+  const TournamentDB& db = *dbPtr;
+  ASSERT_EQ(Error::OK, Test::stageAllMatchGroups(db));
+
+  // applying a plan schedules the staged groups
+  SchedulePlanner planner{db};
+  SchedulePlan plan = planner.createPlan(true, RefTime);
+  ASSERT_EQ(Error::OK, planner.applyPlan(plan));
+  MatchMngr mm{db};
+  ASSERT_TRUE(mm.getStagedMatchGroupsOrderedBySequence().empty());
+  ASSERT_EQ(plan.proposedOrder, getScheduledOrder(db, plan.proposedOrder));
+
+  // a plan for an outdated queue is rejected
+  SchedulePlan stale = planner.createPlan(false, RefTime);
+  ASSERT_FALSE(mm.callMatchesOnFreeCourts().empty());
+  ASSERT_EQ(Error::WrongState, planner.applyPlan(stale));
+
+  // the matches swap their numbers without creating gaps
+  plan = planner.createPlan(false, RefTime);
+  std::vector<int> oldNumbers;
+  for (int maId : plan.currentOrder) oldNumbers.push_back(mm.getMatch(maId)->getMatchNumber());
+  std::sort(begin(oldNumbers), end(oldNumbers));
+
+  plan.proposedOrder.assign(plan.currentOrder.rbegin(), plan.currentOrder.rend());
+  ASSERT_EQ(Error::OK, planner.applyPlan(plan));
+  ASSERT_EQ(plan.proposedOrder, getScheduledOrder(db, plan.proposedOrder));
+
+  std::vector<int> newNumbers;
+  for (int maId : plan.proposedOrder) newNumbers.push_back(mm.getMatch(maId)->getMatchNumber());
+  ASSERT_TRUE(std::is_sorted(begin(newNumbers), end(newNumbers)));
+  ASSERT_EQ(oldNumbers, newNumbers);
+}
@@ -189,3 +189,27 @@ TEST(SwissLadderGen, NoDoubleBye)
   size_t pos = s.find('5');
   ASSERT_EQ(string::npos, pos);
 }
+
+//----------------------------------------------------------------------------
+
+TEST(SwissLadderGen, StateLookupAndSerialization)
+{
+  SwissLadderState st{strToVecOfTuples("1,2:3,4:1,3")};
+
+  ASSERT_TRUE(st.hasMatchBeenPlayed(1, 2));
+  ASSERT_TRUE(st.hasMatchBeenPlayed(2, 1));
+  ASSERT_TRUE(st.hasMatchBeenPlayed(3, 1));
+  ASSERT_FALSE(st.hasMatchBeenPlayed(1, 4));
+  ASSERT_FALSE(st.hasMatchBeenPlayed(5, 6));
+  ASSERT_EQ(2, st.getMatchCount(1));
+  ASSERT_EQ(1, st.getMatchCount(4));
+  ASSERT_EQ(0, st.getMatchCount(5));
+
+  // round trip
+  auto st2 = SwissLadderState::fromString(st.toString());
+  ASSERT_EQ(st.getPastMatches(), st2.getPastMatches());
+
+  // invalid strings yield an empty state
+  ASSERT_EQ(0u, SwissLadderState::fromString("1,2:3").size());
+  ASSERT_EQ(0u, SwissLadderState::fromString("").size());
+}
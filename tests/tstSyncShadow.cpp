@@ -0,0 +1,124 @@
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "../SyncShadow.h"
+
+using namespace QTournament;
+using namespace std;
+
+namespace
+{
+  // a full sync with two tables; the string field
+  // contains a comma and an escaped quote
+  const string FullSync =
+      "Court:2\n"
+      "id,Name,Number\n"
+      "1,\"Court 1\",1\n"
+      "2,\"Court, \\\"two\\\"\",2\n"
+      "Match:3\n"
+      "id,ObjState,CourtRef,Result\n"
+      "10,20,,\n"
+      "11,20,,\n"
+      "12,20,,\n";
+}
+
+//----------------------------------------------------------------------------
+
+TEST(SyncShadow, UnknownRowsAreSentCompletely)
+{
+  SyncShadow shadow;
+  ASSERT_EQ(FullSync, shadow.encodeDelta(FullSync));
+}
+
+//----------------------------------------------------------------------------
+
+TEST(SyncShadow, ChangedColumnsOnly)
+{
+  SyncShadow shadow;
+  shadow.apply(FullSync);
+  ASSERT_EQ(5u, shadow.getRowCount());
+
+  // two matches are called on courts, one match is finished,
+  // one court is unchanged and a new match shows up
+  const string partial =
+      "Court:1\n"
+      "id,Name,Number\n"
+      "2,\"Court, \\\"two\\\"\",2\n"
+      "Match:4\n"
+      "id,ObjState,CourtRef,Result\n"
+      "10,21,1,\n"
+      "11,21,2,\n"
+      "12,22,,\"21:19,21:17\"\n"
+      "13,20,,\n";
+
+  const string expected =
+      "Match:2\n"
+      "id,ObjState,CourtRef\n"
+      "10,21,1\n"
+      "11,21,2\n"
+      "Match:1\n"
+      "id,ObjState,Result\n"
+      "12,22,\"21:19,21:17\"\n"
+      "Match:1\n"
+      "id,ObjState,CourtRef,Result\n"
+      "13,20,,\n";
+  ASSERT_EQ(expected, shadow.encodeDelta(partial));
+
+  // encoding doesn't modify the shadow
+  ASSERT_EQ(expected, shadow.encodeDelta(partial));
+
+  // after applying, the same changes are no changes anymore
+  shadow.apply(partial);
+  ASSERT_EQ(6u, shadow.getRowCount());
+  ASSERT_EQ("", shadow.encodeDelta(partial));
+}
+
+//----------------------------------------------------------------------------
+
+TEST(SyncShadow, Deletions)
+{
+  SyncShadow shadow;
+  shadow.apply(FullSync);
+
+  const string partial =
+      "Match:2\n"
+      "id,ObjState,CourtRef,Result\n"
+      "-11\n"
+      "12,21,1,\n";
+  const string expected =
+      "Match:1\n"
+      "id,ObjState,CourtRef\n"
+      "12,21,1\n"
+      "Match:1\n"
+      "id\n"
+      "-11\n";
+  ASSERT_EQ(expected, shadow.encodeDelta(partial));
+
+  shadow.apply(partial);
+  ASSERT_EQ(4u, shadow.getRowCount());
+}
+
+//----------------------------------------------------------------------------
+
+TEST(SyncShadow, ChangedColumnList)
+{
+  SyncShadow shadow;
+  shadow.apply(FullSync);
+
+  // a different column list invalidates the shadow of the table
+  const string partial =
+      "Court:1\n"
+      "id,Name\n"
+      "1,\"Court 1\"\n";
+  ASSERT_EQ(partial, shadow.encodeDelta(partial));
+}
+
+//----------------------------------------------------------------------------
+
+TEST(SyncShadow, InvalidInput)
+{
+  SyncShadow shadow;
+  ASSERT_THROW(shadow.encodeDelta("Court\nid\n1\n"), std::invalid_argument);
+  ASSERT_THROW(shadow.encodeDelta("Court:3\nid\n1\n"), std::invalid_argument);
+}
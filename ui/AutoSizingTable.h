@@ -288,6 +288,8 @@ namespace GuiHelpers
       if (useSortedModel)
       {
         sortedModel->setSourceModel(cdm);
+      } else {
+        setModel(cdm);
       }
 
       customDataModel.reset(cdm);
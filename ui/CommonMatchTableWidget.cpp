@@ -84,93 +84,16 @@ void CommonMatchTableWidget::insertMatch(int beforeRowIdx, const Match& ma)
 {
   insertRow(beforeRowIdx);
   int matchId = ma.getId();
-  
-  int roundOffset = ma.getCategory().getParameter_int(CatParameter::FirstRoundOffset);  
 
-  // a helper lamba for setting the content of a cell
-  auto setCellItem = [&](int col, const QString& txt, int userData)
+  // the cell contents are the same as in the match log; the
+  // match info is displayed by the delegate
+  const QStringList cellTexts = MatchLogTableModel::getCellTexts(ma);
+  for (int col = 0; col < cellTexts.size(); ++col)
   {
-    QTableWidgetItem* newItem = new QTableWidgetItem(txt);
-    newItem->setData(Qt::UserRole, userData);
+    QTableWidgetItem* newItem = new QTableWidgetItem(cellTexts[col]);
+    newItem->setData(Qt::UserRole, matchId);
     newItem->setFlags(Qt::ItemIsSelectable | Qt::ItemIsEnabled);
     setItem(beforeRowIdx, col, newItem);
-  };
-
-  // add the match number
-  int maNum = ma.getMatchNumber();
-  if (maNum != MatchNumNotAssigned)
-  {
-    setCellItem(IdxMatchNumCol, QString::number(maNum), matchId);
-  } else {
-    setCellItem(IdxMatchNumCol, "--", matchId);
-  }
-
-
-  // add category and round
-  setCellItem(IdxConfigCol, ma.getCategory().getName(), matchId);
-  auto grp = ma.getMatchGroup();
-  setCellItem(IdxRoundCol, QString::number(grp.getRound() + roundOffset), matchId);
-
-  // add the group number, if any
-  int grpNum = grp.getGroupNumber();
-  if (grpNum > 0)
-  {
-    setCellItem(IdxGrpCol, QString::number(grpNum), matchId);
-  } else {
-    setCellItem(IdxGrpCol, "--", matchId);
-  }
-
-  // add only empty text for the match info. the content will be displayed
-  // by the delegate
-  setCellItem(IdxMatchInfoCol, "", matchId);
-
-  // start and finish time
-  QDateTime startTime = ma.getStartTime();
-  if (startTime.isValid())
-  {
-    setCellItem(IdxStartTimeCol, ma.getStartTime().toString("HH:mm"), matchId);
-    setCellItem(IdxFinishTimeCol, ma.getFinishTime().toString("HH:mm"), matchId);
-  } else {
-    // walkover
-    setCellItem(IdxStartTimeCol, "--", matchId);
-    setCellItem(IdxFinishTimeCol, "--", matchId);
-  }
-
-  // the duration
-  int duration = ma.getMatchDuration();
-  if (duration >= 0)
-  {
-    int hours = duration / 3600;
-    int minutes = (duration % 3600) / 60;
-    QString sDuration = "%1:%2";
-    sDuration = sDuration.arg(hours).arg(minutes, 2, 10, QLatin1Char('0'));
-    setCellItem(IdxDurationCol, sDuration, matchId);
-  } else {
-    if (ma.isWonByWalkover())
-    {
-      setCellItem(IdxDurationCol, tr("walkover"), matchId);
-    } else {
-      setCellItem(IdxDurationCol, "--", matchId);
-    }
-  }
-
-  // the court
-  auto co = ma.getCourt(nullptr);
-  if (co)
-  {
-    QString cn = QString::number(co->getNumber());
-    setCellItem(IdxCourtCol, cn, matchId);
-  } else {
-    setCellItem(IdxCourtCol, "--", matchId);
-  }
-
-  // the umpire
-  auto ump = ma.getAssignedReferee();
-  if (ump)
-  {
-    setCellItem(IdxUmpireCol, ump->getDisplayName_FirstNameFirst(), matchId);
-  } else {
-    setCellItem(IdxUmpireCol, "--", matchId);
   }
 
   resizeRowToContents(beforeRowIdx);
@@ -25,6 +25,7 @@
 #include "TournamentDB.h"
 #include "Match.h"
 #include "delegates/MatchLogItemDelegate.h"
+#include "models/MatchLogTableModel.h"
 #include "AutoSizingTable.h"
 
 
@@ -33,16 +34,17 @@ class CommonMatchTableWidget : public GuiHelpers::AutoSizingTableWidget_WithData
   Q_OBJECT
 
 public:
-  static constexpr int IdxMatchNumCol = 0;
-  static constexpr int IdxConfigCol = 1;
-  static constexpr int IdxRoundCol = 2;
-  static constexpr int IdxGrpCol = 3;
-  static constexpr int IdxMatchInfoCol = 4;
-  static constexpr int IdxStartTimeCol = 5;
-  static constexpr int IdxFinishTimeCol = 6;
-  static constexpr int IdxDurationCol = 7;
-  static constexpr int IdxCourtCol = 8;
-  static constexpr int IdxUmpireCol = 9;
+  // same columns as in the match log
+  static constexpr int IdxMatchNumCol = QTournament::MatchLogTableModel::IdxMatchNumCol;
+  static constexpr int IdxConfigCol = QTournament::MatchLogTableModel::IdxConfigCol;
+  static constexpr int IdxRoundCol = QTournament::MatchLogTableModel::IdxRoundCol;
+  static constexpr int IdxGrpCol = QTournament::MatchLogTableModel::IdxGrpCol;
+  static constexpr int IdxMatchInfoCol = QTournament::MatchLogTableModel::IdxMatchInfoCol;
+  static constexpr int IdxStartTimeCol = QTournament::MatchLogTableModel::IdxStartTimeCol;
+  static constexpr int IdxFinishTimeCol = QTournament::MatchLogTableModel::IdxFinishTimeCol;
+  static constexpr int IdxDurationCol = QTournament::MatchLogTableModel::IdxDurationCol;
+  static constexpr int IdxCourtCol = QTournament::MatchLogTableModel::IdxCourtCol;
+  static constexpr int IdxUmpireCol = QTournament::MatchLogTableModel::IdxUmpireCol;
 
   CommonMatchTableWidget(QWidget* parent);
 
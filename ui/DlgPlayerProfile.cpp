@@ -170,7 +170,7 @@ void DlgPlayerProfile::fillLabels()
   // set the umpire statistics
   //
   txt = tr("%1 services (%2 finished, %3 running, %4 waiting)");
-  txt = txt.arg(pp.getMatchesAsUmpire().length());
+  txt = txt.arg(static_cast<int>(pp.getMatchesAsUmpire().size()));
   txt = txt.arg(pp.getUmpireFinishedCount());
   if (plStat == ObjState::PL_Referee)
   {
@@ -187,22 +187,15 @@ void DlgPlayerProfile::fillLabels()
 
 void DlgPlayerProfile::fillTables()
 {
-  ui->umpireTab->appendMatchList(pp.getMatchesAsUmpire());
-
-  // for the matches as player append them one by one
-  // and skip the un-scheduled matches first and then
-  // append them in a second loop
-  //
-  // --> the unscheduled matches go the bottom of the table
-  auto maList = pp.getMatchesAsPlayer();
-  for (const Match& ma : maList)
+  for (const MatchHandle& h : pp.getMatchesAsUmpire())
   {
-    if (ma.getMatchNumber() == MatchNumNotAssigned) continue;
-    ui->playerTab->appendMatch(ma);
+    ui->umpireTab->appendMatch(h.get(db));
   }
-  for (const Match& ma : maList)
+
+  // the profile already puts the unscheduled
+  // matches at the bottom of the list
+  for (const MatchHandle& h : pp.getMatchesAsPlayer())
   {
-    if (ma.getMatchNumber() != MatchNumNotAssigned) continue;
-    ui->playerTab->appendMatch(ma);
+    ui->playerTab->appendMatch(h.get(db));
   }
 }
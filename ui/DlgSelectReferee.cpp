@@ -39,7 +39,7 @@ using namespace QTournament;
 
 DlgSelectReferee::DlgSelectReferee(const TournamentDB& _db, const Match& _ma, RefereeAction _refAction, QWidget *parent) :
   QDialog(parent),
-  ui(new Ui::DlgSelectReferee), db(_db), ma(_ma), refAction(_refAction)
+  ui(new Ui::DlgSelectReferee), db(_db), ma(_ma), refAction(_refAction), assigner(_db, MaxNumLosers)
 {
   ui->setupUi(this);
 
@@ -200,6 +200,35 @@ void DlgSelectReferee::onBtnNoneClicked()
 
 //----------------------------------------------------------------------------
 
+void DlgSelectReferee::onBtnAutoClicked()
+{
+  // pick the best candidate for the current filter settings;
+  // the candidate data is already in memory
+  int curFilterModeId = ui->cbFilterMode->currentData().toInt();
+  RefereeMode curFilterMode = static_cast<RefereeMode>(curFilterModeId);
+  int curTeamId = ui->cbTeamSelection->currentData().toInt();
+  const auto ranked = assigner.getRankedCandidates(ma, curFilterMode, refAction, curTeamId);
+  if (ranked.empty())
+  {
+    QMessageBox::information(this, tr("Select umpire"), tr("There is no suitable umpire for this match."));
+    return;
+  }
+
+  PlayerMngr pm{db};
+  finalPlayerSelection = pm.getPlayer2(ranked.front().playerId);
+
+  // store the team selection as the new default team
+  if (curFilterMode == RefereeMode::SpecialTeam)
+  {
+    SqliteOverlay::KeyValueTab cfg{db, TabCfg};
+    cfg.set(CfgKey_RefereeTeamId, curTeamId);
+  }
+
+  accept();
+}
+
+//----------------------------------------------------------------------------
+
 void DlgSelectReferee::onPlayerDoubleClicked()
 {
   if (!(ui->tabPlayers->hasPlayerSelected())) return;
@@ -273,130 +302,15 @@ void DlgSelectReferee::rebuildPlayerList()
   RefereeMode curFilterMode = static_cast<RefereeMode>(curFilterModeId);
   int curTeamId = ui->cbTeamSelection->currentData().toInt();
 
-  // if the current filter is "team" but there is no team selected,
-  // stop here
-  if ((curFilterMode == RefereeMode::SpecialTeam) && (curTeamId < 1))
-  {
-    ui->tabPlayers->rebuildPlayerList(TaggedPlayerList(), ma.getMatchNumber(), curFilterMode);
-    return;
-  }
-
-  // determine the list of players for display
-  PlayerMngr pm{db};
-  TeamMngr tm{db};
-  TaggedPlayerList pList;
-  if (curFilterMode == RefereeMode::AllPlayers)
-  {
-    PlayerList purePlayerList = pm.getAllPlayers();
-
-    // sort players alphabetically
-    std::sort(purePlayerList.begin(), purePlayerList.end(), [](const Player& p1, const Player& p2) {
-      return p1.getDisplayName() < p2.getDisplayName();
-    });
-
-    // convert to a tagged player list with all tags set to NEUTRAL
-    for (const Player& p : purePlayerList)
-    {
-      pList.push_back(std::make_pair(p, RefereeSelectionDelegate::NeutralTag));
-    }
-  }
-  if (curFilterMode == RefereeMode::SpecialTeam)
-  {
-    Team selTeam = tm.getTeamById(curTeamId);
-    PlayerList purePlayerList = tm.getPlayersForTeam(selTeam);
-
-    std::sort(purePlayerList.begin(), purePlayerList.end(), [](const Player& p1, const Player& p2) {
-      return p1.getDisplayName() < p2.getDisplayName();
-    });
-
-    // convert to a tagged player list with all tags set to NEUTRAL
-    for (const Player& p : purePlayerList)
-    {
-      pList.push_back(std::make_pair(p, RefereeSelectionDelegate::NeutralTag));
-    }
-  }
-  if (curFilterMode == RefereeMode::RecentFinishers)
-  {
-    pList = getPlayerList_recentFinishers();
-  }
-
-  // if we currently calling the match or swapping the umpire, only players in state IDLE
-  // may be selected
-  if (refAction != RefereeAction::PreAssign)
-  {
-    auto it = pList.begin();
-    while (it != pList.end())
-    {
-      const TaggedPlayer& tp = *it;
-      const Player& p = tp.first;
-      if (p.is_NOT_InState(ObjState::PL_Idle))
-      {
-        it = pList.erase(it);
-      } else {
-        ++it;
-      }
-    }
-  }
+  // the assigner holds all player data in memory and applies the
+  // filter and state restrictions; if the current filter is "team"
+  // but there is no team selected, the list is empty
+  //
+  // the table does the sorting by itself
+  const auto candList = assigner.getCandidates(ma, curFilterMode, refAction, curTeamId);
 
   // add the players to the table
-  ui->tabPlayers->rebuildPlayerList(pList, ma.getMatchNumber(), curFilterMode);
-}
-
-//----------------------------------------------------------------------------
-
-TaggedPlayerList DlgSelectReferee::getPlayerList_recentFinishers()
-{
-  PlayerMngr pm{db};
-  PlayerPairList winners;
-  PlayerPairList losers;
-  PlayerPairList draws;
-  pm.getRecentFinishers(MaxNumLosers, winners, losers, draws);
-
-  // process winners, losers and draws
-  std::vector<std::pair<PlayerPairList&, int>> allLists = {
-    {winners, RefereeSelectionDelegate::WinnerTag},
-    {losers, RefereeSelectionDelegate::LoserTag},
-    {draws, RefereeSelectionDelegate::NeutralTag},
-  };
-  TaggedPlayerList result;
-  for (std::pair<PlayerPairList&, int> listDef : allLists)
-  {
-    PlayerList purePlayerList;
-    for (const PlayerPair& pp : listDef.first)
-    {
-      Player p = pp.getPlayer1();
-
-      // if this player is already a referee, skip this player
-      if (p.isInState(ObjState::PL_Referee)) continue;
-
-      // Before we add this player to the result list,
-      // make sure that the player is not already in it
-      if (std::find(purePlayerList.begin(), purePlayerList.end(), p) == purePlayerList.end())
-      {
-        purePlayerList.push_back(p);
-      }
-
-      // if this is a doubles pair, check the second player as well
-      if (pp.hasPlayer2())
-      {
-        p = pp.getPlayer2();
-        if (p.isInState(ObjState::PL_Referee)) continue;
-        if (std::find(purePlayerList.begin(), purePlayerList.end(), p) == purePlayerList.end())
-        {
-          purePlayerList.push_back(p);
-        }
-      }
-    }
-
-    // convert the winner into a tagged player list
-    // with the tag set to the appropriate value
-    for (const Player& p : purePlayerList)
-    {
-      result.push_back(std::make_pair(p, listDef.second));
-    }
-  }
-
-  return result;
+  ui->tabPlayers->rebuildPlayerList(db, candList, ma.getMatchNumber(), curFilterMode);
 }
 
 
@@ -420,7 +334,7 @@ RefereeTableWidget::RefereeTableWidget(QWidget* parent)
 
 //----------------------------------------------------------------------------
 
-void RefereeTableWidget::rebuildPlayerList(const TaggedPlayerList& pList, int selectedMatchNumer, RefereeMode _refMode)
+void RefereeTableWidget::rebuildPlayerList(const TournamentDB& _db, const std::vector<RefereeCandidate>& candList, int selectedMatchNumer, RefereeMode _refMode)
 {
   // store the current referee mode. We need this to properly
   // initiate the filtering column
@@ -430,54 +344,51 @@ void RefereeTableWidget::rebuildPlayerList(const TaggedPlayerList& pList, int se
   clearContents();
   setRowCount(0);
 
-  // grab the current database handle from the first entry
-  // in the player list
-  if (pList.empty())
+  // store the database handle for later player lookups
+  if (candList.empty())
   {
     setDatabase(nullptr);
     return;
   } else {
-    setDatabase(&(pList.at(0).first.getDatabaseHandle()));
+    setDatabase(&_db);
   }
 
   // disable sorting while we're modifying the table
   setSortingEnabled(false);
 
-  // populate the table rows
+  // populate the table rows; everything except
+  // the next match is already contained in the candidate
   PlayerMngr pm{*db};
-  setRowCount(pList.size());
+  setRowCount(candList.size());
   int idxRow = 0;
-  for (const TaggedPlayer& tp : pList)
+  for (const RefereeCandidate& cand : candList)
   {
-    const Player& p = tp.first;
+    const Player p{*db, cand.playerId};
 
     // add the player's name
-    QTableWidgetItem* newItem = new QTableWidgetItem(p.getDisplayName());
+    QTableWidgetItem* newItem = new QTableWidgetItem(cand.displayName);
     newItem->setData(Qt::UserRole, p.getId());
-    newItem->setData(Qt::UserRole + 1, tp.second);  // set the tag
+    newItem->setData(Qt::UserRole + 1, static_cast<int>(cand.tag));  // set the tag
     newItem->setFlags(Qt::ItemIsSelectable | Qt::ItemIsEnabled);
     setItem(idxRow, NameColId, newItem);
 
     // add the player's team
-    newItem = new QTableWidgetItem(p.getTeam().getName());
+    newItem = new QTableWidgetItem(cand.teamName);
     newItem->setData(Qt::UserRole, p.getId());
     newItem->setFlags(Qt::ItemIsSelectable | Qt::ItemIsEnabled);
     setItem(idxRow, TeamColId, newItem);
 
     // add the player's referee count
-    int refereeCount = p.getRefereeCount();
-    newItem = new QTableWidgetItem(QString::number(refereeCount));
+    newItem = new QTableWidgetItem(QString::number(cand.refereeCount));
     newItem->setData(Qt::UserRole, p.getId());
     newItem->setFlags(Qt::ItemIsSelectable | Qt::ItemIsEnabled);
     setItem(idxRow, RefereeCountColId, newItem);
 
     // add the time of the last finished match
-    auto ma = pm.getLastFinishedMatchForPlayer(p);
     QString txt = "--";
-    if (ma)
+    if (cand.lastFinishTime > 0)
     {
-      QDateTime finishTime = ma->getFinishTime();
-      txt = finishTime.toString("HH:mm");
+      txt = QDateTime::fromTime_t(cand.lastFinishTime).toString("HH:mm");
     }
     newItem = new QTableWidgetItem(txt);
     newItem->setData(Qt::UserRole, p.getId());
@@ -493,7 +404,7 @@ void RefereeTableWidget::rebuildPlayerList(const TaggedPlayerList& pList, int se
 
     // add the offset to the next match for the player
     txt = "--";
-    ma = pm.getNextMatchForPlayer(p);
+    auto ma = pm.getNextMatchForPlayer(p);
     if (ma)
     {
       int matchNumOffset = ma->getMatchNumber() - selectedMatchNumer;
@@ -26,6 +26,7 @@
 
 #include "TournamentDB.h"
 #include "Match.h"
+#include "RefereeAssigner.h"
 #include "delegates/RefereeSelectionDelegate.h"
 #include "AutoSizingTable.h"
 
@@ -33,9 +34,6 @@ namespace Ui {
   class DlgSelectReferee;
 }
 
-using TaggedPlayer = std::pair<QTournament::Player, int>;
-using TaggedPlayerList = QList<TaggedPlayer>;
-
 class DlgSelectReferee : public QDialog
 {
   Q_OBJECT
@@ -52,6 +50,7 @@ public slots:
   void onPlayerSelectionChanged();
   void onBtnSelectClicked();
   void onBtnNoneClicked();
+  void onBtnAutoClicked();
   void onPlayerDoubleClicked();
 
 private:
@@ -59,14 +58,13 @@ private:
   const QTournament::TournamentDB& db;
   const QTournament::Match& ma;
   QTournament::RefereeAction refAction;
+  QTournament::RefereeAssigner assigner;
   void updateControls();
 
   void initTeamList(int defaultTeamId = -1);
   void rebuildPlayerList();
   void resizeTabColumns();
 
-  TaggedPlayerList getPlayerList_recentFinishers();
-
   std::optional<QTournament::Player> finalPlayerSelection;
 };
 
@@ -86,7 +84,7 @@ public:
   RefereeTableWidget(QWidget* parent=0);
   virtual ~RefereeTableWidget() {}
 
-  void rebuildPlayerList(const TaggedPlayerList& pList, int selectedMatchNumer, QTournament::RefereeMode _refMode);
+  void rebuildPlayerList(const QTournament::TournamentDB& _db, const std::vector<QTournament::RefereeCandidate>& candList, int selectedMatchNumer, QTournament::RefereeMode _refMode);
   std::optional<QTournament::Player> getSelectedPlayer();
   bool hasPlayerSelected();
 
@@ -24,6 +24,9 @@
 #include <QFile>
 #include <QTime>
 #include <QPushButton>
+#include <QSettings>
+
+#include <sqlite3.h>
 
 #include "MainFrame.h"
 #include "MatchMngr.h"
@@ -42,6 +45,7 @@
 #include "commonCommands/cmdConnectionSettings.h"
 #include "HelperFunc.h"
 #include "BuiltinTestScenarios.h"
+#include "BackgroundBackup.h"
 
 using namespace QTournament;
 
@@ -91,6 +95,10 @@ MainFrame::MainFrame()
   connect(btnPingTest, SIGNAL(clicked(bool)), this, SLOT(onBtnPingTestClicked()));
   btnPingTest->setEnabled(false);
 
+  // restore the storage mode from the last session
+  QSettings appSettings{SettingsOrg, SettingsApp};
+  ui.actionKeepInMemory->setChecked(appSettings.value(SettingsKey_KeepInMemory, true).toBool());
+  connect(ui.actionKeepInMemory, SIGNAL(toggled(bool)), this, SLOT(onKeepInMemoryToggled(bool)));
 
   // finally disable all widgets by setting their database instance to nullptr
   distributeCurrentDatabasePointerToWidgets();
@@ -126,6 +134,14 @@ void MainFrame::newTournament()
     return;
   }
 
+  // if we work directly on the file, we need the file name right away
+  QString filename;
+  if (!(ui.actionKeepInMemory->isChecked()))
+  {
+    filename = askForTournamentFileName(tr("New tournament"));
+    if (filename.isEmpty()) return;
+  }
+
   // close any open tournament
   if (currentDb != nullptr)
   {
@@ -133,17 +149,49 @@ void MainFrame::newTournament()
     if (!isOkay) return;
   }
 
-  auto newDb = make_unique<TournamentDB>(":memory:", *settings);
+  std::unique_ptr<TournamentDB> newDb{nullptr};
+  if (filename.isEmpty())
+  {
+    newDb = make_unique<TournamentDB>(":memory:", *settings);
+  } else {
+    // the user has already confirmed to overwrite existing files;
+    // stale WAL files must not be replayed into the new database
+    for (const QString& suffix : {"", "-wal", "-shm"})
+    {
+      QFile::remove(filename + suffix);
+    }
+    newDb = make_unique<TournamentDB>(QString2StdString(filename), *settings);
+
+    // without WAL mode (e.g., on some network shares) we can't work
+    // directly on the file; in this case we continue with a copy in
+    // memory that is written to the file upon "save", exactly like
+    // an opened tournament with "keep in memory"
+    if (!(newDb->enableWalMode()))
+    {
+      try
+      {
+        newDb = make_unique<TournamentDB>();
+        newDb->restoreFromFile(QString2StdString(filename));
+      }
+      catch (std::invalid_argument&)
+      {
+        newDb.reset();
+      }
+      catch (SqliteOverlay::GenericSqliteException&)
+      {
+        newDb.reset();
+      }
+    }
+  }
   if (!newDb)
   {
-    // shouldn't happen, because the file has been
-    // deleted before (see above)
     QMessageBox::warning(this, tr("New tournament"), tr("Something went wrong; no new tournament created."));
     return;
   }
 
   // make the new database the current one
   currentDb = std::move(newDb);
+  currentDatabaseFileName = filename;
   distributeCurrentDatabasePointerToWidgets();
 
   // create the initial number of courts
@@ -239,32 +287,45 @@ void MainFrame::openTournament()
     if (!isOkay) return;
   }
 
-  // close the temporarily opened tournament database and
-  // re-open it as a copy in memory
-  try
+  // either keep working directly on the file or close the
+  // temporarily opened tournament database and re-open it
+  // as a copy in memory.
+  //
+  // Working directly on the file requires WAL mode; if the file
+  // system doesn't support it (e.g., some network shares) we
+  // fall back to the copy in memory
+  bool keepInMemory = ui.actionKeepInMemory->isChecked();
+  if (!keepInMemory && !(newDb->enableWalMode()))
   {
-    newDb = make_unique<TournamentDB>();
-    newDb->restoreFromFile(QString2StdString(filename));
+    keepInMemory = true;
   }
-  catch (std::invalid_argument&)
+  if (keepInMemory)
   {
-    QString msg;
-    msg = tr("Could not read from the source file:\n\n");
-    msg += filename + "\n\n";
-    msg += tr("The tournament has not been opened.");
+    try
+    {
+      newDb = make_unique<TournamentDB>();
+      newDb->restoreFromFile(QString2StdString(filename));
+    }
+    catch (std::invalid_argument&)
+    {
+      QString msg;
+      msg = tr("Could not read from the source file:\n\n");
+      msg += filename + "\n\n";
+      msg += tr("The tournament has not been opened.");
 
-    QMessageBox::warning(this, tr("Opening failed"), msg);
-    return;
-  }
-  catch (SqliteOverlay::GenericSqliteException& ex)
-  {
-    QString msg;
-    msg = tr("A database error occured while opening.\n\n");
-    msg += tr("Internal hint: SQLite error code = %1");
-    msg = msg.arg(static_cast<int>(ex.errCode()));
+      QMessageBox::warning(this, tr("Opening failed"), msg);
+      return;
+    }
+    catch (SqliteOverlay::GenericSqliteException& ex)
+    {
+      QString msg;
+      msg = tr("A database error occured while opening.\n\n");
+      msg += tr("Internal hint: SQLite error code = %1");
+      msg = msg.arg(static_cast<int>(ex.errCode()));
 
-    QMessageBox::warning(this, tr("Opening failed"), msg);
-    return;
+      QMessageBox::warning(this, tr("Opening failed"), msg);
+      return;
+    }
   }
 
   // opening was successfull ==> distribute the database handle to all widgets
@@ -428,10 +489,18 @@ void MainFrame::enableControls(bool doEnable)
 
 bool MainFrame::closeCurrentTournament()
 {
+  if (isSavingInBackground)
+  {
+    QString msg = tr("The tournament is currently being saved.\n\n");
+    msg += tr("Please try again when saving has finished.");
+    QMessageBox::information(this, tr("Close tournament"), msg);
+    return false;
+  }
+
   // close other possibly open tournaments
   if (currentDb != nullptr)
   {
-    if (currentDb->isDirty())
+    if (currentDb->isDirty() && !(currentDb->isWalMode()))
     {
       QString msg = tr("Warning: all unsaved changes to the current tournament\n");
       msg += tr("will be lost.\n\n");
@@ -468,7 +537,9 @@ bool MainFrame::closeCurrentTournament()
     // BEFORE we actually close the database
     distributeCurrentDatabasePointerToWidgets(true);
 
-    // close the database
+    // close the database; in WAL mode, merge all
+    // pending changes into the database file first
+    currentDb->checkpoint(true);
     currentDb->close();
     currentDb.reset();
     currentDatabaseFileName.clear();
@@ -516,46 +587,64 @@ bool MainFrame::saveCurrentDatabaseToFile(const QString& dstFileName, bool reset
 
   if (currentDb == nullptr) return false;
 
-  // write the database to the file
-  try
+  // the autosave timer may fire while we're
+  // still writing the previous copy
+  if (isSavingInBackground)
+  {
+    if (showErrorOnFailure)
+    {
+      QString msg = tr("The tournament is currently being saved to another file.\n\n");
+      msg += tr("Please try again when saving has finished.");
+      QMessageBox::warning(this, tr("Saving failed"), msg);
+    }
+    return false;
+  }
+
+  // write the database to the file in the background while
+  // the operators continue to work; changes made in the
+  // meantime are included in the copy
+  isSavingInBackground = true;
+  const QString progressMsg = tr("Saving to %1 ... %2 %");
+  int changeCountAtCompletion{-1};
+  int rc = backupInBackground(*currentDb, QString2StdString(dstFileName), [&](int done, int total)
   {
-    bool isOkay = currentDb->backupToFile(QString2StdString(dstFileName));
+    const int percent = (total > 0) ? (100 * done / total) : 0;
+    statusBar()->showMessage(progressMsg.arg(dstFileName).arg(percent));
+  }, &changeCountAtCompletion);
+  statusBar()->clearMessage();
+  isSavingInBackground = false;
 
-    if (isOkay && resetDirtyFlagOnSuccess)
+  if (rc == SQLITE_OK)
+  {
+    // changes that have been entered after the last page has been
+    // copied (e.g., while the file was renamed) are not part of the
+    // copy; in this case the database has to remain dirty
+    if (resetDirtyFlagOnSuccess && (currentDb->getTotalChangeCount() == changeCountAtCompletion))
     {
       currentDb->resetDirtyFlag();
       currentDb->resetLocalChangeCounter();
     }
 
-    return isOkay;
+    return true;
   }
-  catch (SqliteOverlay::BusyException&)
+
+  if (showErrorOnFailure)
   {
-    if (showErrorOnFailure)
+    QString msg;
+    if ((rc == SQLITE_BUSY) || (rc == SQLITE_LOCKED))
     {
-      QString msg;
       msg = tr("Could not write to %1 because the file is locked by some other application.\n\n");
       msg += tr("The tournament has not been saved.");
       msg = msg.arg(dstFileName);
-
-      QMessageBox::warning(this, tr("Saving failed"), msg);
-    }
-    return false;
-  }
-  catch (SqliteOverlay::GenericSqliteException& ex)
-  {
-    if (showErrorOnFailure)
-    {
-      QString msg;
-
+    } else {
       msg = tr("A database error occured while saving.\n\n");
       msg += tr("Internal hint: SQLite error code = %1");
-      msg = msg.arg(static_cast<int>(ex.errCode()));
-
-      QMessageBox::warning(this, tr("Saving failed"), msg);
+      msg = msg.arg(rc);
     }
-    return false;
+
+    QMessageBox::warning(this, tr("Saving failed"), msg);
   }
+  return false;
 }
 
 //----------------------------------------------------------------------------
@@ -569,6 +658,21 @@ bool MainFrame::execCmdSave()
     return execCmdSaveAs();
   }
 
+  // if we're working directly on the file, all changes are already
+  // stored; "saving" only merges the WAL into the database file
+  if (currentDb->isWalMode())
+  {
+    bool isOkay = currentDb->checkpoint();
+    if (isOkay)
+    {
+      currentDb->resetDirtyFlag();
+      currentDb->resetLocalChangeCounter();
+    }
+    onAutosaveTimerElapsed();
+
+    return isOkay;
+  }
+
   bool isOkay = saveCurrentDatabaseToFile(currentDatabaseFileName, true, true);
   if (isOkay)
   {
@@ -587,8 +691,20 @@ bool MainFrame::execCmdSaveAs()
   QString dstFileName = askForTournamentFileName(tr("Save tournament as"));
   if (dstFileName.isEmpty()) return false;  // user abort counts as "failed"
 
+  // we can't copy a file onto itself
+  if (currentDb->isWalMode() && (dstFileName == currentDatabaseFileName))
+  {
+    return execCmdSave();
+  }
+
   bool isOkay = saveCurrentDatabaseToFile(dstFileName, true, true);
 
+  // if we're working directly on the file, continue with the new file
+  if (isOkay && currentDb->isWalMode())
+  {
+    isOkay = switchToDatabaseFile(dstFileName);
+  }
+
   if (isOkay)
   {
     currentDatabaseFileName = dstFileName;
@@ -605,6 +721,47 @@ bool MainFrame::execCmdSaveAs()
 
 //----------------------------------------------------------------------------
 
+bool MainFrame::switchToDatabaseFile(const QString& fName)
+{
+  if (currentDb == nullptr) return false;
+
+  std::unique_ptr<TournamentDB> newDb{nullptr};
+  try
+  {
+    newDb = make_unique<TournamentDB>(QString2StdString(fName));
+  }
+  catch (TournamentException&)
+  {
+    return false;
+  }
+  catch (std::invalid_argument&)
+  {
+    return false;
+  }
+  if (!(newDb->enableWalMode())) return false;
+
+  // shut down the old database, see closeCurrentTournament()
+  PlayerMngr pm{*currentDb};
+  pm.closeExternalPlayerDatabase();
+  distributeCurrentDatabasePointerToWidgets(true);
+  currentDb->checkpoint(true);
+  currentDb->close();
+
+  currentDb = std::move(newDb);
+  distributeCurrentDatabasePointerToWidgets();
+  currentDb->getOnlineManager()->applyCustomServerSettings();
+
+  PlayerMngr newPm{*currentDb};
+  if (newPm.hasExternalPlayerDatabaseConfigured())
+  {
+    newPm.openConfiguredExternalPlayerDatabase();
+  }
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+
 QString MainFrame::askForTournamentFileName(const QString& dlgTitle)
 {
   // ask for the file name
@@ -645,7 +802,7 @@ void MainFrame::updateWindowTitle()
 
     // append an asterisk to the windows title if the
     // database has changed since the last saving
-    if (currentDb->isDirty()) title += " *";
+    if (currentDb->isDirty() && !(currentDb->isWalMode())) title += " *";
   }
 
   setWindowTitle(title);
@@ -698,7 +855,7 @@ void MainFrame::setupTestScenario(int scenarioID)
   }
 
   // shutdown whatever is open right now
-  closeCurrentTournament();
+  if (!closeCurrentTournament()) return;
 
   QString testFileName = QDir().absoluteFilePath("tournamentTestFile.tdb");
 
@@ -1135,15 +1292,23 @@ void MainFrame::onAutosaveTimerElapsed()
   }
 
   // do we need an autosave?
+  //
+  // if we're working directly on the file, a checkpoint
+  // is sufficient instead of a full copy
   if (currentDb->getLocalChangeCounter_total() > lastAutosaveDirtyCounterValue)
   {
+    // changes that are made while the copy is being written may or
+    // may not end up in the copy; so we only take credit for the
+    // changes that existed before we started
+    const auto counterBeforeSave = currentDb->getLocalChangeCounter_total();
+
     QString fname = currentDatabaseFileName + ".autosave";
-    bool isOkay = saveCurrentDatabaseToFile(fname, false, false);
+    bool isOkay = currentDb->isWalMode() ? currentDb->checkpoint() : saveCurrentDatabaseToFile(fname, false, false);
 
     if (isOkay)
     {
       msg += QTime::currentTime().toString("HH:mm:ss");
-      lastAutosaveDirtyCounterValue = currentDb->getLocalChangeCounter_total();
+      lastAutosaveDirtyCounterValue = counterBeforeSave;
     } else {
       msg += tr("failed");
     }
@@ -1190,7 +1355,7 @@ void MainFrame::onServerSyncTimerElapsed()
   QString msg = tr("<span style='color: green; font-weight: bold;'>Online</span>");
   msg += tr(", %1 syncs committed, %2 changes pending");
   msg = msg.arg(st.partialSyncCounter);
-  msg = msg.arg(currentDb->getChangeLogLength());
+  msg = msg.arg(om->getPendingChangeCount());
 
   // attach the last request time, if available
   int dt = om->getLastReqTime_ms();
@@ -1290,6 +1455,14 @@ void MainFrame::onBtnPingTestClicked()
 
 //----------------------------------------------------------------------------
 
+void MainFrame::onKeepInMemoryToggled(bool isChecked)
+{
+  QSettings appSettings{SettingsOrg, SettingsApp};
+  appSettings.setValue(SettingsKey_KeepInMemory, isChecked);
+}
+
+//----------------------------------------------------------------------------
+
 
 //----------------------------------------------------------------------------
 
@@ -65,6 +65,17 @@ private:
   QLabel* syncStatLabel;
   QPushButton* btnPingTest;
 
+  // the persistent application settings; working on a copy
+  // in memory is the default because WAL mode permanently
+  // modifies the file and leaves extra files next to it
+  static constexpr char SettingsOrg[] = "QTournament";
+  static constexpr char SettingsApp[] = "QTournament";
+  static constexpr char SettingsKey_KeepInMemory[] = "KeepTournamentsInMemory";
+
+  // set while a copy of the database is written in the
+  // background; the tournament must not be closed meanwhile
+  bool isSavingInBackground{false};
+
   void enableControls(bool doEnable = true);
   void setupTestScenario(int scenarioID);
   
@@ -76,6 +87,9 @@ private:
   /** \brief Writes the contents of the current (in-memory) database to
    * a file on disk. The active database remains the same.
    *
+   * The file is written in the background while the GUI remains
+   * responsive; the progress is shown in the status bar.
+   *
    * Optionally, the internal dirty flags will be reset upon successful
    * completion of the write operation.
    *
@@ -98,6 +112,13 @@ private:
 
   bool execCmdSave();
   bool execCmdSaveAs();
+
+  /** \brief Replaces the current database with a direct (WAL mode)
+   * connection to another tournament file, e.g. after "Save as"
+   *
+   * \returns `true` if the file could be opened
+   */
+  bool switchToDatabaseFile(const QString& fName);
   QString askForTournamentFileName(const QString& dlgTitle);
 
   void updateWindowTitle();
@@ -140,6 +161,7 @@ private slots:
   void onAutosaveTimerElapsed();
   void onServerSyncTimerElapsed();
   void onBtnPingTestClicked();
+  void onKeepInMemoryToggled(bool isChecked);
 
 };
 
@@ -19,7 +19,6 @@
 #include <QHeaderView>
 #include <QResizeEvent>
 #include <QScrollBar>
-#include <QTableWidgetItem>
 #include <QMessageBox>
 
 #include "MatchLogTable.h"
@@ -30,27 +29,32 @@
 using namespace QTournament;
 
 MatchLogTable::MatchLogTable(QWidget* parent)
-  :CommonMatchTableWidget{parent}
+  :GuiHelpers::AutoSizingTableView_WithDatabase<MatchLogTableModel>{GuiHelpers::AutosizeColumnDescrList{
+// the column labels are provided by the model
+{"", RelNumericColWidth, -1, MaxNumericColWidth},
+{"", RelNumericColWidth, -1, MaxNumericColWidth},
+{"", RelNumericColWidth, -1, MaxNumericColWidth},
+{"", RelNumericColWidth, -1, MaxNumericColWidth},
+{"", RelMatchInfoColWidth, -1, -1},
+{"", RelNumericColWidth, -1, MaxNumericColWidth},
+{"", RelNumericColWidth, -1, MaxNumericColWidth},
+{"", RelNumericColWidth, -1, MaxNumericColWidth},
+{"", RelNumericColWidth, -1, MaxNumericColWidth},
+{"", RelUmpireColWidth, -1, -1}
+     }, false, parent}
 {
-  CentralSignalEmitter* cse = CentralSignalEmitter::getInstance();
+  setRubberBandCol(MatchLogTableModel::IdxMatchInfoCol);
 
-  QObject::connect(
-        cse,
-        SIGNAL(matchStatusChanged(int,int,ObjState,ObjState)),
-        this, SLOT(onMatchStatusChanged(int,int,ObjState,ObjState)),
-        Qt::DirectConnection
-        );
+  // all rows have the same height; this saves us from
+  // measuring every row that is fetched from the model
+  verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+  verticalHeader()->setDefaultSectionSize(MatchLogItemDelegate::ItemRowHeight);
 
   // handle context menu requests
   setContextMenuPolicy(Qt::CustomContextMenu);
   connect(this, SIGNAL(customContextMenuRequested(const QPoint&)),
           this, SLOT(onContextMenuRequested(const QPoint&)));
 
-  // if a (running) category is deleted, we need to rebuild the widget's
-  // contents, otherwise the deleted matches cause blank rows
-  connect(CentralSignalEmitter::getInstance(), SIGNAL(categoryRemovedFromTournament(int,int)),
-          this, SLOT(onCategoryRemoved()));
-
   // prep the context menu
   initContextMenu();
 }
@@ -59,9 +63,10 @@ MatchLogTable::MatchLogTable(QWidget* parent)
 
 std::optional<Match> MatchLogTable::getSelectedMatch() const
 {
-  if ((currentRow() < 0) || (currentItem() == nullptr)) return {};
+  if (!hasCustomDataModel()) return {};
 
-  int maId = currentItem()->data(Qt::UserRole).toInt();
+  int maId = customDataModel->getMatchId(getSelectedSourceRow());
+  if (maId < 0) return {};
 
   MatchMngr mm{*db};
   return mm.getMatch(maId);
@@ -69,28 +74,6 @@ std::optional<Match> MatchLogTable::getSelectedMatch() const
 
 //----------------------------------------------------------------------------
 
-void MatchLogTable::onMatchStatusChanged(int maId, int maSeqNum, ObjState oldStat, ObjState newStat)
-{
-  if (newStat != ObjState::MA_Finished) return;
-  if (db == nullptr) return;
-
-  MatchMngr mm{*db};
-  auto ma = mm.getMatch(maId);
-  if (ma) insertMatch(0, *ma);
-  resizeRowToContents(0);
-}
-
-//----------------------------------------------------------------------------
-
-void MatchLogTable::onCategoryRemoved()
-{
-  clearContents();
-  setRowCount(0);
-  fillFromDatabase();
-}
-
-//----------------------------------------------------------------------------
-
 void MatchLogTable::onModMatchResultTriggered()
 {
   auto ma = getSelectedMatch();
@@ -204,31 +187,12 @@ void MatchLogTable::onContextMenuRequested(const QPoint& pos)
 
 void MatchLogTable::hook_onDatabaseOpened()
 {
-  // call parent
-  CommonMatchTableWidget::hook_onDatabaseOpened();
-
-  fillFromDatabase();
-}
-
-//----------------------------------------------------------------------------
-
-void MatchLogTable::fillFromDatabase()
-{
-  if (db == nullptr) return;
-
-  MatchMngr mm{*db};
-  MatchList ml = mm.getFinishedMatches();
+  // call parent; this creates the model
+  // and loads the first rows
+  AutoSizingTableView_WithDatabase::hook_onDatabaseOpened();
 
-  // sort matches by finish time, earliest finisher first
-  std::sort(ml.begin(), ml.end(), [](const Match& ma1, const Match& ma2) {
-    return ma1.getFinishTime() < ma2.getFinishTime();
-  });
-
-  // add them in reverse order: each match is inserted BEFORE the previous one
-  for (const Match& ma : ml)
-  {
-    insertMatch(0, ma);
-  }
+  // set a new delegate
+  setCustomDelegate(new MatchLogItemDelegate(db, this));   // Takes ownership
 }
 
 //----------------------------------------------------------------------------
@@ -19,7 +19,7 @@
 #ifndef MATCHLOGTABLE_H
 #define MATCHLOGTABLE_H
 
-#include <QTableWidget>
+#include <QTableView>
 #include <QAbstractItemDelegate>
 #include <QMenu>
 #include <QAction>
@@ -27,13 +27,19 @@
 #include "TournamentDB.h"
 #include "Match.h"
 #include "delegates/MatchLogItemDelegate.h"
-#include "CommonMatchTableWidget.h"
+#include "models/MatchLogTableModel.h"
+#include "AutoSizingTable.h"
 
 #include "CustomMetatypes.h"
 
 using namespace QTournament;
 
-class MatchLogTable : public CommonMatchTableWidget
+/** \brief The log of all finished matches
+ *
+ * The rows are provided by a MatchLogTableModel that only loads
+ * those matches that are actually scrolled into view.
+ */
+class MatchLogTable : public GuiHelpers::AutoSizingTableView_WithDatabase<QTournament::MatchLogTableModel>
 {
   Q_OBJECT
 
@@ -42,18 +48,17 @@ public:
   std::optional<QTournament::Match> getSelectedMatch() const;
   virtual ~MatchLogTable() override {}
 
-public slots:
-  void onMatchStatusChanged(int maId, int maSeqNum, ObjState oldStat, ObjState newStat);
-  void onCategoryRemoved();
-
 protected slots:
   void onModMatchResultTriggered();
   void onContextMenuRequested(const QPoint& pos);
 
 protected:
-  virtual void hook_onDatabaseOpened() override;
+  static constexpr int MaxNumericColWidth = 90;
+  static constexpr int RelNumericColWidth = 1;
+  static constexpr int RelMatchInfoColWidth = 10;
+  static constexpr int RelUmpireColWidth = 2;
 
-  void fillFromDatabase();
+  virtual void hook_onDatabaseOpened() override;
 
   std::unique_ptr<QMenu> contextMenu;
   QAction* actModMatchResult;
@@ -17,6 +17,9 @@
  */
 
 #include <QMessageBox>
+#include <QDateTime>
+
+#include <SimpleReportGeneratorLib/SimpleReportViewer.h>
 
 #include "ScheduleTabWidget.h"
 #include "ui_ScheduleTabWidget.h"
@@ -29,7 +32,9 @@
 #include "CatMngr.h"
 #include "CourtMngr.h"
 #include "Procedures.h"
+#include "SchedulePlanner.h"
 #include "../BackendAPI.h"
+#include "reports/ResultSheets.h"
 
 using namespace QTournament;
 
@@ -214,6 +219,95 @@ void ScheduleTabWidget::onBtnHideStagingAreaClicked()
 
 //----------------------------------------------------------------------------
 
+void ScheduleTabWidget::onBtnCallOnFreeCourtsClicked()
+{
+  MatchMngr mm{*db};
+  const CalledMatchList called = mm.callMatchesOnFreeCourts(false, true);
+  if (called.empty())
+  {
+    QString msg = tr("No match could be called. Either there are no free courts or there are no callable matches.\n\n");
+    msg += tr("Matches without a suitable umpire have to be called individually.");
+    QMessageBox::information(this, tr("Call matches"), msg);
+    return;
+  }
+
+  // tell the user which matches have been called where
+  QString msg = tr("The following matches have been called:\n\n");
+  MatchList ml;
+  for (const CalledMatch& cm : called)
+  {
+    msg += tr("Match %1 on court %2").arg(cm.ma.getMatchNumber()).arg(cm.co.getNumber());
+    auto referee = cm.ma.getAssignedReferee();
+    if (referee)
+    {
+      msg += tr(", umpire: %1").arg(referee->getDisplayName_FirstNameFirst());
+    }
+    msg += "\n";
+    ml.push_back(cm.ma);
+  }
+  msg += tr("\nPrint the result sheets for all these matches now?");
+  int rc = QMessageBox::question(this, tr("Call matches"), msg);
+  if (rc != QMessageBox::Yes) return;
+
+  // print all result sheets in one go
+  ResultSheets rep{*db, ml};
+  upSimpleReport sr = rep.regenerateReport();
+  SimpleReportLib::SimpleReportViewer viewer{this};
+  viewer.setReport(sr.get());
+  viewer.onBtnPrintClicked();
+}
+
+//----------------------------------------------------------------------------
+
+void ScheduleTabWidget::onBtnOptimizeOrderClicked()
+{
+  SchedulePlanner planner{*db};
+  const SchedulePlan plan = planner.createPlan();
+  if (!plan.isImprovement())
+  {
+    QString msg = tr("The current order of the scheduled and staged matches can't be improved.");
+    QMessageBox::information(this, tr("Optimize match order"), msg);
+    return;
+  }
+
+  // compare the predicted outcome of both orders
+  auto endTimeToString = [](time_t t) { return QDateTime::fromTime_t(t).toString("hh:mm"); };
+  QString msg = tr("A better order for the scheduled and staged matches has been found:\n\n");
+  msg += tr("Predicted end of the last match: %1 instead of %2\n").arg(endTimeToString(plan.proposed.endTime)).arg(endTimeToString(plan.current.endTime));
+  msg += tr("Matches without a break for a player: %1 instead of %2\n").arg(plan.proposed.nBackToBack).arg(plan.current.nBackToBack);
+  if (plan.includesStagedGroups)
+  {
+    msg += tr("\nAll staged match groups will be scheduled.");
+  }
+  msg += tr("\nApply the new order now?");
+
+  // the new order as detailed text
+  MatchMngr mm{*db};
+  QString details;
+  for (int maId : plan.proposedOrder)
+  {
+    auto ma = mm.getMatch(maId);
+    if (!ma) continue;
+    details += ma->getCategory().getName() + ": " + ma->getDisplayName(tr("Winner"), tr("Loser")) + "\n";
+  }
+
+  QMessageBox box{QMessageBox::Question, tr("Optimize match order"), msg, QMessageBox::Yes | QMessageBox::No, this};
+  box.setDetailedText(details);
+  if (box.exec() != QMessageBox::Yes) return;
+
+  Error e = planner.applyPlan(plan);
+  if (e == Error::WrongState)
+  {
+    QMessageBox::warning(this, tr("Optimize match order"), tr("The matches have changed in the meantime. Please try again."));
+  }
+  else if (e != Error::OK)
+  {
+    QMessageBox::warning(this, tr("Optimize match order"), tr("The new order could not be applied."));
+  }
+}
+
+//----------------------------------------------------------------------------
+
 void ScheduleTabWidget::askAndStoreMatchResult(const Match &ma)
 {
   // only accept results for running matches
@@ -56,6 +56,8 @@ public slots:
   void onStagedSelectionChanged(const QItemSelection &, const QItemSelection &);
   void onCourtDoubleClicked(const QModelIndex& index);
   void onBtnHideStagingAreaClicked();
+  void onBtnCallOnFreeCourtsClicked();
+  void onBtnOptimizeOrderClicked();
 
 private:
   const QTournament::TournamentDB* db{nullptr};